@@ -188,6 +188,7 @@
 // #include <ctype.h>
 
 #include "../../common/_common.h"
+#include "../../pitchtrack/src/pyinlib.h"
 // #include "../../common/window.h"
 
 
@@ -1649,6 +1650,167 @@ INSDS *find_instance_exact(INSTRTXT *instrdef, MYFLT instrnum, int must_be_activ
 }
 
 
+/*
+ * Index of the running instances by their exact p1 (fractional part included),
+ * shared by pread and pwrite
+ *
+ * Plugins are not notified when a note starts or ends, so the index is filled
+ * lazily: a lookup which misses walks the instance list of the instrument
+ * once and adds every active instance with a fractional p1. Entries are never
+ * removed, a hit counts only if the instance is still active and has the same
+ * p1 (csound reuses the INSDS of a finished note for a new one). Stale entries
+ * are overwritten and dropped when the table is rehashed.
+ *
+ * A miss is remembered per instrument until the time advances or a new
+ * instance is activated, so opcodes retrying every cycle for a missing
+ * instance do not walk the instance list again
+ */
+
+typedef struct {
+    MYFLT p1;
+    INSDS *instance;    // NULL if the slot is empty
+} INSTANCE_SLOT;
+
+typedef struct {
+    int64_t time;       // time in samples of the last lookup which missed
+    int active;         // number of active instances at that time
+} INSTANCE_MISS;
+
+typedef struct {
+    INSTANCE_SLOT *slots;   // open addressing, linear probing
+    uint32_t size;          // always a power of two
+    uint32_t used;          // occupied slots, including stale entries
+    INSTANCE_MISS *misses;  // indexed by instr. number
+    int nummisses;
+} INSTANCE_INDEX;
+
+#define INSTANCE_INDEX_VARNAME "__instance_index__"
+#define INSTANCE_INDEX_INITSIZE 256
+
+static inline int32_t instance_alive(INSDS *instance, MYFLT p1) {
+    return instance->actflg && instance->p1.value == p1;
+}
+
+static inline uint32_t instance_index_hash(MYFLT p1) {
+    double x = (double)p1;
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(uint64_t));
+    return (uint32_t)((bits * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+static int32_t instance_index_reset(CSOUND *csound, INSTANCE_INDEX *ix) {
+    csound->Free(csound, ix->slots);
+    if(ix->misses != NULL)
+        csound->Free(csound, ix->misses);
+    csound->DestroyGlobalVariable(csound, INSTANCE_INDEX_VARNAME);
+    return OK;
+}
+
+static INSTANCE_INDEX *instance_index(CSOUND *csound) {
+    INSTANCE_INDEX *ix = csound->QueryGlobalVariable(csound, INSTANCE_INDEX_VARNAME);
+    if(ix != NULL) return ix;
+    if(csound->CreateGlobalVariable(csound, INSTANCE_INDEX_VARNAME, sizeof(INSTANCE_INDEX)) != 0)
+        return NULL;
+    ix = csound->QueryGlobalVariable(csound, INSTANCE_INDEX_VARNAME);
+    ix->size = INSTANCE_INDEX_INITSIZE;
+    ix->used = 0;
+    ix->slots = csound->Calloc(csound, sizeof(INSTANCE_SLOT) * ix->size);
+    ix->misses = NULL;
+    ix->nummisses = 0;
+    csound->RegisterResetCallback(csound, (void *)ix, (int32_t(*)(CSOUND*, void*))instance_index_reset);
+    return ix;
+}
+
+static inline INSTANCE_SLOT *instance_index_slot(INSTANCE_INDEX *ix, MYFLT p1) {
+    // returns the slot for p1, or the empty slot where it would be inserted
+    uint32_t mask = ix->size - 1;
+    uint32_t i = instance_index_hash(p1) & mask;
+    while(ix->slots[i].instance != NULL && ix->slots[i].p1 != p1)
+        i = (i + 1) & mask;
+    return &(ix->slots[i]);
+}
+
+static void instance_index_rehash(CSOUND *csound, INSTANCE_INDEX *ix) {
+    INSTANCE_SLOT *oldslots = ix->slots;
+    uint32_t oldsize = ix->size;
+    uint32_t live = 0;
+    for(uint32_t i = 0; i < oldsize; i++) {
+        if(oldslots[i].instance != NULL && instance_alive(oldslots[i].instance, oldslots[i].p1))
+            live++;
+    }
+    // only live entries are kept, grow if they would fill more than a quarter
+    uint32_t size = oldsize;
+    while(live * 4 > size)
+        size *= 2;
+    ix->slots = csound->Calloc(csound, sizeof(INSTANCE_SLOT) * size);
+    ix->size = size;
+    ix->used = live;
+    for(uint32_t i = 0; i < oldsize; i++) {
+        INSTANCE_SLOT *old = &(oldslots[i]);
+        if(old->instance != NULL && instance_alive(old->instance, old->p1))
+            *instance_index_slot(ix, old->p1) = *old;
+    }
+    csound->Free(csound, oldslots);
+}
+
+static void instance_index_add(CSOUND *csound, INSTANCE_INDEX *ix, INSDS *instance) {
+    MYFLT p1 = instance->p1.value;
+    if((ix->used + 1) * 2 > ix->size)
+        instance_index_rehash(csound, ix);
+    INSTANCE_SLOT *slot = instance_index_slot(ix, p1);
+    if(slot->instance == NULL) {
+        slot->p1 = p1;
+        slot->instance = instance;
+        ix->used++;
+    } else if(!instance_alive(slot->instance, p1)) {
+        slot->instance = instance;
+    }
+}
+
+/**
+ * Find the active instance with the exact (fractional) instr. number p1
+ *
+ * Same as find_instance_exact(instrdef, p1, 1), via the instance index
+ */
+INSDS *find_instance_indexed(CSOUND *csound, INSTRTXT *instrdef, MYFLT p1) {
+    INSTANCE_INDEX *ix = instance_index(csound);
+    if(ix == NULL)
+        return find_instance_exact(instrdef, p1, 1);
+    INSTANCE_SLOT *slot = instance_index_slot(ix, p1);
+    if(slot->instance != NULL && instance_alive(slot->instance, p1))
+        return slot->instance;
+
+    int insno = (int)p1;
+    if(insno >= ix->nummisses) {
+        int nummisses = insno + 1 > ix->nummisses * 2 ? insno + 1 : ix->nummisses * 2;
+        INSTANCE_MISS *misses = csound->Calloc(csound, sizeof(INSTANCE_MISS) * nummisses);
+        for(int i = 0; i < nummisses; i++)
+            misses[i].time = -1;
+        if(ix->misses != NULL) {
+            memcpy(misses, ix->misses, sizeof(INSTANCE_MISS) * ix->nummisses);
+            csound->Free(csound, ix->misses);
+        }
+        ix->misses = misses;
+        ix->nummisses = nummisses;
+    }
+    INSTANCE_MISS *miss = &(ix->misses[insno]);
+    int64_t now = csound->GetCurrentTimeSamples(csound);
+    if(miss->time == now && miss->active == instrdef->active)
+        return NULL;
+
+    for(INSDS *instance = instrdef->instance; instance != NULL; instance = instance->nxtinstance) {
+        if(instance->actflg && instance->p1.value != floor(instance->p1.value))
+            instance_index_add(csound, ix, instance);
+    }
+    slot = instance_index_slot(ix, p1);
+    if(slot->instance != NULL && instance_alive(slot->instance, p1))
+        return slot->instance;
+    miss->time = now;
+    miss->active = instrdef->active;
+    return NULL;
+}
+
+
 /**
  * pread
  *
@@ -1704,7 +1866,7 @@ int32_t pread_search_(CSOUND *csound, MYFLT p1, INSTRTXT **instrtxt, INSDS **ins
     INSDS *instr_;
     if(p1 != floor(p1)) {
         // fractional instrnum
-        instr_ = find_instance_exact(instrtxt_, p1, 1);
+        instr_ = find_instance_indexed(csound, instrtxt_, p1);
     } else {
         // find first instance of this instr
         instr_ = instrtxt_->instance;
@@ -1721,6 +1883,12 @@ int32_t pread_search_(CSOUND *csound, MYFLT p1, INSTRTXT **instrtxt, INSDS **ins
     return 1;
 }
 
+// Is the instance found by pread still the one requested? With an integer p1
+// any active instance of the instr. will do
+static inline int32_t pread_target_alive(INSDS *instr, MYFLT p1) {
+    return instr->actflg && (p1 == floor(p1) || instr->p1.value == p1);
+}
+
 int32_t pread_search(CSOUND *csound, PREAD *p) {
     int found = pread_search_(csound, *p->instrnum, &(p->instrtxt), &(p->instr));
     p->found = found;
@@ -1781,14 +1949,22 @@ preadarr_init(CSOUND *csound, PREADARR *p) {
 static int32_t
 pread_perf(CSOUND *csound, PREAD *p) {
     int idx = (int)*p->pindex;
+    if(p->found == 1 && !pread_target_alive(p->instr, *p->instrnum)) {
+        // the instance ended, its INSDS might be in use by another note by now
+        if(!p->retry)
+            return OK;
+        p->found = 0;
+    }
     if(p->found == -1 || (p->found==0 && p->retry)) {
+        int firstsearch = p->found == -1;
         int found = pread_search(csound, p);
         if (!found) {
-            printf("pread_perf: instr %f not found\n", *p->instrnum);
+            if(firstsearch)
+                printf("pread_perf: instr %f not found\n", *p->instrnum);
             return OK;
         }
     }
-    if(!p->instr->actflg) {
+    if(p->found != 1) {
         return OK;
     }
     if(idx > p->maxpfield) {
@@ -1805,10 +1981,18 @@ preadarr_perf(CSOUND *csound, PREADARR *p) {
     int numindexes = p->pindexes->sizes[0];
     tabcheck(csound, p->outvals, numindexes, &(p->h));
 
+    if(p->found == 1 && !pread_target_alive(p->instr, *p->instrnum)) {
+        // the instance ended, its INSDS might be in use by another note by now
+        if(!p->retry)
+            return OK;
+        p->found = 0;
+    }
     if(p->found == -1 || (p->found==0 && p->retry)) {
+        int firstsearch = p->found == -1;
         p->found = pread_search_(csound, *p->instrnum, &(p->instrtxt), &(p->instr));
         if (!p->found) {
-            printf("pread_perf: instr %f not found\n", *p->instrnum);
+            if(firstsearch)
+                printf("pread_perf: instr %f not found\n", *p->instrnum);
             for(int i=0; i<numindexes; i++) {
                 p->outvals->data[i] = *p->inotfound;
             }
@@ -1817,7 +2001,7 @@ preadarr_perf(CSOUND *csound, PREADARR *p) {
         p->maxpfield = p->instrtxt->pmax;
         p->pfields = &(p->instr->p0);
     }
-    if(!p->instr->actflg) {
+    if(p->found != 1) {
         return OK;
     }
 
@@ -1920,7 +2104,7 @@ pwrite_search(CSOUND *csound, PWRITE *p) {
     }
     // if we are not broadcasting, search the exact match
     if (!(p->broadcasting)) {
-        INSDS *instr = find_instance_exact(p->instrtxt, p1, 1);
+        INSDS *instr = find_instance_indexed(csound, p->instrtxt, p1);
         if(!instr) {
             return 0;
         }
@@ -1974,7 +2158,7 @@ pwrite_perf(CSOUND *csound, PWRITE *p) {
     }
 
     if (!p->broadcasting) {
-        if(p->instr->actflg && p->p1 == p->instr->p1.value) {
+        if(instance_alive(p->instr, p->p1)) {
             pwrite_writevalues(csound, p, p->pfields);
         } else {
             // the instr is not active anymore
@@ -2008,6 +2192,7 @@ pwriten_init(CSOUND *csound, PWRITE *p) {
     p->numpairs = (_GetInputArgCnt(csound, p) - 1) / 2;
     p->status = FirstRun;
     p->instrtxt = NULL;
+    p->instr = NULL;
     p->maxpfield = 0;
     return OK;
 }
@@ -2015,10 +2200,22 @@ pwriten_init(CSOUND *csound, PWRITE *p) {
 static int32_t
 pwriten_perf(CSOUND *csound, PWRITE *p) {
     INSDS *instance = (INSDS *) ((uintptr_t)*p->instrnum);
-    p->maxpfield = instance->instr->pmax;
-    if (instance->actflg) {
-        pwrite_writevalues(csound, p, &(instance->p0));
+    if(instance != p->instr) {
+        // a new instance id, remember the p1 of the note it refers to
+        p->instr = instance;
+        p->p1 = instance->p1.value;
+        p->maxpfield = instance->instr->pmax;
+        p->status = instance->actflg ? InstanceFound : NoOp;
+    }
+    if(p->status != InstanceFound)
+        return OK;
+    if(!instance_alive(instance, p->p1)) {
+        // the note ended. The INSDS might be reused later by another note,
+        // which should not be modified via this id
+        p->status = NoOp;
+        return OK;
     }
+    pwrite_writevalues(csound, p, &(instance->p0));
     return OK;
 }
 
@@ -2029,76 +2226,260 @@ pwriten_perf(CSOUND *csound, PWRITE *p) {
  * which is not active now and can be used as p1 for "event" or similar
  * opcodes to create a unique instance of an instrument
  *
- * instrnum  uniqinstrance integer_instrnum
+ * instrnum  uniqinstrance integer_instrnum [, imaxinstances=10000, ipending=1]
+ *
+ * Fractional numbers are handed out round robin from a per-engine bitmap of
+ * occupied numbers for each instrument (and number of slots), so finding a
+ * free number is a ctz on a word. The bitmap is only rebuilt from the running
+ * instances when it is full (a refresh): this walk is amortized over the
+ * numbers freed by it.
+ *
+ * A plugin is not notified when a note starts or ends. A number handed out
+ * is kept as pending, by its exact p1, until an instance with that p1 is seen
+ * running at a refresh or until ipending seconds have passed, so that an event
+ * which has not started yet keeps its number across refreshes. Pending numbers
+ * are shared by the bitmaps of all numbers of slots of an instrument, so calls
+ * with a different imaxinstances never hand out the same p1
  *
  */
 
 #define UNIQ_NUMSLOTS 10000
+#define UNIQ_PENDING_SECONDS 1
+#define UNIQ_PENDING_INITSIZE 64
+
+typedef struct UNIQ_ALLOC_ {
+    int numslots;       // p1 + i/numslots, for 0 < i < numslots
+    int numwords;
+    int next;           // next slot to try
+    uint64_t *reserved; // a set bit indicates that the slot is taken
+    struct UNIQ_ALLOC_ *nextalloc;  // allocator for the same instr. with a different numslots
+} UNIQ_ALLOC;
+
+typedef struct {
+    MYFLT p1;
+    int64_t deadline;   // in samples, 0 if the slot is empty
+} UNIQ_PENDING;
+
+typedef struct {
+    UNIQ_ALLOC *allocs;
+    UNIQ_PENDING *pending;  // open addressing, linear probing, keyed by p1
+    uint32_t size;          // always a power of two, 0 if not allocated yet
+    uint32_t used;
+} UNIQ_INSTR;
+
+typedef struct {
+    UNIQ_INSTR *instrs;     // indexed by instr. number
+    int numinstrs;
+} UNIQ_GLOBALS;
+
+#define UNIQ_GLOBALS_VARNAME "__uniqinstance_globals__"
 
 typedef struct {
     OPDS h;
-    MYFLT *out, *int_instrnum, *max_instances;
+    MYFLT *out, *int_instrnum, *max_instances, *pending_time;
     int p1;
     int numslots;
-    char slots[UNIQ_NUMSLOTS];
+    int64_t pendingsamps;
 } UNIQINSTANCE;
 
-static MYFLT
-uniqueinstance_(CSOUND *csound, UNIQINSTANCE *p) {
-    // char slots[UNIQ_NUMSLOTS] = {0};
-    char *slots = p->slots;
-    int numslots = p->numslots;
-    memset(slots, 0, numslots);
-    int p1 = p->p1;
-    int idx;
-    int maxidx = 0;
-    int minidx = numslots;
-    MYFLT fractional_part, integral_part;
+static int32_t uniq_reset(CSOUND *csound, UNIQ_GLOBALS *g) {
+    for(int i = 0; i < g->numinstrs; i++) {
+        UNIQ_INSTR *u = &(g->instrs[i]);
+        UNIQ_ALLOC *a = u->allocs;
+        while(a != NULL) {
+            UNIQ_ALLOC *next = a->nextalloc;
+            csound->Free(csound, a->reserved);
+            csound->Free(csound, a);
+            a = next;
+        }
+        if(u->pending != NULL)
+            csound->Free(csound, u->pending);
+    }
+    if(g->instrs != NULL)
+        csound->Free(csound, g->instrs);
+    csound->DestroyGlobalVariable(csound, UNIQ_GLOBALS_VARNAME);
+    return OK;
+}
 
-    // INSTRTXT *instrtxt = csound->GetInstrument(csound, p1, NULL);
-    INSTRTXT *instrtxt = GetInstrumentByNumber(csound, p1);
-    if(!instrtxt || instrtxt->instance == NULL) {
-        // no instances of this instrument, so pick first index
-        return p1 + FL(1)/numslots;
+static UNIQ_GLOBALS *uniq_globals(CSOUND *csound) {
+    UNIQ_GLOBALS *g = csound->QueryGlobalVariable(csound, UNIQ_GLOBALS_VARNAME);
+    if(g != NULL) return g;
+    if(csound->CreateGlobalVariable(csound, UNIQ_GLOBALS_VARNAME, sizeof(UNIQ_GLOBALS)) != 0)
+        return NULL;
+    g = csound->QueryGlobalVariable(csound, UNIQ_GLOBALS_VARNAME);
+    g->instrs = NULL;
+    g->numinstrs = 0;
+    csound->RegisterResetCallback(csound, (void *)g, (int32_t(*)(CSOUND*, void*))uniq_reset);
+    return g;
+}
+
+static UNIQ_INSTR *uniq_instr_get(CSOUND *csound, UNIQ_GLOBALS *g, int insno) {
+    if(insno >= g->numinstrs) {
+        int numinstrs = insno + 1 > g->numinstrs * 2 ? insno + 1 : g->numinstrs * 2;
+        UNIQ_INSTR *instrs = csound->Calloc(csound, sizeof(UNIQ_INSTR) * numinstrs);
+        if(g->instrs != NULL) {
+            memcpy(instrs, g->instrs, sizeof(UNIQ_INSTR) * g->numinstrs);
+            csound->Free(csound, g->instrs);
+        }
+        g->instrs = instrs;
+        g->numinstrs = numinstrs;
+    }
+    UNIQ_INSTR *u = &(g->instrs[insno]);
+    if(u->pending == NULL) {
+        u->size = UNIQ_PENDING_INITSIZE;
+        u->used = 0;
+        u->pending = csound->Calloc(csound, sizeof(UNIQ_PENDING) * u->size);
+    }
+    return u;
+}
+
+static inline UNIQ_PENDING *uniq_pending_slot(UNIQ_INSTR *u, MYFLT p1) {
+    // returns the slot for p1, or the empty slot where it would be inserted
+    uint32_t mask = u->size - 1;
+    uint32_t i = instance_index_hash(p1) & mask;
+    while(u->pending[i].deadline != 0 && u->pending[i].p1 != p1)
+        i = (i + 1) & mask;
+    return &(u->pending[i]);
+}
+
+// Move the pending numbers with a deadline after `now` to a table of the given size
+static void uniq_pending_rebuild(CSOUND *csound, UNIQ_INSTR *u, uint32_t size, int64_t now) {
+    UNIQ_PENDING *oldslots = u->pending;
+    uint32_t oldsize = u->size;
+    u->pending = csound->Calloc(csound, sizeof(UNIQ_PENDING) * size);
+    u->size = size;
+    u->used = 0;
+    for(uint32_t i = 0; i < oldsize; i++) {
+        if(oldslots[i].deadline > now) {
+            *uniq_pending_slot(u, oldslots[i].p1) = oldslots[i];
+            u->used++;
+        }
     }
+    csound->Free(csound, oldslots);
+}
 
-    INSDS *instance = instrtxt->instance;
-    while(instance) {
-        if(instance->actflg && instance->p1.value != instance->insno) {
-            fractional_part = modf(instance->p1.value, &integral_part);
-            idx = (int)(fractional_part * numslots + 0.5);
-            if(idx >= numslots)
+static inline void uniq_reserve(UNIQ_ALLOC *a, int slot) {
+    a->reserved[slot >> 6] |= (uint64_t)1 << (slot & 63);
+}
+
+// Reserve the slot nearest to p1 (as the old scan did), a conservative match
+// for numbers which were not produced by this allocator
+static inline void uniq_reserve_near(UNIQ_ALLOC *a, MYFLT p1) {
+    MYFLT fractional_part, integral_part;
+    fractional_part = modf(p1, &integral_part);
+    int slot = (int)(fractional_part * a->numslots + 0.5);
+    if(slot < a->numslots)
+        uniq_reserve(a, slot);
+}
+
+// Rebuild the bitmap: slot 0 (the integer instr. number) and the bits after
+// the last slot are never free, then the running instances and the numbers
+// still pending. Pending numbers whose instance is running now, or whose
+// deadline has passed, are not pending anymore
+static void uniq_refresh(CSOUND *csound, UNIQ_INSTR *u, UNIQ_ALLOC *a, INSTRTXT *instrtxt) {
+    memset(a->reserved, 0, sizeof(uint64_t) * a->numwords);
+    uniq_reserve(a, 0);
+    for(int slot = a->numslots; slot < a->numwords * 64; slot++)
+        uniq_reserve(a, slot);
+    int64_t now = csound->GetCurrentTimeSamples(csound);
+    if(instrtxt != NULL) {
+        for(INSDS *instance = instrtxt->instance; instance != NULL; instance = instance->nxtinstance) {
+            if(!instance->actflg || instance->p1.value == instance->insno)
                 continue;
-            if(idx > maxidx)
-                maxidx = idx;
-            else if(idx < minidx)
-                minidx = idx;
-            slots[idx] = 1;
+            uniq_reserve_near(a, instance->p1.value);
+            UNIQ_PENDING *pending = uniq_pending_slot(u, instance->p1.value);
+            if(pending->deadline != 0)
+                pending->deadline = now;
         }
-        instance = instance->nxtinstance;
     }
-    if(maxidx + 1 < numslots) {
-        return p1 + (maxidx+1)/FL(numslots);
-    }
-    if(minidx > 2) {
-        return p1 + (minidx-1)/FL(numslots);
+    uniq_pending_rebuild(csound, u, u->size, now);
+    for(uint32_t i = 0; i < u->size; i++) {
+        if(u->pending[i].deadline != 0)
+            uniq_reserve_near(a, u->pending[i].p1);
+    }
+}
+
+static UNIQ_ALLOC *uniq_alloc_get(CSOUND *csound, UNIQ_INSTR *u, int numslots, INSTRTXT *instrtxt) {
+    UNIQ_ALLOC *a = u->allocs;
+    while(a != NULL && a->numslots != numslots)
+        a = a->nextalloc;
+    if(a != NULL)
+        return a;
+    a = csound->Calloc(csound, sizeof(UNIQ_ALLOC));
+    a->numslots = numslots;
+    a->numwords = (numslots + 63) / 64;
+    a->next = 1;
+    a->reserved = csound->Calloc(csound, sizeof(uint64_t) * a->numwords);
+    a->nextalloc = u->allocs;
+    u->allocs = a;
+    uniq_refresh(csound, u, a, instrtxt);
+    return a;
+}
+
+// The first free slot at or after `from`, -1 if there is none
+static int uniq_find_free(UNIQ_ALLOC *a, int from) {
+    int word = from >> 6;
+    if(word >= a->numwords)
+        return -1;
+    uint64_t free_bits = ~a->reserved[word] & (~(uint64_t)0 << (from & 63));
+    while(free_bits == 0) {
+        if(++word >= a->numwords)
+            return -1;
+        free_bits = ~a->reserved[word];
     }
-    for(int i=1; i < numslots; i++) {
-        if(slots[i] == 0) {
-            return p1 + i / FL(numslots);
-        }
+    return word * 64 + __builtin_ctzll(free_bits);
+}
+
+static MYFLT
+uniqueinstance_(CSOUND *csound, UNIQINSTANCE *p) {
+    int p1 = p->p1;
+    UNIQ_GLOBALS *g = uniq_globals(csound);
+    if(g == NULL)
+        return -1;
+    UNIQ_INSTR *u = uniq_instr_get(csound, g, p1);
+    // INSTRTXT *instrtxt = csound->GetInstrument(csound, p1, NULL);
+    INSTRTXT *instrtxt = GetInstrumentByNumber(csound, p1);
+    UNIQ_ALLOC *a = uniq_alloc_get(csound, u, p->numslots, instrtxt);
+    int slot = uniq_find_free(a, a->next);
+    if(slot < 0)
+        slot = uniq_find_free(a, 1);
+    if(slot < 0) {
+        uniq_refresh(csound, u, a, instrtxt);
+        slot = uniq_find_free(a, a->next);
+        if(slot < 0)
+            slot = uniq_find_free(a, 1);
+        if(slot < 0)
+            return -1;
     }
-    return -1;
+    uniq_reserve(a, slot);
+    a->next = slot + 1;
+    MYFLT instrnum = p1 + slot / FL(a->numslots);
+    // pending until seen running or until its deadline
+    if((u->used + 1) * 2 > u->size)
+        uniq_pending_rebuild(csound, u, u->size * 2, csound->GetCurrentTimeSamples(csound));
+    UNIQ_PENDING *pending = uniq_pending_slot(u, instrnum);
+    if(pending->deadline == 0)
+        u->used++;
+    pending->p1 = instrnum;
+    pending->deadline = csound->GetCurrentTimeSamples(csound) + p->pendingsamps;
+    // other numbers of slots must not hand out this number before their next refresh
+    for(UNIQ_ALLOC *other = u->allocs; other != NULL; other = other->nextalloc) {
+        if(other != a)
+            uniq_reserve_near(other, instrnum);
+    }
+    return instrnum;
 }
 
 static int32_t
 uniqueinstance_initcommon(CSOUND *csound, UNIQINSTANCE *p) {
-    IGN(csound);
     p->numslots = (int)*p->max_instances;
-    if(p->numslots == 0)
+    if(p->numslots <= 0)
         p->numslots = UNIQ_NUMSLOTS;
     else if(p->numslots > UNIQ_NUMSLOTS)
         p->numslots = UNIQ_NUMSLOTS;
+    MYFLT pending = *p->pending_time >= 0 ? *p->pending_time : UNIQ_PENDING_SECONDS;
+    // at least one cycle, so that an event scheduled now can start
+    p->pendingsamps = (int64_t)(pending * csound->GetSr(csound)) + CS_KSMPS + 1;
     MYFLT instrnum = uniqueinstance_(csound, p);
     *p->out = instrnum;
     return OK;
@@ -2146,11 +2527,19 @@ endin
 
   atstop works at instr deinit. Any k-variable
   might already be deallocated so we copy all arguments
-  at init time
+  at deinit time
 
   atstop Sintr, idelay, idur, pfields...
   atstop instrnum, idelay, idur, pfields...
 
+  Events are not scheduled from within the deinit: they are appended
+  to a per-engine queue of binary records and flushed into the scheduler
+  once per cycle, via a sense event callback. String arguments are
+  copied to the queue as they are. With API6 they are passed to the
+  scheduler as string p-fields of the event block. The Event call of
+  API7 only takes numeric p-fields, so there events with string
+  arguments are sent as score lines via InputMessage.
+
 */
 
 #define ATSTOP_MAXPARGS 64
@@ -2168,87 +2557,256 @@ typedef struct {
     // internal
     MYFLT instrnum;   // cached instrnum
 
-    size_t numargs;
+    int32_t numargs;
+    uint64_t strargs; // bit i is set if pargs[i] is a string
 
 } SCHED_DEINIT;
 
 
-static int32_t
-atstop_deinit(CSOUND *csound, SCHED_DEINIT *p) {
-#ifdef CSOUNDAPI7
-    MYFLT pfields[VARGMAX] = {0};
-    MYFLT offset = csound->GetScoreOffsetSeconds(csound);
-    pfields[0] = p->instrnum;
-    pfields[1] = offset + (*p->p2);
-    pfields[2] = *p->p3;
-    for(uint32_t i=0; i<p->numargs; i++) {
-        pfields[3+i] = *(MYFLT *)p->pargs[i];
-    }
-    
-    csound->Event(csound, 0, (const MYFLT *)(&pfields), p->numargs + 3);
-    return OK;
-#else
+typedef struct {
+    MYFLT p1, p2, p3;
+    int64_t time;       // time in samples when the note stopped
+    int32_t numargs;    // p4, p5, ...
+    int32_t argoffset;  // index of p4 in the args of the queue
+    uint64_t strargs;   // bit i is set if p(4+i) is a string, its value is
+                        // an offset into the strings of the queue
+} ATSTOP_EVENT;
+
+typedef struct {
+    ATSTOP_EVENT *events;
+    int32_t numevents, maxevents;
+    MYFLT *args;
+    int32_t numargs, maxargs;
+    char *strings;
+    int32_t stringslen, maxstrings;
+#ifdef CSOUNDAPI6
     EVTBLK evt;
-    memset(&evt, 0, sizeof(EVTBLK));
-    evt.opcod = 'i';
-    evt.strarg = NULL;
-    evt.scnt = 0;
-    evt.pinstance = NULL;
-    evt.p2orig = p->h.insdshead->p2.value;
-    evt.p3orig = p->h.insdshead->p3.value;
-    evt.p[1] = p->instrnum;
-    evt.p[2] = *p->p2;
-    evt.p[3] = *p->p3;
-    for(size_t i=0; i < p->numargs; i++) {
-        evt.p[4+i] = *(MYFLT *)p->pargs[i];
-    }
-    evt.pcnt = (int16_t)(p->numargs + 3);
-    InsertScoreEventNow(csound, &evt, &(p->h));
-    return OK;
+#else
+    char *message;      // score lines for events with string args
+    int32_t maxmessage;
 #endif
-}
+} ATSTOP_QUEUE;
+
+#define ATSTOP_QUEUE_VARNAME "__atstop_queue__"
 
+static void atstop_flush(CSOUND *csound, void *userdata);
 
-static int32_t add_string_arg(char *s, const char *arg, int32_t lens) {
-  const char *s0 = s;
-  s += lens;
-  *s++ = ' ';
-  *s++ ='\"';
-  while(*arg != '\0') {
-    if(*arg == '\"')
-      *s++ = '\\';
-    *s++ = *arg++;
-  }
+static int32_t atstop_reset(CSOUND *csound, ATSTOP_QUEUE *q) {
+    csound->Free(csound, q->events);
+    csound->Free(csound, q->args);
+    csound->Free(csound, q->strings);
+#ifdef CSOUNDAPI7
+    if(q->message != NULL)
+        csound->Free(csound, q->message);
+#endif
+    csound->DestroyGlobalVariable(csound, ATSTOP_QUEUE_VARNAME);
+    return OK;
+}
 
-  *s++ = '\"';
-  *s = '\0';
-  return (s - s0) + lens;
+static ATSTOP_QUEUE *atstop_queue(CSOUND *csound) {
+    ATSTOP_QUEUE *q = csound->QueryGlobalVariable(csound, ATSTOP_QUEUE_VARNAME);
+    if(q != NULL) return q;
+    if(csound->CreateGlobalVariable(csound, ATSTOP_QUEUE_VARNAME, sizeof(ATSTOP_QUEUE)) != 0)
+        return NULL;
+    q = csound->QueryGlobalVariable(csound, ATSTOP_QUEUE_VARNAME);
+    // initial sizes, will double when full
+    q->maxevents = 256;
+    q->events = csound->Calloc(csound, sizeof(ATSTOP_EVENT) * q->maxevents);
+    q->maxargs = 4096;
+    q->args = csound->Calloc(csound, sizeof(MYFLT) * q->maxargs);
+    q->maxstrings = 4096;
+    q->strings = csound->Calloc(csound, q->maxstrings);
+#ifdef CSOUNDAPI7
+    q->message = NULL;
+    q->maxmessage = 0;
+#endif
+    csound->RegisterSenseEventCallback(csound, atstop_flush, (void *)q);
+    csound->RegisterResetCallback(csound, (void *)q, (int32_t(*)(CSOUND*, void*))atstop_reset);
+    return q;
 }
 
+// make room for `needed` items, `*data` holds `*capacity` items of size `itemsize`
+static void atstop_reserve(CSOUND *csound, void **data, int32_t *capacity,
+                           int32_t needed, size_t itemsize) {
+    if(needed <= *capacity)
+        return;
+    int32_t capacity2 = *capacity;
+    while(capacity2 < needed)
+        capacity2 *= 2;
+    *data = csound->ReAlloc(csound, *data, itemsize * capacity2);
+    *capacity = capacity2;
+}
 
 static int32_t
-atstop_deinit_N(CSOUND *csound, SCHED_DEINIT *p) {
-    char s[16384], sf[64];
-    snprintf(s, 16384, "i %f %f %f", p->instrnum, *p->p2, *p->p3);
-    int32_t lens = strlen(s);
-    int32_t lenarg;
-    for(size_t i=0; i < p->numargs; i++) {
-        if(_GetTypeForArg(csound, p->pargs[i])->varTypeName[0] == 'S') {
-            lenarg = add_string_arg(s, ((STRINGDAT *)p->pargs[i])->data, lens);
-            lens += lenarg;
+atstop_deinit(CSOUND *csound, SCHED_DEINIT *p) {
+    ATSTOP_QUEUE *q = atstop_queue(csound);
+    if(q == NULL)
+        return NOTOK;
+    int32_t numargs = p->numargs;
+    atstop_reserve(csound, (void **)&(q->events), &(q->maxevents), q->numevents + 1,
+                   sizeof(ATSTOP_EVENT));
+    atstop_reserve(csound, (void **)&(q->args), &(q->maxargs), q->numargs + numargs,
+                   sizeof(MYFLT));
+    ATSTOP_EVENT *ev = &(q->events[q->numevents++]);
+    ev->p1 = p->instrnum;
+    ev->p2 = *p->p2;
+    ev->p3 = *p->p3;
+    ev->time = csound->GetCurrentTimeSamples(csound);
+    ev->numargs = numargs;
+    ev->argoffset = q->numargs;
+    ev->strargs = p->strargs;
+    MYFLT *args = q->args + q->numargs;
+    q->numargs += numargs;
+    for(int32_t i=0; i < numargs; i++) {
+        if(p->strargs & ((uint64_t)1 << i)) {
+            const char *s = ((STRINGDAT *)p->pargs[i])->data;
+            int32_t len = (int32_t)strlen(s) + 1;
+            atstop_reserve(csound, (void **)&(q->strings), &(q->maxstrings),
+                           q->stringslen + len, 1);
+            memcpy(q->strings + q->stringslen, s, len);
+            args[i] = q->stringslen;
+            q->stringslen += len;
         } else {
-            lens += snprintf(sf, 64, " %f", *(MYFLT*)p->pargs[i]);
-            strncat(s, sf, 16384 - lens);
+            args[i] = *(MYFLT *)p->pargs[i];
         }
     }
-    csound->InputMessage(csound, s);
     return OK;
 }
 
+#ifdef CSOUNDAPI7
+// Appends an event with string args as a score line to the message of the
+// queue, escaping any quotes
+static void atstop_format_event(CSOUND *csound, ATSTOP_QUEUE *q, ATSTOP_EVENT *ev,
+                                MYFLT delay, int32_t *len) {
+    int32_t needed = *len + 64 * (ev->numargs + 3) + 2;
+    for(int32_t i=0; i < ev->numargs; i++) {
+        if(ev->strargs & ((uint64_t)1 << i))
+            needed += 2 * (int32_t)strlen(q->strings + (int32_t)q->args[ev->argoffset + i]) + 3;
+    }
+    if(q->maxmessage == 0) {
+        q->maxmessage = 4096;
+        q->message = csound->Malloc(csound, q->maxmessage);
+    }
+    atstop_reserve(csound, (void **)&(q->message), &(q->maxmessage), needed, 1);
+    char *s = q->message + *len;
+    s += snprintf(s, 200, "i %.12g %.12g %.12g", ev->p1, delay, ev->p3);
+    for(int32_t i=0; i < ev->numargs; i++) {
+        MYFLT arg = q->args[ev->argoffset + i];
+        if(ev->strargs & ((uint64_t)1 << i)) {
+            const char *str = q->strings + (int32_t)arg;
+            *s++ = ' ';
+            *s++ = '\"';
+            while(*str != '\0') {
+                if(*str == '\"')
+                    *s++ = '\\';
+                *s++ = *str++;
+            }
+            *s++ = '\"';
+        } else {
+            s += snprintf(s, 64, " %.12g", arg);
+        }
+    }
+    *s++ = '\n';
+    *s = '\0';
+    *len = (int32_t)(s - q->message);
+}
+#endif
+
+// Called once per cycle, schedules the events queued since the last call.
+// The delay is counted from the time the note stopped
+static void atstop_flush(CSOUND *csound, void *userdata) {
+    ATSTOP_QUEUE *q = (ATSTOP_QUEUE *)userdata;
+    if(q->numevents == 0)
+        return;
+    int64_t now = csound->GetCurrentTimeSamples(csound);
+    MYFLT sr = csound->GetSr(csound);
+#ifdef CSOUNDAPI7
+    int32_t messagelen = 0;
+    MYFLT pfields[ATSTOP_MAXPARGS + 3];
+    MYFLT offset = csound->GetScoreOffsetSeconds(csound);
+#else
+    EVTBLK *evt = &(q->evt);
+    evt->opcod = 'i';
+    evt->pinstance = NULL;
+#endif
+    for(int32_t n=0; n < q->numevents; n++) {
+        ATSTOP_EVENT *ev = &(q->events[n]);
+        MYFLT delay = ev->p2;
+        if(delay > 0) {
+            delay -= (now - ev->time) / sr;
+            if(delay < 0)
+                delay = 0;
+        }
+        MYFLT *args = q->args + ev->argoffset;
+#ifdef CSOUNDAPI7
+        if(ev->strargs != 0) {
+            atstop_format_event(csound, q, ev, delay, &messagelen);
+            continue;
+        }
+        pfields[0] = ev->p1;
+        pfields[1] = offset + delay;
+        pfields[2] = ev->p3;
+        for(int32_t i=0; i < ev->numargs; i++) {
+            pfields[3+i] = args[i];
+        }
+        csound->Event(csound, 0, (const MYFLT *)pfields, ev->numargs + 3);
+#else
+        evt->p2orig = delay;
+        evt->p3orig = ev->p3;
+        evt->p[1] = ev->p1;
+        evt->p[2] = delay;
+        evt->p[3] = ev->p3;
+        // the strings of an event are contiguous in the queue, in the order
+        // of the args. A string p-field is SSTRCOD with the index of the
+        // string in strarg, the scheduler copies strarg
+        evt->strarg = NULL;
+        evt->scnt = 0;
+        for(int32_t i=0; i < ev->numargs; i++) {
+            if(ev->strargs & ((uint64_t)1 << i)) {
+                union { MYFLT d; int32_t j; } ch;
+                if(evt->strarg == NULL)
+                    evt->strarg = q->strings + (int32_t)args[i];
+                ch.d = SSTRCOD;
+                ch.j += evt->scnt++;
+                evt->p[4+i] = ch.d;
+            } else {
+                evt->p[4+i] = args[i];
+            }
+        }
+        evt->pcnt = (int16_t)(ev->numargs + 3);
+        InsertScoreEventNow(csound, evt, NULL);
+#endif
+    }
+    q->numevents = 0;
+    q->numargs = 0;
+    q->stringslen = 0;
+#ifdef CSOUNDAPI7
+    if(messagelen > 0)
+        csound->InputMessage(csound, q->message);
+#else
+    evt->strarg = NULL;
+    evt->scnt = 0;
+#endif
+}
+
 static int32_t
 atstop_init(CSOUND *csound, SCHED_DEINIT *p, MYFLT instrnum) {
     p->instrnum = instrnum;
-    p->numargs = _GetInputArgCnt(csound, p) - 3;
+    // the optional p2 and p3 of "ioj" / "Soj" might be missing
+    int32_t numargs = _GetInputArgCnt(csound, p) - 3;
+    if(numargs < 0)
+        numargs = 0;
+    else if(numargs > ATSTOP_MAXPARGS)
+        return INITERRF("atstop: too many p-fields (max. %d)", ATSTOP_MAXPARGS + 3);
+    p->numargs = numargs;
+    p->strargs = 0;
+    for(int32_t i=0; i < numargs; i++) {
+        if(_GetTypeForArg(csound, p->pargs[i])->varTypeName[0] == 'S')
+            p->strargs |= (uint64_t)1 << i;
+    }
+    // create the queue now, so that the deinit only appends to it
+    if(atstop_queue(csound) == NULL)
+        return INITERR("atstop: failed to create the event queue");
 
 #ifdef CSOUNDAPI6
     register_deinit(csound, p, atstop_deinit);
@@ -2267,8 +2825,6 @@ atstop_s(CSOUND *csound, SCHED_DEINIT *p) {
     STRINGDAT *instrname = (STRINGDAT*) p->instr;
     int32_t instrnum = _StringArg2Insno(csound, instrname->data, 1);
     if (UNLIKELY(instrnum == NOT_AN_INSTRUMENT)) return NOTOK;
-    p->instrnum = instrnum;
-    p->numargs = _GetInputArgCnt(csound, p) - 3;
     return atstop_init(csound, p, (MYFLT) instrnum);
 }
 
@@ -6941,365 +7497,27 @@ static int32_t strmul_i(CSOUND *csound, STRMUL *p) {
 
 // -------------------- pyin
 
-#define PYIN_MAX_CANDIDATES   16    /* pYIN threshold candidates per frame    */
-#define PYIN_N_THRESHOLDS     100   /* number of threshold values to try      */
-#define PYIN_THRESHOLD_MIN    0.01
-#define PYIN_THRESHOLD_MAX    0.15
-#define PYIN_DRIFT_SEMITONES  5
-#define PYIN_BETA_A           2.0   /* Beta distribution shape parameter a    */
-#define PYIN_BETA_B           18.0  /* Beta distribution shape parameter b    */
-#define PYIN_MAX_HMM_STATES   960   // max hmm states, 8 bins per semitone
-#define PYIN_MIDI_MIN  0
-#define PYIN_MIDI_MAX  119
-
-#define PYIN_VOICED_PROB      0.9   /* prior probability of voicing           */
-#define PYIN_MAX_BUF          16384 /* maximum supported buffer size          */
-#define PYIN_MINTAU           0.001
-
-/* -------------------------------------------------------------------------
- * Helper: Beta distribution PDF  B(x; a, b)  (unnormalized is fine here)
- *
- * We use the threshold t as x and compute proportional weights.
- * ------------------------------------------------------------------------- */
-static inline MYFLT beta_pdf(MYFLT x, MYFLT a, MYFLT b)
-{
-    if (x <= 0.0 || x >= 1.0) return 0.0;
-    return pow(x, a - 1.0) * pow(1.0 - x, b - 1.0);
-}
-
-/* -------------------------------------------------------------------------
- * Helper: parabolic interpolation to refine the lag estimate.
- * Returns sub-sample lag at the minimum around index tau.
- * ------------------------------------------------------------------------- */
-static inline MYFLT parabolic_interpolation(MYFLT *d, int tau, int len)
-{
-    if (tau <= 0 || tau >= len - 1)
-        return (MYFLT)tau;
-    MYFLT s0 = d[tau - 1];
-    MYFLT s1 = d[tau];
-    MYFLT s2 = d[tau + 1];
-    MYFLT denom = 2.0 * (s0 - 2.0 * s1 + s2);
-    if (fabs(denom) < 1e-10)
-        return (MYFLT)tau;
-    return (MYFLT)tau + (s0 - s2) / denom;
-}
-
-/* -------------------------------------------------------------------------
- * Step 1 & 2: YIN difference function then CMND.
- *
- * d(tau) = sum_{j=0}^{W-tau-1} (x[j] - x[j+tau])^2
- *
- * We use the naive O(W^2) approach for clarity and correctness.
- * For a production opcode you would replace this with the FFT-based
- * autocorrelation trick (r[0] + r[tau] - 2*r[tau] via IFFT of |X|^2),
- * which reduces it to O(W log W).
- * ------------------------------------------------------------------------- */
-static void compute_yin_cmnd(MYFLT *x, MYFLT *diff, MYFLT *cmnd,
-                              int W, int taumax)
-{
-    int tau, j;
-    MYFLT running_sum = 0.0;
-
-    diff[0] = 0.0;
-    cmnd[0] = 1.0;
-
-    for (tau = 1; tau <= taumax; tau++) {
-        MYFLT s = 0.0;
-        int limit = W - tau;
-        for (j = 0; j < limit; j++) {
-            MYFLT delta = x[j] - x[j + tau];
-            s += delta * delta;
-        }
-        diff[tau] = s;
-        running_sum += s;
-        if (running_sum < 1e-20)
-            cmnd[tau] = 1.0;
-        else
-            cmnd[tau] = s * (MYFLT)tau / running_sum;
-    }
-}
-
-
-static void precalculate_thresholds(MYFLT *beta_weights, MYFLT *thresholds) {
-    MYFLT delta_threshold = PYIN_THRESHOLD_MAX - PYIN_THRESHOLD_MIN;
-    MYFLT weight_sum = 0.;
-    MYFLT denom = (MYFLT)(PYIN_N_THRESHOLDS - 1);
-    for (int t = 0; t < PYIN_N_THRESHOLDS; t++) {
-        MYFLT thresh = PYIN_THRESHOLD_MIN + (MYFLT)t * delta_threshold / denom;
-        thresholds[t] = thresh;
-        MYFLT weight = beta_pdf(thresh, PYIN_BETA_A, PYIN_BETA_B);
-        beta_weights[t] = weight;
-        weight_sum += weight;
-    }
-    /* Normalise */
-    if (weight_sum > 0.0) {
-        for (int t = 0; t < PYIN_N_THRESHOLDS; t++)
-            beta_weights[t] /= weight_sum;
-    }
-}
-
-/* -------------------------------------------------------------------------
- * Step 3 & 4 (pYIN extension): instead of picking the single best lag
- * below a global threshold (as in plain YIN), pYIN considers N_THRESHOLDS
- * threshold values and weights each resulting pitch candidate by:
- *
- *   p(threshold) ~ Beta(threshold; a, b)          [prior on threshold]
- *   p(candidate | threshold) = 1 - threshold      [probability it is pitched]
- *
- * Returns the number of candidates found.
- * ------------------------------------------------------------------------- */
-static int pyin_pitch_candidates(MYFLT *cmnd, int taumin, int taumax,
-                                 MYFLT sr,
-                                 MYFLT *out_freq, MYFLT *out_prob,
-                                 int maxcands, MYFLT *beta_weights, MYFLT *thresholds)
-{
-    int n_cands = 0;
-    taumax = taumax < 4095 ? taumax : 4095;
-    MYFLT tau_prob[4096] = {0};
-
-    /*
-     * For each threshold, find the first lag in [taumin, taumax] where
-     * cmnd drops below threshold (the YIN "absolute threshold" rule).
-     * Accumulate probability weight for that lag.
-     */
-
-    /* Temporary accumulator indexed by tau */
-    int tau_len = taumax + 1;
-    for (int t = 0; t < PYIN_N_THRESHOLDS; t++) {
-        MYFLT thr = thresholds[t];
-        MYFLT w = beta_weights[t];
-        int tau;
-        for (tau = taumin; tau <= taumax; tau++) {
-            if (cmnd[tau] < thr) {
-                /* Found first minimum below threshold — walk to local min */
-                while (tau + 1 <= taumax && cmnd[tau + 1] < cmnd[tau])
-                    tau++;
-                /* Weight = Beta(thr) * (1 - thr) meaning "pitched at thr" */
-                tau_prob[tau] += w * (1.0 - thr);
-                break;  /* one candidate per threshold */
-            }
-        }
-        // If no tau found below threshold, probability mass goes to unvoiced
-    }
-
-    /* Collapse adjacent tau bins into candidates by finding local maxima
-     * in tau_prob. Each peak becomes one candidate
-     */
-    for (int tau = taumin + 1; tau < taumax && n_cands < maxcands; tau++) {
-        MYFLT prob = tau_prob[tau];
-        // if (tau_prob[tau] > 0.0 &&
-        //     tau_prob[tau] >= tau_prob[tau - 1] &&
-        //     tau_prob[tau] >= tau_prob[tau + 1])
-        if(prob > 0.0 && prob >= tau_prob[tau - 1] && prob >= tau_prob[tau + 1])
-        {
-            /* Parabolic interpolation on cmnd for the lag */
-            MYFLT refined_tau = parabolic_interpolation(cmnd, tau, tau_len);
-            MYFLT freq = (refined_tau > 0.0) ? sr / refined_tau : 0.0;
-
-            /* Accumulate neighbouring probability */
-            // MYFLT prob = tau_prob[tau];
-            if (tau > 0)         prob += tau_prob[tau - 1] * 0.5;
-            if (tau < taumax)    prob += tau_prob[tau + 1] * 0.5;
-            if (prob > 1.0)      prob = 1.0;
-
-            out_freq[n_cands] = freq;
-            out_prob[n_cands] = prob;
-            n_cands++;
-        }
-    }
-
-    // If nothing found but some tau_prob exists, take the highest
-    if (n_cands == 0) {
-        MYFLT best = 0.0;
-        int best_tau = -1;
-        for (int tau = taumin; tau <= taumax; tau++) {
-            if (tau_prob[tau] > best) {
-                best = tau_prob[tau];
-                best_tau = tau;
-            }
-        }
-        if (best_tau > 0 && best > PYIN_MINTAU) {
-            MYFLT refined_tau = parabolic_interpolation(cmnd, best_tau, tau_len);
-            out_freq[0] = (refined_tau > 0.0) ? sr / refined_tau : 0.0;
-            out_prob[0] = best;
-            n_cands = 1;
-        }
-    }
-
-    return n_cands;
-}
-
-/* -------------------------------------------------------------------------
- * HMM: map Hz to a state index (0..PYIN_HMM_STATES-1).
- * We use a chromatic pitch grid in MIDI note space, with PYIN_SUBBINS sub-bins per
- * semitone
- * ------------------------------------------------------------------------- */
-
-static inline int freq_to_state(MYFLT freq, MYFLT a4, int hmmstates, int subbins)
-{
-    if (freq <= 0.0) return 0;  // check at the callsize that freq is positive
-    MYFLT midi = 12.0 * log2(freq / a4) + 69.0;
-    int state = (int)round((midi - PYIN_MIDI_MIN) * subbins);
-    if (state < 0) state = 0;
-    if (state >= hmmstates) state = hmmstates - 1;
-    return state;  // 0 <= state < hmmstates
-}
-
-static inline MYFLT state_to_freq(int state, MYFLT a4, int subbins)
-{
-    MYFLT midi = PYIN_MIDI_MIN + (MYFLT)state / (MYFLT)subbins;
-    return a4 * pow(2.0, (midi - 69.0) / 12.0);
-}
-
-/* -------------------------------------------------------------------------
- * HMM transition weight between states i and j.
- *
- * We use a simple Gaussian in pitch distance (in semitones).
- * Self-transitions get extra weight via PYIN_TRANS_SELF.
- * ------------------------------------------------------------------------- */
-static inline MYFLT transition_weight(int i, int j, MYFLT trans_self, int subbins)
-{
-    if (i == j) return trans_self;
-    MYFLT dist_semitones = fabs((MYFLT)(i - j)) / (MYFLT)subbins;
-    /* Gaussian with sigma=1 semitone */
-    MYFLT w = (1.0 - trans_self) * exp(-0.5 * dist_semitones * dist_semitones);
-    return w;
-}
-
-/* -------------------------------------------------------------------------
- * HMM forward step (no lookahead for real-time).
- *
- * fwd[s] represents p(pitch_state=s | observations_up_to_now)
- *
- * If any candidate maps to state s, obs[s] = that candidate's probability.
- * States with no candidate: small floor value (unvoiced mass spread evenly).
- *
- * We keep one unvoiced "super-state" by treating p_unvoiced as a scalar.
- * ------------------------------------------------------------------------- */
-
-
-#define GAUSS_1 0.60653065971263342  /* exp(-0.5) */
-
-static void hmm_forward_step(
-    MYFLT *fwd_prev,
-    MYFLT *fwd_cur,
-    MYFLT *cand_freq,
-    MYFLT *cand_prob,
-    int n_cands,
-    MYFLT a4,
-    MYFLT transprob,
-    int drift_semitones,
-    int hmm_states,
-    int subbins,
-    MYFLT *transition_matrix)
-{
-    int s, c, j;
-
-    // observation likelihoods
-    MYFLT obs[PYIN_MAX_HMM_STATES] = {0};
-
-    if(transprob == 0.)
-        transprob = 0.99;
-    for (c = 0; c < n_cands; c++) {
-        MYFLT freq = cand_freq[c];
-        if(freq <= 0)
-            continue;
-        int st = freq_to_state(cand_freq[c], a4, hmm_states, subbins);
-        // Spread over ±1 sub-bin with Gaussian weights
-        // delta = 0, weight = 1.0
-        obs[st] += cand_prob[c];
-
-        // delta = -1 and +1, weight = exp(-0.5)
-        if (st >= 1) {
-            MYFLT w = cand_prob[c] * GAUSS_1;
-            obs[st - 1] += w;
-        }
-        if (st + 1 < hmm_states) {
-            MYFLT w = cand_prob[c] * GAUSS_1;
-            obs[st + 1] += w;
-        }
-    }
-
-    // Unvoiced observation probability = 1 - sum of voiced candidate probs
-    MYFLT total_voiced_prob = 0.0;
-    for (c = 0; c < n_cands; c++)
-        total_voiced_prob += cand_prob[c];
-    if (total_voiced_prob > 1.0) total_voiced_prob = 1.0;
-    MYFLT p_unvoiced_obs = 1.0 - total_voiced_prob;
-
-    // Forward update: marginalise over previous states via transition
-    MYFLT norm = 0.0;
-    int drift_bins = drift_semitones * subbins;
-
-    for (s = 0; s < hmm_states; s++) {
-        MYFLT trans_sum = 0.0;
-        // Only consider a band of nearby states for efficiency +/- drift_bins
-        int lo = s - drift_bins;
-        int hi = s + drift_bins;
-        if (lo < 0) lo = 0;
-        if (hi >= hmm_states) hi = hmm_states - 1;
-        if(transition_matrix != NULL) {
-            // use precalculated matrix
-            for (j = lo; j <= hi; j++) {
-                trans_sum += fwd_prev[j] * transition_matrix[j * hmm_states + s];
-            }
-        } else {
-            for (j = lo; j <= hi; j++) {
-                trans_sum += fwd_prev[j] * transition_weight(j, s, transprob, subbins);
-            }
-        }
-
-        // Voiced prior blended with unvoiced
-        // MYFLT voiced_prior = PYIN_VOICED_PROB;
-        // MYFLT emission = voiced_prior * obs[s]
-        //                + (1.0 - voiced_prior) * (p_unvoiced_obs / (MYFLT)hmm_states);
-        MYFLT emission = p_unvoiced_obs * (1.0f / hmm_states)   // unvoiced floor
-                           + (1.0 - p_unvoiced_obs) * obs[s];       // voiced component
-        fwd_cur[s] = trans_sum * emission;
-        norm += fwd_cur[s];
-    }
-
-    /* Normalise */
-    if (norm > 1e-30) {
-        for (s = 0; s < hmm_states; s++)
-            fwd_cur[s] /= norm;
-    } else {
-        /* No information: flat prior */
-        MYFLT flat = 1.0 / (MYFLT)hmm_states;
-        for (s = 0; s < hmm_states; s++)
-            fwd_cur[s] = flat;
-    }
-}
-
-/* -------------------------------------------------------------------------
- * Extract pitch estimate from forward variable.
- * Returns best state index, sets confidence and voicing flag.
- * ------------------------------------------------------------------------- */
-static int hmm_decode(MYFLT *fwd, MYFLT *conf, int *voiced, int hmmstates, MYFLT minconf)
-{
-    int best = 0;
-    MYFLT best_val = fwd[0];
-    int s;
-    for (s = 1; s < hmmstates; s++) {
-        if (fwd[s] > best_val) {
-            best_val = fwd[s];
-            best = s;
-        }
-    }
-
-    /* Confidence = posterior of best state + neighbours */
-    MYFLT c = best_val;
-    if (best > 0)
-        c += fwd[best - 1];
-    if (best < hmmstates - 1)
-        c += fwd[best + 1];
-    *conf = c;
-
-    /* Voiced if confidence exceeds a threshold */
-    *voiced = (c > minconf) ? 1 : 0;
+// kfreq, kconf, kvoiced pyinf0 asig, iminfreq=60, imaxfreq=1000, ibufsize=2048, ioverlap=4,
+//                              ktransprob=0.99, ibins=4, idrift=5
+//
+// A thin wrapper around pyinlib (see src/pitchtrack), the same engine used by pyin.
+// The original arguments are mapped onto a pyinlib config at init:
+//
+//   bufsize          -> frame size. fmin is raised if needed so that a frame
+//                       holds two periods (sr*2/fmin <= bufsize), as before
+//   overlap          -> hop = bufsize / overlap, rounded to a multiple of ksmps
+//   transprob        -> probability of staying voiced / unvoiced, so the
+//                       voiced<->unvoiced transition weight is 1 - transprob.
+//                       0 (the default) uses the pyinlib default
+//   bins             -> subdivisions per semitone of the HMM
+//   drift            -> max. pitch change between frames, in semitones. It
+//                       spans the ±4 sigma band of the transition model
+//
+// Since pyinlib's transition tables are computed once, ktransprob is only
+// read at init.
 
-    return best;
-}
+#define PYIN_DEFAULT_BINS     4
+#define PYIN_DRIFT_SEMITONES  5
 
 typedef struct {
     OPDS h;
@@ -7316,115 +7534,68 @@ typedef struct {
     MYFLT *ibufsize;
     MYFLT *ioverlap;
     MYFLT *trans_self;    // HMM self-transition probability
-    MYFLT *inumbins;         // bins per semitone
+    MYFLT *inumbins;      // bins per semitone
     MYFLT *drift;         // Drift in semitones, defaults to 5
+    MYFLT *ireserved;     // unused
 
     /* Internal state */
-    int bufsize;           // analysis window size (samples)
-    int hopsize;           // hop size (samples)
-    int taumin;            // minimum lag (samples) for min frequency
-    int taumax;            // maximum lag (samples) for max frequency
-    int bufpos;            // current write position in input ring buffer
-    int samples_since_hop; // samples since last hop
-    int hmmstates;
-    int subbins;
-    MYFLT transprob;        // fixed hmm transition probability
-
-    AUXCH aux_inputbuf;    // ring buffer for incoming audio
-    AUXCH aux_workbuf;     // linear analysis window extracted from ring buf
-    AUXCH aux_diff;        // YIN difference function (size = bufsize/2)
-    AUXCH aux_cmnd;        // cumulative mean normalized difference function
-    AUXCH aux_transition_matrix;
-
-    MYFLT thresholds[PYIN_N_THRESHOLDS];
-    MYFLT beta_weights[PYIN_N_THRESHOLDS];
-
-    MYFLT *hmm_fwd;
-    MYFLT *hmm_fwd_prev;
-
-    MYFLT hmm_buf1[PYIN_MAX_HMM_STATES];
-    MYFLT hmm_buf2[PYIN_MAX_HMM_STATES];
-
-    /* Per-frame pitch candidate storage */
-    MYFLT cand_freq[PYIN_MAX_CANDIDATES];
-    MYFLT cand_prob[PYIN_MAX_CANDIDATES];
-    int   n_cands;
-
+    PYINContext *ctx;
+    AUXCH aux_block;      // one cycle of input as float
 } PYIN_OPCODE;
 
 
+static int pyin_deinit(CSOUND *csound, PYIN_OPCODE *p)
+{
+    pyin_destroy(p->ctx);
+    p->ctx = NULL;
+    return OK;
+}
+
 static int pyin_init(CSOUND *csound, PYIN_OPCODE *p)
 {
     MYFLT sr = LOCAL_SR(p);
+    int ksmps = LOCAL_KSMPS(p);
+    PYINConfig cfg = pyin_config_default();
+    cfg.sample_rate = sr;
+    cfg.block_size = ksmps;
+
+    int bufsize = *p->ibufsize > 0 ? (int)*p->ibufsize : 2048;
+    int overlap = *p->ioverlap > 0 ? (int)*p->ioverlap : 4;
+    int hopsize = (bufsize / overlap) / ksmps * ksmps;
+    if(hopsize < ksmps)
+        hopsize = ksmps;
+    if(hopsize > bufsize)
+        return INITERRF("pyinf0: bufsize (%d) must be at least ksmps (%d)", bufsize, ksmps);
+    cfg.frame_size = bufsize;
+    cfg.hop_size = hopsize;
+
+    MYFLT minfreq = *p->iminfreq > 0 ? *p->iminfreq : 60.0;
+    MYFLT maxfreq = *p->imaxfreq > 0 ? *p->imaxfreq : 1000.0;
+    // a frame must hold two periods of the lowest frequency
+    MYFLT lowest = 2.0 * sr / bufsize * 1.001;
+    if(minfreq < lowest)
+        minfreq = lowest;
+    cfg.f0_min = minfreq;
+    cfg.f0_max = maxfreq;
 
-    p->bufsize = (p->ibufsize && *p->ibufsize > 0)
-                 ? (int)*p->ibufsize : 2048;
-    int overlap = (p->ioverlap && *p->ioverlap > 0)
-                  ? (int)*p->ioverlap : 4;
-    p->hopsize = p->bufsize / overlap;
-    if (p->hopsize < 1) p->hopsize = 1;
-
-    MYFLT minfreq = *p->iminfreq;
-    MYFLT maxfreq = *p->imaxfreq;
-    if (minfreq <= 0.0) minfreq = 60.0;
-    if (maxfreq <= 0.0) maxfreq = 1000.0;
-
-    p->taumin = (int)(sr / maxfreq);
-    p->taumax = (int)(sr / minfreq);
-    if (p->taumin < 1) p->taumin = 1;
-    if (p->taumax >= p->bufsize / 2) p->taumax = p->bufsize / 2 - 1;
-
-    // Initialize Auxch
-    auxinit(csound, &(p->aux_inputbuf), p->bufsize);
-    auxinit(csound, &(p->aux_workbuf), p->bufsize);
-    auxinit(csound, &(p->aux_diff), p->bufsize / 2 + 1);
-    auxinit(csound, &(p->aux_cmnd), p->bufsize / 2 + 1);
-
-    p->hmm_fwd = p->hmm_buf1;
-    p->hmm_fwd_prev = p->hmm_buf2;
-
-    p->bufpos = 0;
-    p->samples_since_hop = 0;
-    p->n_cands = 0;
     MYFLT transprob = *p->trans_self;
-    if(transprob == 0)
-        transprob = 0.99;
-    p->transprob = transprob;
-
-    int midirange = PYIN_MIDI_MAX - PYIN_MIDI_MIN + 1;
-    int numbins = (int)(*p->inumbins);
-    if(numbins == 0)
-        numbins = 4;
-    int hmmstates = midirange * numbins;
-    if(hmmstates > PYIN_MAX_HMM_STATES) {
-        numbins = PYIN_MAX_HMM_STATES / midirange;
-        hmmstates = numbins * midirange;
-    }
-    p->hmmstates = hmmstates;
-    p->subbins = numbins;
-    auxinit(csound, &(p->aux_transition_matrix), hmmstates*hmmstates);
-
-    // Initialise HMM prior: flat
-    MYFLT flat = 1.0 / (MYFLT)p->hmmstates;
-    for (int s = 0; s < p->hmmstates; s++)
-        p->hmm_fwd_prev[s] = flat;
+    if(transprob > 0 && transprob < 1)
+        cfg.voiced_transition_weight = 1.0 - transprob;
+    int numbins = (int)*p->inumbins;
+    cfg.cents_per_semitone = numbins > 0 ? numbins : PYIN_DEFAULT_BINS;
+    MYFLT drift = *p->drift > 0 ? *p->drift : PYIN_DRIFT_SEMITONES;
+    cfg.pitch_sigma_cents = drift * 100.0 / 4.0;
+
+    pyin_deinit(csound, p);
+    p->ctx = pyin_create(cfg, (allocfn_t)(csound->Calloc), (freefn_t)csound->Free, csound);
+    if(p->ctx == NULL)
+        return INITERRF("pyinf0: invalid parameters (minfreq=%g, maxfreq=%g, bufsize=%d)",
+                        minfreq, maxfreq, bufsize);
+    auxinit(csound, &(p->aux_block), ksmps * sizeof(float));
 
     *p->kpitch = 0.0;
     *p->kconf = 0.0;
     *p->kvoiced = 0.0;
-
-    precalculate_thresholds(p->beta_weights, p->thresholds);
-
-    // We precalculate the transition matrix. We still allow trans_self to change, which
-    // is incurs in a performance hit since we need to call transition_weight within
-    // an inner loop
-    MYFLT *trans_matrix = (MYFLT*)p->aux_transition_matrix.auxp;
-    for (int i = 0; i < hmmstates; i++) {
-        for (int j = 0; j < hmmstates; j++) {
-            trans_matrix[i * hmmstates + j] = transition_weight(i, j, transprob, numbins);
-        }
-    }
-
     return OK;
 }
 
@@ -7432,79 +7603,17 @@ static int pyin_perf(CSOUND *csound, PYIN_OPCODE *p)
 {
     int ksmps = LOCAL_KSMPS(p);
     MYFLT *in = p->asig;
-    MYFLT *input_buf = (MYFLT*)p->aux_inputbuf.auxp;
-    int bufsize = p->bufsize;
-    int bufpos = p->bufpos;
-    int samples_to_end = bufsize - bufpos;
-
-    if (ksmps <= samples_to_end) {
-        memcpy(input_buf + bufpos, in, ksmps * sizeof(MYFLT));
-        bufpos += ksmps;
-        if (bufpos == bufsize) bufpos = 0;
-    } else {
-        // split across wrap boundary
-        memcpy(input_buf + bufpos, in, samples_to_end * sizeof(MYFLT));
-        memcpy(input_buf, in + samples_to_end, (ksmps - samples_to_end) * sizeof(MYFLT));
-        bufpos = ksmps - samples_to_end;
-    }
-    p->bufpos = bufpos;
-    p->samples_since_hop += ksmps;
-    if(p->samples_since_hop < p->hopsize) {
-        return OK;
-    }
-
-    MYFLT a4 = csound->GetA4(csound);
-    int drift_semitones = *p->drift;
-    if(drift_semitones <= 0)
-        drift_semitones = PYIN_DRIFT_SEMITONES;
-
-    MYFLT sr = LOCAL_SR(p);
-    MYFLT trans_self = *p->trans_self;
-    MYFLT *transition_matrix = NULL;
-    if((trans_self == 0.) || (trans_self == p->transprob)) {
-        transition_matrix = p->aux_transition_matrix.auxp;
-    }
-
-    p->samples_since_hop -= p->hopsize;
+    float *block = (float *)p->aux_block.auxp;
+    for(int i = 0; i < ksmps; i++)
+        block[i] = (float)in[i];
 
-    // linearise ring buffer
-    MYFLT *work_buf = (MYFLT*)p->aux_workbuf.auxp;
-    samples_to_end = bufsize - bufpos;
-    memcpy(work_buf, input_buf + bufpos, samples_to_end * sizeof(MYFLT));
-    memcpy(work_buf + samples_to_end, input_buf, bufpos * sizeof(MYFLT));
-
-    // TODO: apply window here, compute it at init
-
-    MYFLT *cmnd = (MYFLT*)p->aux_cmnd.auxp;
-    compute_yin_cmnd(work_buf, (MYFLT*)p->aux_diff.auxp, cmnd, p->bufsize, p->taumax);
-
-    // get pitch canidates
-    p->n_cands = pyin_pitch_candidates(cmnd, p->taumin, p->taumax, sr,
-                                       p->cand_freq, p->cand_prob, PYIN_MAX_CANDIDATES,
-                                       p->beta_weights, p->thresholds);
-
-    hmm_forward_step(p->hmm_fwd_prev, p->hmm_fwd,
-                     p->cand_freq, p->cand_prob, p->n_cands,
-                     a4, trans_self, drift_semitones,
-                     p->hmmstates, p->subbins, transition_matrix);
-
-    MYFLT conf;
-    int voiced;
-    MYFLT minconf = 0.1;  // original: 0.05
-    // TODO: make it configurable. But since we return the confidence anyway, leave the parameter
-    // kvoiced for future use, maybe we can come up with something more clever than just applying
-    // a threshold
-    int best_state = hmm_decode(p->hmm_fwd, &conf, &voiced, p->hmmstates, minconf);
-
-    *p->kpitch = voiced ? state_to_freq(best_state, a4, p->subbins) : 0.0;
-    *p->kconf = conf;
-    *p->kvoiced = (MYFLT)voiced;
-
-    // swap buffers
-    MYFLT *tmp = p->hmm_fwd_prev;
-    p->hmm_fwd_prev = p->hmm_fwd;
-    p->hmm_fwd = tmp;
+    PYINResult res;
+    if(!pyin_process_block(p->ctx, block, &res))
+        return OK;
 
+    *p->kpitch = res.voiced ? res.pitch_hz : 0.0;
+    *p->kconf = res.confidence;
+    *p->kvoiced = (MYFLT)res.voiced;
     return OK;
 }
 
@@ -7550,8 +7659,8 @@ static OENTRY localops[] = {
 
     {"pwriten.k", S(PWRITE), 0, 3, "", "k*", (SUBR)pwriten_init, (SUBR)pwriten_perf, NULL, NULL},
 
-    {"uniqinstance.i", S(UNIQINSTANCE),   0, 1, "i", "io", (SUBR)uniqueinstance_i, NULL, NULL, NULL},
-    {"uniqinstance.S_i", S(UNIQINSTANCE), 0, 1, "i", "So", (SUBR)uniqueinstance_S_init, NULL, NULL, NULL},
+    {"uniqinstance.i", S(UNIQINSTANCE),   0, 1, "i", "ioj", (SUBR)uniqueinstance_i, NULL, NULL, NULL},
+    {"uniqinstance.S_i", S(UNIQINSTANCE), 0, 1, "i", "Soj", (SUBR)uniqueinstance_S_init, NULL, NULL, NULL},
 
     {"atstop.s1", S(SCHED_DEINIT), 0, 1, "", "Soj", (SUBR)atstop_s, NULL, NULL, NULL},
     {"atstop.s", S(SCHED_DEINIT),  0, 1, "", "Siim", (SUBR)atstop_s, NULL, NULL, NULL},
@@ -7742,16 +7851,16 @@ static OENTRY localops[] = {
     {"pwrite.k", S(PWRITE), 0, "", "i*", (SUBR)pwrite_initcommon, (SUBR)pwrite_perf, NULL, NULL, 0},
 
     {"pwriten.k", S(PWRITE), 0, "", "k*", (SUBR)pwriten_init, (SUBR)pwriten_perf, NULL, NULL, 0},
-    {"uniqinstance.i", S(UNIQINSTANCE),   0, "i", "io", (SUBR)uniqueinstance_i, NULL, NULL, NULL, 0},
-    {"uniqinstance.S_i", S(UNIQINSTANCE), 0, "i", "So", (SUBR)uniqueinstance_S_init, NULL, NULL, NULL, 0},
+    {"uniqinstance.i", S(UNIQINSTANCE),   0, "i", "ioj", (SUBR)uniqueinstance_i, NULL, NULL, NULL, 0},
+    {"uniqinstance.S_i", S(UNIQINSTANCE), 0, "i", "Soj", (SUBR)uniqueinstance_S_init, NULL, NULL, NULL, 0},
 
     {"atstop.s1", S(SCHED_DEINIT), 0, "", "Soj",  (SUBR)atstop_s, NULL, (SUBR)atstop_deinit, NULL, 0},
     {"atstop.s",  S(SCHED_DEINIT), 0, "", "Siim", (SUBR)atstop_s, NULL, (SUBR)atstop_deinit, NULL, 0},
     {"atstop.i1", S(SCHED_DEINIT), 0, "", "ioj",  (SUBR)atstop_i, NULL, (SUBR)atstop_deinit, NULL, 0},
     {"atstop.i",  S(SCHED_DEINIT), 0, "", "iiim", (SUBR)atstop_i, NULL, (SUBR)atstop_deinit, NULL, 0},
 
-    {"atstop.N", S(SCHED_DEINIT), 0, "", "iiiN", (SUBR)atstop_i, NULL, (SUBR)atstop_deinit_N, NULL, 0},
-    {"atstop.SN", S(SCHED_DEINIT), 0, "", "SiiN", (SUBR)atstop_s, NULL, (SUBR)atstop_deinit_N, NULL, 0},
+    {"atstop.N", S(SCHED_DEINIT), 0, "", "iiiN", (SUBR)atstop_i, NULL, (SUBR)atstop_deinit, NULL, 0},
+    {"atstop.SN", S(SCHED_DEINIT), 0, "", "SiiN", (SUBR)atstop_s, NULL, (SUBR)atstop_deinit, NULL, 0},
 
     {"atstop.k",  S(SCHED_DEINIT), 0, "", "iiiM", (SUBR)atstop_i, NULL, (SUBR)atstop_deinit, NULL, 0},
     {"atstop.Sk",  S(SCHED_DEINIT), 0, "", "SiiM", (SUBR)atstop_s, NULL, (SUBR)atstop_deinit, NULL, 0},
@@ -7897,7 +8006,7 @@ static OENTRY localops[] = {
     {"strmul.k", S(STRMUL), 0, "S", "Sko", (SUBR)strmul_init, (SUBR)strmul_perf, NULL, NULL, 0},
     {"strmul.i", S(STRMUL), 0, "S", "Sio", (SUBR)strmul_i, NULL, NULL, NULL, 0},
 
-    {"pyinf0", S(PYIN_OPCODE), 0, "kkk", "aiiooOOoo", (SUBR)pyin_init, (SUBR)pyin_perf, NULL, NULL, 0}
+    {"pyinf0", S(PYIN_OPCODE), 0, "kkk", "aiiooOOoo", (SUBR)pyin_init, (SUBR)pyin_perf, (SUBR)pyin_deinit, NULL, 0}
 
 };
 #endif
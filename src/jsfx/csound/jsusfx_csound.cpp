@@ -19,8 +19,13 @@
 
 #include <stdarg.h>
 #include <fstream>
+#include <sstream>
 #include <ctype.h>
 #include <limits>
+#include <map>
+#include <vector>
+#include <atomic>
+#include <sys/stat.h>
 
 // #include "OpcodeBase.hpp"
 #include "WDL/mutex.h"
@@ -36,7 +41,6 @@ using namespace std;
 
 // The maximum of signal inlet/outlet; PD seems to have a limitation to 18 inlets ...
 const int MAX_SIGNAL_PORT = 8;
-const int MAX_BUF_LEN = MAX_SIGNAL_PORT * 128;
 const int PATH_MAX_LEN = 1024;
 const int MAX_SLIDERS = 64;
 
@@ -47,15 +51,69 @@ typedef uint32_t jsfxid;
     csound->RegisterDeinitCallback(csound, p, (int32_t(*)(CSOUND*, void*))(func))
 #endif
 
+// modification time of a file, 0 if it does not exist
+static time_t file_mtime(const string &path) {
+    struct stat st;
+    if(stat(path.c_str(), &st) != 0)
+        return 0;
+    return st.st_mtime;
+}
+
+// a script (or imported file) as read from disk
+struct jsfx_source {
+    time_t mtime;
+    string text;
+};
+
 class JsusFxCsoundPath : public JsusFxPathLibrary_Basic {
     CSOUND *csound;
 
+    // text of every script / import read while compiling, keyed by path
+    map<string, jsfx_source> sources;
+
 public:
 
+    // while true, open() serves files from (and adds them to) the source cache
+    bool caching = false;
+
+    // files opened during the last compile, with the mtime they had
+    vector<pair<string, time_t>> opened;
+
     JsusFxCsoundPath(const char *_dataRoot, CSOUND *_csound) : JsusFxPathLibrary_Basic(_dataRoot) {
         csound = _csound;
     }
 
+    istream *open(const string &path) {
+        if(!caching) {
+            ifstream *stream = new ifstream(path);
+            if(!stream->is_open()) {
+                delete stream;
+                return nullptr;
+            }
+            return stream;
+        }
+        time_t mtime = file_mtime(path);
+        auto it = sources.find(path);
+        if(it == sources.end() || it->second.mtime != mtime) {
+            ifstream file(path);
+            if(!file.is_open())
+                return nullptr;
+            ostringstream text;
+            text << file.rdbuf();
+            jsfx_source &src = sources[path];
+            src.mtime = mtime;
+            src.text = text.str();
+            it = sources.find(path);
+        }
+        opened.push_back(make_pair(path, mtime));
+        return new istringstream(it->second.text);
+    }
+
+    void close(istream *&stream) {
+        delete stream;
+        stream = nullptr;
+    }
+
     bool resolveImportPath(const string &importPath, const string &parentPath, string &resolvedPath) {
         const size_t pos = parentPath.rfind('/', '\\');
         if ( pos != string::npos )
@@ -86,78 +144,169 @@ public:
 };
 
 static EEL_F NSEEL_CGEN_CALL midisend(void *opaque, INT_PTR np, EEL_F **parms);
+static EEL_F NSEEL_CGEN_CALL midirecv(void *opaque, INT_PTR np, EEL_F **parms);
 
 class JsusFxCsound : public JsusFx {
 public:
     static const int kMidiBufferSize = 4096;
+    static const uint32_t kMidiQueueSize = 1024;   // must be a power of 2
+    static const int kMaxMidiEventsPerBlock = 256;
+
+    struct MidiEvent {
+        uint32_t offset;  // in samples, from the beginning of the block
+        uint8_t size;
+        uint8_t data[3];
+    };
 
+    // MIDI input queue (multiple producers / single consumer, lock-free). Several
+    // instruments, maybe running in different threads (-j N), can push to the same
+    // instance: a producer claims a slot by advancing midiWrite and marks it as ready
+    // once written, the consumer stops at the first slot which is not ready yet
+    MidiEvent midiQueue[kMidiQueueSize];
+    std::atomic<uint8_t> midiReady[kMidiQueueSize];
+    std::atomic<uint32_t> midiWrite{0};
+    std::atomic<uint32_t> midiRead{0};
+    std::atomic<uint32_t> midiDropped{0};  // events lost because the queue was full
+    // offsets of queued events are given at the csound rate, the script runs
+    // at this multiple of it (see jsfx_oversampler)
+    uint32_t oversample = 1;
+
+    // the midi events of the block being processed, sorted by offset, read by the
+    // script via midirecv. The raw bytes are also kept in midiHead (jsusfx's own layout)
+    MidiEvent blockEvents[kMaxMidiEventsPerBlock];
+    int numBlockEvents = 0;
+    int nextBlockEvent = 0;
     uint8_t midiHead[kMidiBufferSize];
-    uint8_t midiPreStream[4];
-    int midiPre = 0, midiExpt = 0;
     uint8_t midiOutBuffer[kMidiBufferSize];
     int midiOutSize = 0;
     double scrapspace[128];
 
-    // this is used to indicate if dsp is on (and midi parsing should be done)
-    bool dspOn = 1;
     WDL_Mutex dspLock;
 
     JsusFxCsound(JsusFxPathLibrary &pathLibrary) : JsusFx(pathLibrary) {
+        for (auto &ready : midiReady)
+            ready.store(0, std::memory_order_relaxed);
         midi = &midiHead[0];
         NSEEL_addfunc_varparm("midisend",3,NSEEL_PProc_THIS,&midisend);
+        // jsusfx's midirecv reports every message at offset 0
+        NSEEL_addfunc_varparm("midirecv",3,NSEEL_PProc_THIS,&midirecv);
     }
 
     ~JsusFxCsound() {
     }
 
-    // we pre-stream the byte messages since it might come in between dsp cycles
-    void midiin(uint8_t b) {
-        // midi is read in the dsp thread. Do accumulate stuff if you don't read it
-        if ( ! dspOn )
-            return;
+    // value of every variable right after compiling, used by resetState
+    vector<pair<EEL_F*, EEL_F>> initialVars;
 
-        // in sysex stream, ignore everything
-        if ( midiExpt == -1) {
-            if ( b == 0xf0 ) {
-                midiExpt = 0;
-                return;
-            }
+    static int _snapshotCallback(const char *name, EEL_F *val, void *ctx) {
+        IGN(name);
+        ((JsusFxCsound *)ctx)->initialVars.push_back(make_pair(val, *val));
+        return 1;
+    }
+
+    // The value slider `id` takes when moved to `value`, computed as moveSlider does:
+    // mapped from 0-1 to the slider's range if normalized, then rounded to its step
+    float sliderValue(int id, MYFLT value, bool normalized) const {
+        const JsusFx_Slider &slider = sliders[id];
+        float fvalue = static_cast<float>(value);
+        if ( normalized )
+            fvalue = fvalue * (slider.max - slider.min) + slider.min;
+        if ( slider.inc != 0 ) {
+            int tmp = roundf(fvalue / slider.inc);
+            fvalue = slider.inc * tmp;
         }
+        return fvalue;
+    }
 
-        // nothing is expected; new midi message
-        if ( midiExpt == 0 ) {
-            if ((b & 0xf0) == 0xf0) {
-                midiExpt = -1;
-                return;
-            }
+    // Set the sliders whose bit is set in `mask` to values[id], which are already
+    // rounded (see sliderValue). moveSlider flags @slider, which runs only once, at
+    // the next call to process, however many sliders change
+    void setSliders(uint64_t mask, const MYFLT *values) {
+        for(int id=0; mask != 0; id++, mask >>= 1) {
+            if(mask & 1)
+                moveSlider(id, static_cast<float>(values[id]));
+        }
+    }
 
-            midiPre = 1;
-            midiPreStream[0] = b;
+    // Remember the state of a freshly compiled script
+    void snapshotState() {
+        initialVars.clear();
+        NSEEL_VM_enumallvars(m_vm, _snapshotCallback, this);
+    }
 
-            switch(b & 0xf0) {
-                case 0xc0:
-                case 0xd0:
-                    midiExpt = 2;
-                    break;
-                default:
-                    midiExpt = 3;
-            }
-            return;
-        }
+    // Bring an instance which has been running back to the state it had right
+    // after compiling, so that it can be reused instead of compiling the script
+    // again. prepare() must be called afterwards, which runs @init
+    void resetState() {
+        for(auto &var : initialVars)
+            *var.first = var.second;
+        NSEEL_VM_freeRAM(m_vm);
+        computeSlider = true;
+        flushMidi();
+        midiOutSize = 0;
+        for (auto &ready : midiReady)
+            ready.store(0, std::memory_order_relaxed);
+        midiRead.store(midiWrite.load());
+        midiDropped.store(0);
+    }
 
-        midiPreStream[midiPre++] = b;
-        if ( midiPre >= midiExpt) {
-            if ( midiSize + midiExpt >= kMidiBufferSize ) {
-                printf("jsfx: midi buffer full\n");
-                dspOn = false;
-                return;
+    // Queue a MIDI message (1 to 3 bytes) to be delivered at the given sample offset
+    // within the next block processed. Any number of threads may push events, only
+    // one thread may process. Returns false if the queue is full (the event is dropped)
+    bool midiin(const uint8_t *data, int size, uint32_t offset) {
+        uint32_t write = midiWrite.load(std::memory_order_relaxed);
+        do {
+            if (write - midiRead.load(std::memory_order_acquire) >= kMidiQueueSize) {
+                midiDropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
             }
+        } while (!midiWrite.compare_exchange_weak(write, write + 1, std::memory_order_relaxed));
+        const uint32_t slot = write & (kMidiQueueSize - 1);
+        MidiEvent &ev = midiQueue[slot];
+        ev.offset = offset;
+        ev.size = static_cast<uint8_t>(size);
+        for (int i=0; i < size; i++)
+            ev.data[i] = data[i];
+        midiReady[slot].store(1, std::memory_order_release);
+        return true;
+    }
 
-            for(int i=0;i<midiExpt;i++) {
-                // midi[midiSize++] = midiPreStream[i];
+    // Process a block of audio. Queued MIDI events are delivered, as in REAPER, in the
+    // @block section of this block, each with its offset: midirecv returns it in its
+    // first argument so that the script can act on it at the right sample in @sample
+    void run(const MYFLT **ins, MYFLT **outs, int nsmps, int numins, int numouts) {
+        flushMidi();
+        const uint32_t read = midiRead.load(std::memory_order_relaxed);
+        const uint32_t write = midiWrite.load(std::memory_order_acquire);
+        if (read != write) {
+            // take the pending events, sorted by offset (insertion sort keeps the
+            // order of events with the same offset)
+            uint32_t pos = read;
+            for (; pos != write && numBlockEvents < kMaxMidiEventsPerBlock; pos++) {
+                // a slot claimed by a producer which has not finished writing it
+                // yet: it and the following ones are delivered in the next block
+                const uint32_t slot = pos & (kMidiQueueSize - 1);
+                if (!midiReady[slot].load(std::memory_order_acquire))
+                    break;
+                MidiEvent ev = midiQueue[slot];
+                midiReady[slot].store(0, std::memory_order_relaxed);
+                ev.offset *= oversample;
+                if (ev.offset >= static_cast<uint32_t>(nsmps))
+                    ev.offset = nsmps - 1;
+                int j = numBlockEvents++;
+                while (j > 0 && blockEvents[j-1].offset > ev.offset) {
+                    blockEvents[j] = blockEvents[j-1];
+                    j--;
+                }
+                blockEvents[j] = ev;
             }
-            midiExpt = 0;
+            midiRead.store(pos, std::memory_order_release);
+            for (int ev=0; ev < numBlockEvents; ev++)
+                for (int i=0; i < blockEvents[ev].size; i++)
+                    midiHead[midiSize++] = blockEvents[ev].data[i];
         }
+        process_(ins, outs, nsmps, numins, numouts);
+        flushMidi();
     }
 
     void displayMsg(const char *fmt, ...) {
@@ -183,6 +332,17 @@ public:
     void flushMidi() {
         midi = &midiHead[0];
         midiSize = 0;
+        numBlockEvents = 0;
+        nextBlockEvent = 0;
+    }
+
+private:
+    inline void process_(const MYFLT **ins, MYFLT **outs, int nsmps, int numins, int numouts) {
+#ifdef USE_DOUBLE
+        process64(ins, outs, nsmps, numins, numouts);
+#else
+        process(ins, outs, nsmps, numins, numouts);
+#endif
     }
 };
 
@@ -206,6 +366,30 @@ static EEL_F NSEEL_CGEN_CALL midisend(void *opaque, INT_PTR np, EEL_F **parms) {
     return 0;
 }
 
+// midirecv(offset, msg1, msg23) or midirecv(offset, msg1, msg2, msg3)
+// Returns 0 when there are no more events in this block
+static EEL_F NSEEL_CGEN_CALL midirecv(void *opaque, INT_PTR np, EEL_F **parms) {
+    JsusFxCsound *ctx = REAPER_GET_INTERFACE(opaque);
+    if ( ctx->nextBlockEvent >= ctx->numBlockEvents )
+        return 0;
+    const JsusFxCsound::MidiEvent &ev = ctx->blockEvents[ctx->nextBlockEvent++];
+    // keep jsusfx's view of the buffer in sync
+    ctx->midi += ev.size;
+    ctx->midiSize -= ev.size;
+
+    const int msg2 = ev.size > 1 ? ev.data[1] : 0;
+    const int msg3 = ev.size > 2 ? ev.data[2] : 0;
+    *parms[0] = ev.offset;
+    *parms[1] = ev.data[0];
+    if ( np >= 4 ) {
+        *parms[2] = msg2;
+        *parms[3] = msg3;
+    } else {
+        *parms[2] = msg2 + msg3 * 256;
+    }
+    return 1;
+}
+
 
 /*
  * jsfx
@@ -223,37 +407,340 @@ static EEL_F NSEEL_CGEN_CALL midisend(void *opaque, INT_PTR np, EEL_F **parms) {
  * ihandle, aout1, ... jsfx "path", ain1, ... [, kid0, kparam0, ...]
  */
 
-// todo: MIDI
+/*
+ * Oversampling
+ *
+ * A handler created with an oversampling factor of 2, 4 or 8 runs its script at
+ * factor * sr: the script sees the oversampled srate and samplesblock. The input
+ * is upsampled and the output decimated by a cascade of 2x stages, each a
+ * half-band FIR in polyphase form. Half of the taps of a half-band filter are
+ * zero and the rest are symmetric, so one branch of each stage is a pure delay
+ * and the other a symmetric FIR of 2M taps, computed with M multiplications per
+ * output. The FIR is computed for the whole block one tap at a time, which makes
+ * the inner loops straight multiply-adds over contiguous samples that the
+ * compiler vectorizes.
+ *
+ * The first stage, the only one whose transition band lies close to the nyquist
+ * of the input, has the longest filter. The latency of a stage of M taps per side,
+ * up and down, is 2M-1 samples at the rate of its input, so the total latency is
+ * a fraction of a sample if the stages beyond the first are included
+ */
+
+const int JSFX_MAX_OVERSAMPLE_STAGES = 3;
+
+// taps per side of the odd branch of each stage (the filter has 4M-1 taps)
+static const int halfband_taps[JSFX_MAX_OVERSAMPLE_STAGES] = {16, 7, 5};
+
+struct jsfx_halfband {
+    int M;
+    MYFLT coefs[16];   // first half of the odd branch, scaled for a gain of 2
+};
+
+struct jsfx_oversampler {
+    int factor;
+    int numstages;
+    int maxblock;      // max. number of samples per block at the csound rate
+    int numins, numouts;
+    double latency;    // in samples at the csound rate
+    jsfx_halfband stages[JSFX_MAX_OVERSAMPLE_STAGES];
+    // per channel and stage: history + block. Upsamplers: one buffer of 2M-1
+    // history, decimators: one of 2M-1 for the even samples and one of M for the odd
+    MYFLT *up[MAX_SIGNAL_PORT][JSFX_MAX_OVERSAMPLE_STAGES];
+    MYFLT *downeven[MAX_SIGNAL_PORT][JSFX_MAX_OVERSAMPLE_STAGES];
+    MYFLT *downodd[MAX_SIGNAL_PORT][JSFX_MAX_OVERSAMPLE_STAGES];
+    // the oversampled signal, processed by the script
+    MYFLT *ins[MAX_SIGNAL_PORT];
+    MYFLT *outs[MAX_SIGNAL_PORT];
+    // scratch, maxblock * factor samples each
+    MYFLT *tmp[2];
+    MYFLT *acc;
+};
+
+static double bessel_i0(double x) {
+    double sum = 1, term = 1;
+    for(int k=1; k < 50; k++) {
+        term *= (x / (2*k)) * (x / (2*k));
+        sum += term;
+        if(term < sum * 1e-16)
+            break;
+    }
+    return sum;
+}
+
+// Kaiser windowed half-band lowpass (cutoff at a quarter of the rate), ~90 dB
+static void halfband_design(jsfx_halfband *hb, int M) {
+    const double beta = 8.96;
+    const double norm = bessel_i0(beta);
+    double sum = 0;
+    hb->M = M;
+    // tap k of the odd branch sits at an odd distance j = 2M-1-2k from the center
+    for(int k=0; k < M; k++) {
+        const int j = 2*M - 1 - 2*k;
+        const double r = static_cast<double>(j) / (2*M);
+        const double w = bessel_i0(beta * sqrt(1 - r*r)) / norm;
+        const double h = sin(M_PI * j / 2) / (M_PI * j);
+        hb->coefs[k] = 2 * h * w;
+        sum += 2 * hb->coefs[k];
+    }
+    // the odd branch must have unity gain at DC, like the delay branch
+    for(int k=0; k < M; k++)
+        hb->coefs[k] /= sum;
+}
 
+// y[2i] = FIR of x, y[2i+1] = x delayed by M-1. buf holds 2M-1 samples of history
+// followed by room for n samples
+static void halfband_up(const jsfx_halfband *hb, MYFLT *buf, MYFLT *acc,
+                        const MYFLT *x, MYFLT *y, int n) {
+    const int M = hb->M, H = 2*M - 1;
+    memcpy(buf + H, x, sizeof(MYFLT) * n);
+    for(int i=0; i < n; i++)
+        acc[i] = 0;
+    for(int k=0; k < M; k++) {
+        const MYFLT c = hb->coefs[k];
+        const MYFLT *a = buf + H - k, *b = buf + k;
+        for(int i=0; i < n; i++)
+            acc[i] += c * (a[i] + b[i]);
+    }
+    const MYFLT *delayed = buf + M;
+    for(int i=0; i < n; i++) {
+        y[2*i] = acc[i];
+        y[2*i+1] = delayed[i];
+    }
+    memmove(buf, buf + n, sizeof(MYFLT) * H);
+}
+
+// x has 2n samples, y gets n. even holds 2M-1 samples of history, odd M
+static void halfband_down(const jsfx_halfband *hb, MYFLT *even, MYFLT *odd, MYFLT *acc,
+                          const MYFLT *x, MYFLT *y, int n) {
+    const int M = hb->M, H = 2*M - 1;
+    for(int i=0; i < n; i++) {
+        even[H+i] = x[2*i];
+        odd[M+i] = x[2*i+1];
+    }
+    for(int i=0; i < n; i++)
+        acc[i] = odd[i];
+    for(int k=0; k < M; k++) {
+        const MYFLT c = hb->coefs[k];
+        const MYFLT *a = even + H - k, *b = even + k;
+        for(int i=0; i < n; i++)
+            acc[i] += c * (a[i] + b[i]);
+    }
+    for(int i=0; i < n; i++)
+        y[i] = acc[i] * 0.5;
+    memmove(even, even + n, sizeof(MYFLT) * H);
+    memmove(odd, odd + n, sizeof(MYFLT) * M);
+}
+
+static int oversample_stages(int factor) {
+    switch(factor) {
+    case 2: return 1;
+    case 4: return 2;
+    case 8: return 3;
+    default: return 0;
+    }
+}
+
+static inline bool oversample_valid(int factor) {
+    return factor == 1 || oversample_stages(factor) > 0;
+}
+
+// Size in bytes of an oversampler and its buffers
+static size_t oversampler_size(int factor, int maxblock, int numins, int numouts) {
+    const int numstages = oversample_stages(factor);
+    size_t numsamples = 0;
+    for(int s=0; s < numstages; s++) {
+        const int M = halfband_taps[s], n = maxblock << s;
+        numsamples += (size_t)numins * (2*M - 1 + n);
+        numsamples += (size_t)numouts * (2*M - 1 + n + M + n);
+    }
+    numsamples += (size_t)(numins + numouts + 3) * maxblock * factor;
+    return sizeof(jsfx_oversampler) + sizeof(MYFLT) * numsamples;
+}
+
+// Initialize an oversampler in mem, which must hold oversampler_size(...) zeroed bytes
+static jsfx_oversampler *oversampler_init(char *mem, int factor, int maxblock,
+                                          int numins, int numouts) {
+    const int numstages = oversample_stages(factor);
+    jsfx_oversampler *os = (jsfx_oversampler *)mem;
+    MYFLT *p = (MYFLT *)(mem + sizeof(jsfx_oversampler));
+    os->factor = factor;
+    os->numstages = numstages;
+    os->maxblock = maxblock;
+    os->numins = numins;
+    os->numouts = numouts;
+    os->latency = 0;
+    for(int s=0; s < numstages; s++) {
+        const int M = halfband_taps[s], n = maxblock << s;
+        halfband_design(&os->stages[s], M);
+        os->latency += static_cast<double>(2*M - 1) / (1 << s);
+        for(int chan=0; chan < numins; chan++) {
+            os->up[chan][s] = p;
+            p += 2*M - 1 + n;
+        }
+        for(int chan=0; chan < numouts; chan++) {
+            os->downeven[chan][s] = p;
+            p += 2*M - 1 + n;
+            os->downodd[chan][s] = p;
+            p += M + n;
+        }
+    }
+    const int n = maxblock * factor;
+    for(int chan=0; chan < numins; chan++, p += n)
+        os->ins[chan] = p;
+    for(int chan=0; chan < numouts; chan++, p += n)
+        os->outs[chan] = p;
+    os->tmp[0] = p;
+    os->tmp[1] = p + n;
+    os->acc = p + 2*n;
+    return os;
+}
+
+// Upsample n samples of each input into os->ins
+static void oversampler_up(jsfx_oversampler *os, const MYFLT **ins, int numins, int n) {
+    for(int chan=0; chan < numins; chan++) {
+        const MYFLT *src = ins[chan];
+        for(int s=0; s < os->numstages; s++) {
+            MYFLT *dst = s == os->numstages - 1 ? os->ins[chan] : os->tmp[s & 1];
+            halfband_up(&os->stages[s], os->up[chan][s], os->acc, src, dst, n << s);
+            src = dst;
+        }
+    }
+}
+
+// Decimate os->outs into n samples of each output
+static void oversampler_down(jsfx_oversampler *os, MYFLT **outs, int numouts, int n) {
+    for(int chan=0; chan < numouts; chan++) {
+        const MYFLT *src = os->outs[chan];
+        for(int s=os->numstages - 1; s >= 0; s--) {
+            MYFLT *dst = s == 0 ? outs[chan] : os->tmp[s & 1];
+            halfband_down(&os->stages[s], os->downeven[chan][s], os->downodd[chan][s], os->acc,
+                          src, dst, n << s);
+            src = dst;
+        }
+    }
+}
+
+/*
+ * Reuse of released instances
+ *
+ * EEL2 code is compiled against the variables of one VM, so the jit code of
+ * a script can't be shared between running instances: N instances running at
+ * the same time compile the script N times, only sequential reuse is covered. What can be reused is an
+ * instance which is not running anymore: when a handler is destroyed its
+ * compiled script goes back to the cache entry of its path and the next
+ * handler for the same script resets its variables and memory instead of
+ * parsing and compiling again. Scripts are compiled from the source cache of
+ * the engine's path library, so each file is read once.
+ *
+ * An entry is valid as long as the script and all its imports keep the
+ * modification time they had when compiled
+ */
+
+// max. number of idle instances kept per script
+const size_t JSFX_CACHE_MAX_IDLE = 64;
+
+struct jsfx_script_entry {
+    // files which make the script (the script itself and its imports)
+    vector<pair<string, time_t>> files;
+    // compiled instances not in use
+    vector<JsusFxCsound*> idle;
+    uint32_t compiles;
+    uint32_t reuses;
+};
+
+/*
+ * A handler and everything it needs at performance time live in one allocation
+ * (see make_handler): the handler itself, followed by the buffers of the
+ * oversampler, if any, sized for the pins of the script. The script processes
+ * the csound buffers directly, so there are no intermediate buffers.
+ * Fields used every cycle come first
+ */
 struct jsfx_handler {
     jsfxid id;
-    JsusFxCsoundPath *path;
     JsusFxCsound *fx;
-    char scriptpath[PATH_MAX_LEN];
     bool bypass;
     bool user_bypass;
     int pinIn, pinOut;  // number of channels defined in the script
-    float inbuf[MAX_BUF_LEN];
-    float outbuf[MAX_BUF_LEN];
-    float *in_chanptrs[MAX_SIGNAL_PORT];
-    float *out_chanptrs[MAX_SIGNAL_PORT];
+    jsfx_oversampler *os;    // nullptr if oversample is 1, else placed after the handler
+    // slider changes staged during this cycle, applied by the next jsfx / jsfx_play
+    uint64_t pending_mask;
+    MYFLT pending[MAX_SLIDERS];
+    // a slider change smaller than its threshold is ignored (0: any change counts)
+    MYFLT thresholds[MAX_SLIDERS];
+    int oversample;          // 1, 2, 4 or 8
     int max_input_channels;
     int max_output_channels; // number of channels asked by the user
-    jsfx_handler *nxt;
+    JsusFxCsoundPath *path;
+    jsfx_script_entry *entry;  // cache entry of the script, if compiled
+    bool cache_hit;            // fx is a reused instance
+    char scriptpath[PATH_MAX_LEN];
+};
+
+/*
+ * Handle table
+ *
+ * Registered handlers live in a dense array of slots. A handle (jsfxid) packs the
+ * index of the slot in its lower JSFX_SLOT_BITS bits and the generation of the
+ * slot in the upper bits. The generation is incremented each time a slot is
+ * released, so a stale handle to a recycled slot is not found. Free slots form
+ * a list through `next_free`. A valid handle is never 0
+ */
+
+#define JSFX_SLOT_BITS 20
+#define JSFX_SLOT_MASK ((1u << JSFX_SLOT_BITS) - 1)
+#define JSFX_MAX_SLOTS (1u << JSFX_SLOT_BITS)
+#define JSFX_GENERATION_MASK ((1u << (32 - JSFX_SLOT_BITS)) - 1)
+#define JSFX_NO_SLOT 0xFFFFFFFFu
+
+struct jsfx_slot {
+    jsfx_handler *handler;   // nullptr if the slot is free
+    uint32_t generation;     // never 0
+    uint32_t next_free;
 };
 
 struct jsfx_globals {
-    // this keeps a count and assigns a new value to each instance
-    jsfxid id_count;
-    jsfx_handler *handlers_list;
+    jsfx_slot *slots;
+    uint32_t num_slots;      // slots in use or in the free list
+    uint32_t capacity;       // allocated slots
+    uint32_t free_head;      // first free slot, or JSFX_NO_SLOT
     CSOUND *csound;
+    // path library shared by all handlers, holds the source cache
+    JsusFxCsoundPath *path;
+    // compiled-script cache, keyed by resolved path
+    map<string, jsfx_script_entry> *scripts;
 };
 
+static bool script_entry_valid(const jsfx_script_entry *e) {
+    if(e->files.empty())
+        return false;
+    for(auto &f : e->files) {
+        if(file_mtime(f.first) != f.second)
+            return false;
+    }
+    return true;
+}
+
+static void script_entry_flush(jsfx_script_entry *e) {
+    for(JsusFxCsound *fx : e->idle)
+        delete fx;
+    e->idle.clear();
+    e->files.clear();
+}
 
 // this function must be called after unregistering the handler in the global list
 void destroy_handler(CSOUND *csound, jsfx_handler *handler) {
-    delete handler->fx;
-    delete handler->path;
+    jsfx_script_entry *e = handler->entry;
+    if(handler->fx != nullptr && handler->fx->midiDropped.load() > 0)
+        MSGF("jsfx: %s, %u MIDI events were dropped (queue full)\n",
+             handler->scriptpath, handler->fx->midiDropped.load());
+    if(handler->fx != nullptr) {
+        // give a working instance back to the cache, to be reused
+        if(e != nullptr && !handler->bypass && e->idle.size() < JSFX_CACHE_MAX_IDLE)
+            e->idle.push_back(handler->fx);
+        else
+            delete handler->fx;
+    }
+    // the oversampler, if any, is part of the same block
     csound->Free(csound, handler);
 }
 
@@ -269,9 +756,13 @@ static jsfx_globals* create_globals(CSOUND *csound) {
         return nullptr;
     };
     jsfx_globals *g = (jsfx_globals*)csound->QueryGlobalVariable(csound, JSFX_GLOBALS_VARNAME);
-    g->id_count = 0;
-    g->handlers_list = nullptr;
+    g->slots = nullptr;
+    g->num_slots = 0;
+    g->capacity = 0;
+    g->free_head = JSFX_NO_SLOT;
     g->csound = csound;
+    g->path = new JsusFxCsoundPath(string(".").c_str(), csound);
+    g->scripts = new map<string, jsfx_script_entry>();
     csound->RegisterResetCallback(csound, (void*)g, (int32_t(*)(CSOUND*, void*))destroy_globals);
     return g;
 }
@@ -285,13 +776,16 @@ static inline jsfx_globals* get_globals(CSOUND *csound) {
 
 // to be called at reset time
 void destroy_globals(CSOUND *csound, jsfx_globals *g) {
-    jsfx_handler *h = g->handlers_list;
-    jsfx_handler *nxt;
-    while(h != nullptr) {
-        nxt = h->nxt;
-        destroy_handler(csound, h);
-        h = nxt;
+    for(uint32_t i=0; i < g->num_slots; i++) {
+        if(g->slots[i].handler != nullptr)
+            destroy_handler(csound, g->slots[i].handler);
     }
+    if(g->slots != nullptr)
+        csound->Free(csound, g->slots);
+    for(auto &it : *g->scripts)
+        script_entry_flush(&it.second);
+    delete g->scripts;
+    delete g->path;
     csound->DestroyGlobalVariable(csound, JSFX_GLOBALS_VARNAME);
 }
 
@@ -317,6 +811,13 @@ void jsfx_handler_describe(CSOUND *csound, jsfx_handler *x) {
         else
             MSGF("    slider%d: %g %g (%g) %s [%g]\n", i, s->min, s->max, s->inc, s->desc, *(s->owner));
     }
+    if(x->os != nullptr)
+        MSGF("    oversampling: %dx (script srate: %d), latency: %.2f samples\n",
+             x->oversample, (int)*(x->fx->srate), x->os->latency);
+    if(x->entry != nullptr)
+        MSGF("    script cache: %s (compiled %u times, reused %u times)\n",
+             x->cache_hit ? "hit, reused compiled instance" : "miss, compiled",
+             x->entry->compiles, x->entry->reuses);
 }
 
 static int _dumpvarsCallback(const char *name, EEL_F *val, void *ctx) {
@@ -361,7 +862,6 @@ static int compile_handler(CSOUND *csound, int ksmps, jsfx_handler *x, char *new
     string filename = string(newFile);
     if ( newFile != NULL && newFile[0] != 0) {
         string result;
-        x->path->resolveDataPath(string(filename), result);
         // find if the file exists with the .jsfx suffix
         if ( ! x->path->resolveDataPath(string(filename), result) ) {
             // maybe it isn't specified, try with the .jsfx
@@ -376,24 +876,56 @@ static int compile_handler(CSOUND *csound, int ksmps, jsfx_handler *x, char *new
         if ( x->scriptpath[0] == 0 )
             return INITERR("compile_handler: no scriptfile");
     }
+    jsfx_globals *g = get_globals(csound);
+    jsfx_script_entry *e = &(*g->scripts)[string(x->scriptpath)];
+    if(!script_entry_valid(e))
+        script_entry_flush(e);
+
+    if(x->fx == nullptr && !e->idle.empty()) {
+        // reuse a compiled instance of this script
+        x->fx = e->idle.back();
+        e->idle.pop_back();
+        x->fx->resetState();
+        x->fx->oversample = x->oversample;
+        x->fx->prepare((int)_GetLocalSr(csound,p) * x->oversample, ksmps * x->oversample);
+        x->entry = e;
+        x->cache_hit = true;
+        x->bypass = false;
+        e->reuses++;
+        return OK;
+    }
+
+    if(x->fx == nullptr)
+        x->fx = new JsusFxCsound(*(x->path));
+    x->cache_hit = false;
     x->fx->dspLock.Enter();
-    if ( x->fx->compile(*(x->path), x->scriptpath, 0) ) {
+    x->path->opened.clear();
+    x->path->caching = true;
+    bool compiled = x->fx->compile(*(x->path), x->scriptpath, 0);
+    x->path->caching = false;
+    if ( compiled ) {
+        x->fx->snapshotState();
         // int srate = static_cast<int>(*(x->fx->srate));
         // int samplesblock = static_cast<int>(*(x->fx->samplesblock));
         // printf("srate: %d, samplesblock: %d, float srate: %f\n", srate, samplesblock, *x->fx->srate);
         // x->fx->prepare((int)csound->GetSr(csound), ksmps);
-        x->fx->prepare((int)_GetLocalSr(csound,p), ksmps);
+        x->fx->oversample = x->oversample;
+        x->fx->prepare((int)_GetLocalSr(csound,p) * x->oversample, ksmps * x->oversample);
         x->bypass = false;
+        e->files = x->path->opened;
+        e->compiles++;
+        x->entry = e;
     } else {
         MSG("***** compile failed, bypassing *****\n");
         x->bypass = true;
+        x->entry = nullptr;
     }
     x->fx->dspLock.Leave();
     return OK;
 }
 
 static inline int slider_check(CSOUND *csound, JsusFxCsound *fx, int id) {
-    if ( id > MAX_SLIDERS || id < 0 )
+    if ( id >= MAX_SLIDERS || id < 0 )
         return INITERRF(Str("slider %d out of range"), id);
     if ( ! fx->sliders[id].exists ) {
         return INITERRF(Str("slider %d not assigned for this effect"), id);
@@ -401,15 +933,63 @@ static inline int slider_check(CSOUND *csound, JsusFxCsound *fx, int id) {
     return OK;
 }
 
-static inline int slider_set(JsusFxCsound *fx, int id, MYFLT value) {
-    float fvalue = static_cast<float>(value);
-    if (id >= 0)
-        fx->moveSlider(id, fvalue, 0);
-    else
-        fx->moveSlider(-id, fvalue, 1);
+/*
+ * Slider changes are not passed to the script as they arrive: they are staged in
+ * the handler and applied all at once before the next block is processed, so
+ * @slider runs at most once per cycle however many sliders were modified.
+ * A negative id sets slider -id to a normalized value (0-1). The value is
+ * rounded to the slider's step before it is compared to the current value
+ */
+static inline int slider_stage(jsfx_handler *x, int id, MYFLT value) {
+    const bool normalized = id < 0;
+    if (normalized)
+        id = -id;
+    value = x->fx->sliderValue(id, value, normalized);
+    const uint64_t bit = (uint64_t)1 << id;
+    const MYFLT current = x->fx->sliders[id].getValue();
+    if (value == current || fabs(value - current) < x->thresholds[id]) {
+        // nothing to do, cancel any previous change within this cycle
+        x->pending_mask &= ~bit;
+        return OK;
+    }
+    x->pending[id] = value;
+    x->pending_mask |= bit;
     return OK;
 }
 
+// Apply the staged slider changes. Called with the dsp lock held
+static inline void sliders_apply(jsfx_handler *x) {
+    if (x->pending_mask == 0)
+        return;
+    x->fx->setSliders(x->pending_mask, x->pending);
+    x->pending_mask = 0;
+}
+
+// Process a block of audio at the csound rate, oversampling if needed. Called with
+// the dsp lock held. ins and outs may be the same buffers
+static void handler_run(jsfx_handler *x, const MYFLT **ins, MYFLT **outs, int nsmps,
+                        int numins, int numouts) {
+    jsfx_oversampler *os = x->os;
+    if(os == nullptr) {
+        x->fx->run(ins, outs, nsmps, numins, numouts);
+        return;
+    }
+    numins = min(numins, os->numins);
+    numouts = min(numouts, os->numouts);
+    const MYFLT *subins[MAX_SIGNAL_PORT];
+    MYFLT *subouts[MAX_SIGNAL_PORT];
+    for(int start=0; start < nsmps; start += os->maxblock) {
+        const int n = min(nsmps - start, os->maxblock);
+        for(int chan=0; chan < numins; chan++)
+            subins[chan] = ins[chan] + start;
+        for(int chan=0; chan < numouts; chan++)
+            subouts[chan] = outs[chan] + start;
+        oversampler_up(os, subins, numins, n);
+        x->fx->run((const MYFLT **)os->ins, os->outs, n * os->factor, numins, numouts);
+        oversampler_down(os, subouts, numouts, n);
+    }
+}
+
 /*
 static void jsusfx_midiout(t_jsusfx *x) {
     if ( x->fx->midiOutSize >= JsusFxPd::kMidiBufferSize ) {
@@ -434,6 +1014,8 @@ static void jsusfx_midiout(t_jsusfx *x) {
  *   Spath          : path to script. Relative to the same
  *   a1, [a2, ...]  : input audio channels.
  *   idx, kvalx     : set slider `idx` to value `kvalx` (at each k-cycle)
+ *   Sopt, ivalue   : option given as a pair, between the sliders. Options:
+ *                    "oversample": 1, 2, 4 or 8 (see jsfx_oversampler)
  *
  *
  *
@@ -451,9 +1033,9 @@ struct t_jsfx {
     // a pointer to the beginning of the input arguments of the opcode (starting with Spath)
     void **inargs;
 
-    // a pointer to the beginning of the input arguments corresponding to the sliders
-    // (after the audio args)
-    MYFLT **sliderargs;
+    // the input arguments corresponding to the sliders, as pairs (after the audio
+    // args, with any options left out)
+    MYFLT *sliderargs[128];
 
     // the number of sliders given as pairs (isliderid, kvalue)
     int num_sliders;
@@ -534,6 +1116,7 @@ int _get_num_audio_inputs(CSOUND *csound, t_jsfx *p) {
  *
  * Spath: the path to the script
  * ksmps: the block size (needed to initialize internal buffers)
+ * oversample: 1, 2, 4 or 8. The script runs at oversample * sr
  * inchans / outchans: the max. number of input / output channels. Can be -1 to use the
  *      values defined in the script itself
  *
@@ -542,18 +1125,23 @@ int _get_num_audio_inputs(CSOUND *csound, t_jsfx *p) {
  *
  */
 
-jsfx_handler *make_handler(CSOUND *csound, STRINGDAT *Spath, int ksmps, OPDS *p) {
+jsfx_handler *make_handler(CSOUND *csound, STRINGDAT *Spath, int ksmps, int oversample, OPDS *p) {
     jsfx_handler *x = (jsfx_handler*)(csound->Malloc(csound, sizeof(jsfx_handler)));
     int numins = MAX_SIGNAL_PORT;
     int numouts = MAX_SIGNAL_PORT;
-    printf("//////////////////// 1\n");
     x->id = 0;
-    x->path = new JsusFxCsoundPath(string(".").c_str(), csound);
-    x->fx = new JsusFxCsound(*(x->path));
+    x->path = get_globals(csound)->path;
+    x->fx = nullptr;
+    x->entry = nullptr;
+    x->cache_hit = false;
+    x->pending_mask = 0;
+    for(int i=0; i < MAX_SLIDERS; i++)
+        x->thresholds[i] = 0;
     x->scriptpath[0] = 0;
     x->bypass = true;
     x->user_bypass = false;
-    x->nxt = nullptr;
+    x->oversample = oversample;
+    x->os = nullptr;
 
     // default number of input / output channels
     x->pinIn = 2;
@@ -598,66 +1186,91 @@ jsfx_handler *make_handler(CSOUND *csound, STRINGDAT *Spath, int ksmps, OPDS *p)
     if ( x->pinOut < 0 )
         x->pinOut = 0;
 
+    if(oversample > 1) {
+        // the pins are known now: grow the handler to hold the oversampler. Nothing
+        // points to the handler yet, so it can move
+        // a local ksmps is never larger than the global one
+        const int maxblock = max(ksmps, csound->GetKsmps(csound));
+        const size_t offset = (sizeof(jsfx_handler) + 63) & ~size_t(63);
+        const size_t size = oversampler_size(oversample, maxblock, x->pinIn, x->pinOut);
+        x = (jsfx_handler*)csound->ReAlloc(csound, x, offset + size);
+        memset((char*)x + offset, 0, size);
+        x->os = oversampler_init((char*)x + offset, oversample, maxblock, x->pinIn, x->pinOut);
+    }
+
     jsfx_handler_describe(csound, x);
 
     return x;
 }
 
+static inline jsfxid handle_make(uint32_t slot, uint32_t generation) {
+    return (generation << JSFX_SLOT_BITS) | slot;
+}
+
 /*
- * Add this handler to the global list of handlers, set its id
+ * Add this handler to the handle table, set its id
  * so it can be found later
  */
 static int register_handler(CSOUND *csound, jsfx_handler *handler) {
     if(handler->id != 0)
         return INITERRF("handler was already registered with id: %u", handler->id);
-    if(handler->nxt != nullptr)
-        return INITERR("handler was already part of the list");
-    jsfx_globals *globals = get_globals(csound);
-    handler->id = ++(globals->id_count);
-    if(handler->id <= 0)
-        return INITERRF("register_handler: could not assign an id, got %u", handler->id);
-    // prepend handler
-    jsfx_handler *h = globals->handlers_list;
-    globals->handlers_list = handler;
-    handler->nxt = h;
+    jsfx_globals *g = get_globals(csound);
+    uint32_t slot;
+    if(g->free_head != JSFX_NO_SLOT) {
+        slot = g->free_head;
+        g->free_head = g->slots[slot].next_free;
+    } else {
+        if(g->num_slots == JSFX_MAX_SLOTS)
+            return INITERRF("register_handler: too many jsfx instances (max. %u)", JSFX_MAX_SLOTS);
+        if(g->num_slots == g->capacity) {
+            uint32_t capacity = g->capacity == 0 ? 64 : g->capacity * 2;
+            if(capacity > JSFX_MAX_SLOTS)
+                capacity = JSFX_MAX_SLOTS;
+            g->slots = (jsfx_slot*)csound->ReAlloc(csound, g->slots, sizeof(jsfx_slot) * capacity);
+            g->capacity = capacity;
+        }
+        slot = g->num_slots++;
+        g->slots[slot].generation = 1;
+    }
+    g->slots[slot].handler = handler;
+    g->slots[slot].next_free = JSFX_NO_SLOT;
+    handler->id = handle_make(slot, g->slots[slot].generation);
     return OK;
 }
 
+static inline jsfx_slot *find_slot(jsfx_globals *g, jsfxid id) {
+    uint32_t slot = id & JSFX_SLOT_MASK;
+    if(id == 0 || slot >= g->num_slots)
+        return nullptr;
+    jsfx_slot *s = &(g->slots[slot]);
+    if(s->handler == nullptr || s->generation != (id >> JSFX_SLOT_BITS))
+        return nullptr;
+    return s;
+}
+
 jsfx_handler *find_handler(jsfx_globals *g, jsfxid id) {
-    jsfx_handler *h = g->handlers_list;
-    while(h != nullptr) {
-        if(h->id == id)
-            return h;
-        h = h->nxt;
-    }
-    return nullptr;
+    jsfx_slot *s = find_slot(g, id);
+    return s != nullptr ? s->handler : nullptr;
 }
 
-/* Remove handler with given id from the global list.
+/* Remove handler with given id from the handle table.
  * Return the found handler, probably to be freed.
  */
 jsfx_handler *unregister_handler(CSOUND *csound, jsfxid id) {
-    jsfx_globals *globals = get_globals(csound);
-    jsfx_handler *h = globals->handlers_list;
-    jsfx_handler *prev = nullptr;
-    if(h->id == id) {
-        // the first one
-        jsfx_handler *tmp = h;
-        globals->handlers_list = nullptr;
-        return tmp;
-    }
-    h = h->nxt;
-    while(h != nullptr) {
-        if(h->id == id) {
-            // found it!
-            if(prev != nullptr)
-                prev->nxt = h->nxt;
-            return h;
-        }
-        prev = h;
-        h = h->nxt;
-    }
-    return nullptr;  // not found!
+    jsfx_globals *g = get_globals(csound);
+    jsfx_slot *s = find_slot(g, id);
+    if(s == nullptr)
+        return nullptr;  // not found!
+    jsfx_handler *h = s->handler;
+    s->handler = nullptr;
+    // invalidate all handles to this slot before it is recycled
+    s->generation = (s->generation + 1) & JSFX_GENERATION_MASK;
+    if(s->generation == 0)
+        s->generation = 1;
+    s->next_free = g->free_head;
+    g->free_head = (uint32_t)(s - g->slots);
+    h->id = 0;
+    return h;
 }
 
 static int32_t jsfx_opcode_deinit(CSOUND *csound, t_jsfx *p) {
@@ -685,11 +1298,27 @@ static int32_t jsfx_opcode_init(CSOUND *csound, t_jsfx *p) {
     int kparams = _GetInputArgCnt(csound, p) - inchans - 1;
     if(kparams % 2 != 0)
         return INITERRF("params should be even, got %d", kparams);
-    p->num_sliders = kparams / 2;
-    p->sliderargs = (MYFLT **)&(p->inargs[1 + inchans]);
+    // pairs starting with a string are options, the rest set sliders
+    void **pairs = &(p->inargs[1 + inchans]);
+    int oversample = 1;
+    p->num_sliders = 0;
+    for(int i=0; i < kparams; i += 2) {
+        if(_GetTypeForArg(csound, pairs[i])->varTypeName[0] != 'S') {
+            p->sliderargs[p->num_sliders*2] = (MYFLT *)pairs[i];
+            p->sliderargs[p->num_sliders*2+1] = (MYFLT *)pairs[i+1];
+            p->num_sliders++;
+            continue;
+        }
+        STRINGDAT *key = (STRINGDAT *)pairs[i];
+        if(strcmp(key->data, "oversample") != 0)
+            return INITERRF("jsfx: unknown option '%s'", key->data);
+        oversample = static_cast<int>(*(MYFLT *)pairs[i+1]);
+        if(!oversample_valid(oversample))
+            return INITERRF("jsfx: oversample should be 1, 2, 4 or 8, got %d", oversample);
+    }
     STRINGDAT *Spath = (STRINGDAT *)p->inargs[0];
     int ksmps = p->h.insdshead->ksmps;
-    p->handler = make_handler(csound, Spath, ksmps, (OPDS*)p);
+    p->handler = make_handler(csound, Spath, ksmps, oversample, (OPDS*)p);
     if(p->handler == nullptr)
         return INITERRF("jsfx_init: Could not make handler for script %s", Spath->data);
     for(int paramidx=0; paramidx < p->num_sliders; paramidx++) {
@@ -714,7 +1343,7 @@ static int32_t jsfx_opcode_init(CSOUND *csound, t_jsfx *p) {
     for(int chan=0; chan < numouts; chan++)
         p->outchans[chan] = (MYFLT *)(p->args[chan]);
     for(int i=0; i < 64; i++)
-        p->slidervalues[i] = 0;
+        p->slidervalues[i] = std::numeric_limits<MYFLT>::quiet_NaN();
 #ifdef CSOUNDAPI6
     register_deinit(csound, p, jsfx_opcode_deinit);
 #endif
@@ -750,23 +1379,18 @@ static int32_t jsfx_opcode_perf(CSOUND *csound, t_jsfx *p) {
     }
 
     // set sliders. each slider is a pair of args ksliderid, kslidervalue
-    JsusFxCsound *fx = x->fx;
     for(int paramidx=0; paramidx < p->num_sliders; paramidx++) {
         int paramid = static_cast<int>(*p->sliderargs[paramidx*2]);
         MYFLT paramvalue = *p->sliderargs[paramidx*2+1];
         if(p->slidervalues[paramid] != paramvalue) {
-            slider_set(fx, paramid, paramvalue);
+            slider_stage(x, paramid, paramvalue);
             p->slidervalues[paramid] = paramvalue;
         }
     }
+    sliders_apply(x);
 
-#ifdef USE_DOUBLE
-    x->fx->process64((const MYFLT **)p->inchans, p->outchans, nsmps,
-                     p->processed_inputs, p->processed_outputs);
-#else
-    x->fx->process((const MYFLT **)p->inchans, p->outchans, nsmps,
-                   p->processed_inputs, p->processed_outputs);
-#endif
+    handler_run(x, (const MYFLT **)p->inchans, p->outchans, nsmps,
+               p->processed_inputs, p->processed_outputs);
     x->fx->dspLock.Leave();
 
     // if ( x->fx->midiOutSize != 0 )
@@ -780,7 +1404,7 @@ static int32_t jsfx_opcode_perf(CSOUND *csound, t_jsfx *p) {
 /*
  * jsfx_new
  *
- *     ihandle jsfx_new "path_to_script"
+ *     ihandle jsfx_new "path_to_script" [, ioversample=1]
  *
  * This creates the instance and returns a handle which can be used by jsfx_setslider
  * to set slider values and jsfx_play to process a block of audio
@@ -796,12 +1420,16 @@ struct t_jsfx_new {
     MYFLT *ihandle;
 
     STRINGDAT *Spath;
+    MYFLT *ioversample;
 
     jsfx_handler *handler;
 };
 
 
 static int32_t jsfx_new_deinit(CSOUND *csound, t_jsfx_new *p) {
+    // init failed
+    if(p->handler == nullptr)
+        return OK;
     if(p->handler->id != 0) {
         jsfx_handler *h = unregister_handler(csound, p->handler->id);
         if(h == nullptr) {
@@ -818,9 +1446,17 @@ static int32_t jsfx_new_deinit(CSOUND *csound, t_jsfx_new *p) {
 static int32_t jsfx_new_init(CSOUND *csound, t_jsfx_new *p) {
     STRINGDAT *Spath = p->Spath;
     int ksmps = p->h.insdshead->ksmps;
-    jsfx_handler *handler = make_handler(csound, Spath, ksmps, (OPDS*)p);
-    if(NOTOK == register_handler(csound, handler))
+    int oversample = *p->ioversample == 0 ? 1 : static_cast<int>(*p->ioversample);
+    p->handler = nullptr;
+    if(!oversample_valid(oversample))
+        return INITERRF("jsfx_new: oversample should be 1, 2, 4 or 8, got %d", oversample);
+    jsfx_handler *handler = make_handler(csound, Spath, ksmps, oversample, (OPDS*)p);
+    if(handler == nullptr)
+        return INITERRF("jsfx_new: Could not make handler for script %s", Spath->data);
+    if(NOTOK == register_handler(csound, handler)) {
+        destroy_handler(csound, handler);
         return INITERR(Str("Could not register handler"));
+    }
     if(handler->id <= 0) {
         return INITERRF(Str("Error assigning handle id, got %u"), handler->id);
     }
@@ -927,6 +1563,8 @@ static int32_t jsfx_play_perf(CSOUND *csound, t_jsfx_play *p) {
         return OK;
     }
 
+    sliders_apply(x);
+
     int numins = p->processed_input_channels;
     int numouts = p->processed_output_channels;
 
@@ -936,15 +1574,255 @@ static int32_t jsfx_play_perf(CSOUND *csound, t_jsfx_play *p) {
     for(int chan=0; chan < numouts; chan++)
         outs[chan] = p->outs[chan];
 
-#ifdef USE_DOUBLE
-    x->fx->process64((const double **)ins, outs, nsmps, numins, numouts);
-#else
-    x->fx->process((const float **)ins, outs, nsmps, numins, numouts);
-#endif
+    handler_run(x, (const MYFLT **)ins, outs, nsmps, numins, numouts);
     x->fx->dspLock.Leave();
     return OK;
 }
 
+/*
+ * jsfx_chain
+ *
+ * aOut[] jsfx_chain iHandles[], aIn[] [, ithreads=0]
+ *
+ * Runs a chain of jsfx instances (created via jsfx_new) in series within one opcode:
+ * the output of each instance is the input of the next. Intermediate results are kept
+ * in two buffers used alternately, the first instance reads directly from aIn and the
+ * last one writes directly to aOut. An instance which is bypassed (or busy) passes its
+ * input through.
+ *
+ * If iHandles is a 2D array, each row is an independent chain (rows can be padded with 0)
+ * and the channels of aIn[] are split evenly between the chains: with 2 chains and 4 input
+ * channels chain 0 gets channels 0-1 and chain 1 gets channels 2-3. aOut[] holds the
+ * outputs of all chains, one after the other. The chains are processed in parallel by
+ * ithreads threads (including the performance thread). 0 uses one thread per chain.
+ *
+ * A handle can only be used by one chain
+ */
+
+#define JSFX_CHAIN_MAX_CHAINS 64
+#define JSFX_CHAIN_MAX_LENGTH 64
+
+struct jsfx_chain {
+    jsfx_handler *handlers[JSFX_CHAIN_MAX_LENGTH];
+    int length;
+    int inoffset, numins;    // channels of aIn[] fed to the chain
+    int outoffset, numouts;  // channels of aOut[] written by the chain
+    MYFLT *buf[2];           // intermediate buffers, MAX_SIGNAL_PORT channels each
+};
+
+struct t_jsfx_chain;
+
+struct jsfx_chain_worker {
+    t_jsfx_chain *p;
+    CSOUND *csound;
+    int index;               // the chains processed are index, index+numthreads, ...
+    void *thread;
+    void *start;
+    void *done;
+    volatile int quit;
+};
+
+struct t_jsfx_chain {
+    OPDS h;
+    ARRAYDAT *aOut;
+    ARRAYDAT *iHandles;
+    ARRAYDAT *aIn;
+    MYFLT *ithreads;
+
+    int numchains;
+    int numthreads;
+    jsfx_chain *chains;
+    jsfx_chain_worker *workers;
+    AUXCH chainsmem;
+    AUXCH bufmem;
+    AUXCH workersmem;
+};
+
+static void jsfx_chain_run(jsfx_chain *c, MYFLT *in, MYFLT *out, int nsmps) {
+    MYFLT *cur[MAX_SIGNAL_PORT], *dst[MAX_SIGNAL_PORT];
+    int curchans = c->numins;
+    int curbuf = -1;  // -1: cur is the input of the chain, 0/1: an intermediate buffer
+    bool written = false;
+    for(int chan=0; chan < curchans; chan++)
+        cur[chan] = in + chan * nsmps;
+    for(int i=0; i < c->length; i++) {
+        jsfx_handler *x = c->handlers[i];
+        if ( (x->bypass || x->user_bypass) || x->fx->dspLock.TryEnter() )
+            continue;
+        const bool last = i == c->length - 1;
+        const int numins = min(curchans, x->pinIn);
+        const int numouts = last ? c->numouts : x->pinOut;
+        const int dstbuf = curbuf == 0 ? 1 : 0;
+        MYFLT *base = last ? out : c->buf[dstbuf];
+        for(int chan=0; chan < numouts; chan++)
+            dst[chan] = base + chan * nsmps;
+        sliders_apply(x);
+        handler_run(x, (const MYFLT **)cur, dst, nsmps, numins, numouts);
+        x->fx->dspLock.Leave();
+        for(int chan=0; chan < numouts; chan++)
+            cur[chan] = dst[chan];
+        curchans = numouts;
+        curbuf = dstbuf;
+        written = last;
+    }
+    if(written)
+        return;
+    // the last instance did not run: pass through what we have
+    const int numchans = min(curchans, c->numouts);
+    for(int chan=0; chan < numchans; chan++)
+        memcpy(out + chan * nsmps, cur[chan], sizeof(MYFLT) * nsmps);
+    if(numchans < c->numouts)
+        memset(out + numchans * nsmps, 0, sizeof(MYFLT) * nsmps * (c->numouts - numchans));
+}
+
+// Process the chains assigned to the given thread
+static void jsfx_chain_process(t_jsfx_chain *p, int thread) {
+    const int nsmps = p->h.insdshead->ksmps;
+    for(int i=thread; i < p->numchains; i += p->numthreads) {
+        jsfx_chain *c = &(p->chains[i]);
+        jsfx_chain_run(c, p->aIn->data + c->inoffset * nsmps, p->aOut->data + c->outoffset * nsmps, nsmps);
+    }
+}
+
+static uintptr_t jsfx_chain_thread(void *data) {
+    jsfx_chain_worker *w = (jsfx_chain_worker *)data;
+    CSOUND *csound = w->csound;
+    while(true) {
+        csound->WaitThreadLockNoTimeout(w->start);
+        if(w->quit)
+            break;
+        jsfx_chain_process(w->p, w->index);
+        csound->NotifyThreadLock(w->done);
+    }
+    return 0;
+}
+
+static int32_t jsfx_chain_deinit(CSOUND *csound, t_jsfx_chain *p) {
+    for(int i=1; i < p->numthreads; i++) {
+        jsfx_chain_worker *w = &(p->workers[i]);
+        if(w->thread == nullptr)
+            continue;
+        w->quit = 1;
+        csound->NotifyThreadLock(w->start);
+        csound->JoinThread(w->thread);
+        csound->DestroyThreadLock(w->start);
+        csound->DestroyThreadLock(w->done);
+        w->thread = nullptr;
+    }
+    p->numthreads = 1;
+    return OK;
+}
+
+static int32_t jsfx_chain_init(CSOUND *csound, t_jsfx_chain *p) {
+    ARRAYDAT *handles = p->iHandles;
+    if(handles->dimensions != 1 && handles->dimensions != 2)
+        return INITERRF("iHandles should be a 1D or 2D array, got %d dimensions", handles->dimensions);
+    CHECKARR1D(p->aIn);
+    const int numchains = handles->dimensions == 1 ? 1 : handles->sizes[0];
+    const int length = handles->dimensions == 1 ? handles->sizes[0] : handles->sizes[1];
+    if(numchains < 1 || numchains > JSFX_CHAIN_MAX_CHAINS)
+        return INITERRF("number of chains should be between 1 and %d, got %d",
+                        JSFX_CHAIN_MAX_CHAINS, numchains);
+    if(length > JSFX_CHAIN_MAX_LENGTH)
+        return INITERRF("a chain can have at most %d instances, got %d", JSFX_CHAIN_MAX_LENGTH, length);
+    const int numinputs = p->aIn->sizes[0];
+    if(numinputs % numchains != 0)
+        return INITERRF("the %d input channels can't be split evenly between %d chains",
+                        numinputs, numchains);
+    const int chainins = numinputs / numchains;
+    if(chainins > MAX_SIGNAL_PORT)
+        return INITERRF("a chain can have at most %d input channels, got %d", MAX_SIGNAL_PORT, chainins);
+
+    const int ksmps = p->h.insdshead->ksmps;
+    csound->AuxAlloc(csound, sizeof(jsfx_chain) * numchains, &p->chainsmem);
+    csound->AuxAlloc(csound, sizeof(MYFLT) * 2 * MAX_SIGNAL_PORT * ksmps * numchains, &p->bufmem);
+    p->chains = (jsfx_chain *)p->chainsmem.auxp;
+    p->numchains = numchains;
+    p->numthreads = 1;
+    jsfx_globals *g = get_globals(csound);
+    int numouts = 0;
+    for(int i=0; i < numchains; i++) {
+        jsfx_chain *c = &(p->chains[i]);
+        c->length = 0;
+        for(int j=0; j < length; j++) {
+            MYFLT h = handles->data[i * length + j];
+            if(h == 0)
+                continue;  // padding
+            jsfxid id = static_cast<jsfxid>(h);
+            jsfx_handler *x = find_handler(g, id);
+            if(x == nullptr)
+                return INITERRF("handler not found (id=%u)", id);
+            for(int k=0; k < i; k++) {
+                for(int l=0; l < p->chains[k].length; l++) {
+                    if(p->chains[k].handlers[l] == x)
+                        return INITERRF("handle %u is used by chains %d and %d", id, k, i);
+                }
+            }
+            c->handlers[c->length++] = x;
+        }
+        c->inoffset = i * chainins;
+        c->numins = chainins;
+        c->outoffset = numouts;
+        c->numouts = c->length > 0 ? c->handlers[c->length - 1]->pinOut : chainins;
+        numouts += c->numouts;
+        MYFLT *buf = (MYFLT *)p->bufmem.auxp + i * 2 * MAX_SIGNAL_PORT * ksmps;
+        c->buf[0] = buf;
+        c->buf[1] = buf + MAX_SIGNAL_PORT * ksmps;
+    }
+    tabinit_compat(csound, p->aOut, numouts, &(p->h));
+
+    int numthreads = static_cast<int>(*p->ithreads);
+    if(numthreads <= 0 || numthreads > numchains)
+        numthreads = numchains;
+    csound->AuxAlloc(csound, sizeof(jsfx_chain_worker) * numthreads, &p->workersmem);
+    p->workers = (jsfx_chain_worker *)p->workersmem.auxp;
+    for(int i=1; i < numthreads; i++) {
+        jsfx_chain_worker *w = &(p->workers[i]);
+        w->p = p;
+        w->csound = csound;
+        w->index = i;
+        w->quit = 0;
+        w->start = csound->CreateThreadLock();
+        w->done = csound->CreateThreadLock();
+        w->thread = nullptr;
+        if(w->start != nullptr && w->done != nullptr) {
+            // thread locks are created in the notified state
+            csound->WaitThreadLock(w->start, 0);
+            csound->WaitThreadLock(w->done, 0);
+        }
+        if(w->start == nullptr || w->done == nullptr ||
+           (w->thread = csound->CreateThread(jsfx_chain_thread, (void *)w)) == nullptr) {
+            if(w->start != nullptr)
+                csound->DestroyThreadLock(w->start);
+            if(w->done != nullptr)
+                csound->DestroyThreadLock(w->done);
+            csound->Warning(csound, "jsfx_chain: could not start worker threads, "
+                            "running %d thread(s)", i);
+            p->numthreads = i;
+            break;
+        }
+        p->numthreads = i + 1;
+    }
+    if(p->numthreads != numthreads) {
+        // the chains are distributed by number of threads, so stop the workers
+        // started and run everything in the performance thread
+        jsfx_chain_deinit(csound, p);
+    }
+#ifdef CSOUNDAPI6
+    register_deinit(csound, p, jsfx_chain_deinit);
+#endif
+    return OK;
+}
+
+static int32_t jsfx_chain_perf(CSOUND *csound, t_jsfx_chain *p) {
+    for(int i=1; i < p->numthreads; i++)
+        csound->NotifyThreadLock(p->workers[i].start);
+    jsfx_chain_process(p, 0);
+    for(int i=1; i < p->numthreads; i++)
+        csound->WaitThreadLockNoTimeout(p->workers[i].done);
+    return OK;
+}
+
 /*
  * jsfx_dump ihandle, ktrig
  *
@@ -978,6 +1856,27 @@ static int32_t jsfx_dump_perf(CSOUND *csound, t_jsfx_dump *p) {
     return OK;
 }
 
+/*
+ * ilatency jsfx_latency ihandle
+ *
+ * The latency in samples (at the csound rate, can be fractional) added by the
+ * oversampling filters of the handler. 0 if the handler does not oversample
+ */
+
+struct t_jsfx_latency {
+    OPDS h;
+    MYFLT *ilatency;
+    MYFLT *ihandler;
+
+    jsfx_handler *handler;
+};
+
+static int32_t jsfx_latency_init(CSOUND *csound, t_jsfx_latency *p) {
+    ACQUIRE_HANDLER(*p->ihandler);
+    *p->ilatency = p->handler->os != nullptr ? p->handler->os->latency : 0;
+    return OK;
+}
+
 /*
  * kvalue jsfx_getslider ihandle, ksliderid
  *
@@ -1050,13 +1949,13 @@ static int32_t jsfx_setslider_perf(CSOUND *csound, t_jsfx_setslider *p) {
         if(p->last == value)
             return OK;
         p->last = value;
-        return slider_set(p->handler->fx, sliderid, value);
+        return slider_stage(p->handler, sliderid, value);
     } else {
         if(NOTOK == slider_check(csound, p->handler->fx, sliderid))
             return NOTOK;
         p->lastslider = sliderid;
         p->last = value;
-        return slider_set(p->handler->fx, sliderid, value);
+        return slider_stage(p->handler, sliderid, value);
     }
 }
 */
@@ -1085,26 +1984,179 @@ static int32_t jsfx_setslider_many_init(CSOUND *csound, t_jsfx_setslider_many *p
         int sliderid = (int)(*p->args[i*2]);
         if(NOTOK == slider_check(csound, fx, sliderid))
             return INITERRF("Could not initialize slider %d", sliderid);
-        p->lastvalue[sliderid] = FL_UNSET;
+        p->lastvalue[sliderid] = std::numeric_limits<MYFLT>::quiet_NaN();
         p->sliderids[i] = sliderid;
     }
     return OK;
 }
 
 static int32_t jsfx_setslider_many_perf(CSOUND *csound, t_jsfx_setslider_many *p) {
-    JsusFxCsound *fx = p->handler->fx;
+    jsfx_handler *x = p->handler;
     for(int i=0; i < p->numsliders; i++) {
         int sliderid = p->sliderids[i];
         MYFLT value = *p->args[i*2+1];
         if(p->lastvalue[sliderid] != value) {
             p->lastvalue[sliderid] = value;
-            slider_set(fx, sliderid, value);
+            slider_stage(x, sliderid, value);
         }
     }
     return OK;
 }
 
 
+/*
+ * jsfx_sliderthreshold ihandle, id0, ithresh0 [, id1, ithresh1, ...]
+ *
+ * Set a change threshold for the given sliders. A new value which differs from the
+ * current value of the slider by less than the threshold is ignored, so that
+ * float jitter in a control signal does not trigger a new @slider evaluation.
+ * A threshold of 0 (the default) lets any change through
+ */
+
+struct t_jsfx_sliderthreshold {
+    OPDS h;
+    MYFLT *ihandler;
+    MYFLT *args[128];
+
+    jsfx_handler *handler;
+};
+
+static int32_t jsfx_sliderthreshold_init(CSOUND *csound, t_jsfx_sliderthreshold *p) {
+    ACQUIRE_HANDLER(*p->ihandler);
+    int numargs = _GetInputArgCnt(csound, p) - 1;
+    if(numargs % 2 != 0)
+        return INITERRF("arguments should be pairs id, threshold (got %d)."
+                        " Signature: jsfx_sliderthreshold ihandle, id0, ithresh0, id1, ithresh1, ...",
+                        numargs);
+    for(int i=0; i < numargs / 2; i++) {
+        int sliderid = (int)(*p->args[i*2]);
+        MYFLT threshold = *p->args[i*2+1];
+        if(NOTOK == slider_check(csound, p->handler->fx, sliderid))
+            return NOTOK;
+        if(threshold < 0)
+            return INITERRF("threshold should be >= 0, got %g", threshold);
+        p->handler->thresholds[sliderid] = threshold;
+    }
+    return OK;
+}
+
+/*
+ * jsfx_midi ihandle, kstatus, kdata1, kdata2 [, koffset=0]
+ *
+ * Send a MIDI message to a jsfx instance. The message is sent at every k-cycle
+ * where kstatus > 0 (as returned, for example, by midiin), and is delivered to the
+ * script at sample koffset of the next block it processes. For messages with one
+ * data byte (program change, channel pressure) kdata2 is ignored
+ */
+
+struct t_jsfx_midi {
+    OPDS h;
+    MYFLT *ihandler;
+    MYFLT *kstatus;
+    MYFLT *kdata1;
+    MYFLT *kdata2;
+    MYFLT *koffset;
+
+    jsfx_handler *handler;
+};
+
+// Number of bytes of a channel message with the given status byte, 0 if not supported
+static inline int midi_message_size(uint8_t status) {
+    switch(status & 0xF0) {
+    case 0x80: case 0x90: case 0xA0: case 0xB0: case 0xE0:
+        return 3;
+    case 0xC0: case 0xD0:
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+static inline bool midi_push(jsfx_handler *x, MYFLT status, MYFLT data1, MYFLT data2, int offset) {
+    uint8_t msg[3];
+    msg[0] = static_cast<uint8_t>(status);
+    msg[1] = static_cast<uint8_t>(data1) & 0x7F;
+    msg[2] = static_cast<uint8_t>(data2) & 0x7F;
+    int size = midi_message_size(msg[0]);
+    if(size == 0)
+        return false;
+    return x->fx->midiin(msg, size, offset < 0 ? 0 : static_cast<uint32_t>(offset));
+}
+
+static int32_t jsfx_midi_init(CSOUND *csound, t_jsfx_midi *p) {
+    ACQUIRE_HANDLER(*p->ihandler);
+    return OK;
+}
+
+static int32_t jsfx_midi_perf(CSOUND *csound, t_jsfx_midi *p) {
+    IGN(csound);
+    if(*p->kstatus > 0)
+        midi_push(p->handler, *p->kstatus, *p->kdata1, *p->kdata2, static_cast<int>(*p->koffset));
+    return OK;
+}
+
+/*
+ * jsfx_midinote ihandle, inote, ivel [, ichan=1]
+ *
+ * Play a note on a jsfx instance for the duration of the event: a note-on is sent
+ * at the start of the event and a note-off at its end. With sample-accurate
+ * scheduling (--sample-accurate) both are delivered at the exact sample
+ */
+
+struct t_jsfx_midinote {
+    OPDS h;
+    MYFLT *ihandler;
+    MYFLT *inote;
+    MYFLT *ivel;
+    MYFLT *ichan;
+
+    jsfx_handler *handler;
+    jsfxid id;
+    int chan;
+    bool sounding;
+};
+
+// The jsfx instance may have been freed (and its slot recycled) since init,
+// the note-off is only sent if the handle is still valid
+static int32_t jsfx_midinote_deinit(CSOUND *csound, t_jsfx_midinote *p) {
+    // the event was turned off before reaching its end
+    if(p->sounding) {
+        jsfx_handler *handler = find_handler(get_globals(csound), p->id);
+        if(handler != nullptr)
+            midi_push(handler, 0x80 + p->chan, *p->inote, 0, 0);
+    }
+    p->sounding = false;
+    return OK;
+}
+
+static int32_t jsfx_midinote_init(CSOUND *csound, t_jsfx_midinote *p) {
+    ACQUIRE_HANDLER(*p->ihandler);
+    int chan = *p->ichan > 0 ? static_cast<int>(*p->ichan) : 1;
+    if(chan > 16)
+        return INITERRF("MIDI channel should be between 1 and 16, got %d", chan);
+    p->chan = chan - 1;
+    p->id = _id;
+    p->sounding = midi_push(p->handler, 0x90 + p->chan, *p->inote, *p->ivel,
+                            p->h.insdshead->ksmps_offset);
+#ifdef CSOUNDAPI6
+    register_deinit(csound, p, jsfx_midinote_deinit);
+#endif
+    return OK;
+}
+
+static int32_t jsfx_midinote_perf(CSOUND *csound, t_jsfx_midinote *p) {
+    // the event ends within this cycle
+    const int no_end = p->h.insdshead->ksmps_no_end;
+    if(p->sounding && no_end > 0) {
+        jsfx_handler *handler = find_handler(get_globals(csound), p->id);
+        if(handler != nullptr)
+            midi_push(handler, 0x80 + p->chan, *p->inote, 0, p->h.insdshead->ksmps - no_end);
+        p->sounding = false;
+    }
+    return OK;
+}
+
+
 /* tubeharmonics
  *
  * port of tubeharmonics.jsfx, to test efficiency
@@ -1437,6 +2489,872 @@ static int32_t tubeharmonics_mono_perf(CSOUND *csound, t_tubeharmonics_mono *p)
     p->ch0 = ch0;
     return OK;
 }
+
+/*
+ * Native ports of the liteon scripts in assets/
+ *
+ *   aL, aR butterworth24db   aL, aR, kmode, kfreq [, kres=0, kgaindb=0, klimiter=1]
+ *   aL, aR moog24db          aL, aR, kmode, kfreq [, kres=0, kdrive=0, kgaindb=0, klimiter=1, koversample=0]
+ *   aL, aR bassmanager       aL, aR, kfreq, kboostdb [, kdrive=0, kmuffle=0, kgaindb=0, khipass=0,
+ *                                                     klimiter=1, koversample=0, knarrow=0]
+ *   aL, aR presenceeq        aL, aR, kfreq, kboostdb [, kbw=0.2, kgaindb=0]
+ *   aL, aR np1136peaklimiter aL, aR, kthreshdb, kratio [, kattack=30, krelease=45, khpfreq=0,
+ *                                                       kgrlimitdb=-18, kmakeupdb=0, ktiltfreq=639,
+ *                                                       ktiltdb=0, kwet=100, klink=1, kclip=0]
+ *   aL, aR ringmodulator     aL, aR, kfreq [, kdiode=0, kfeedback=0, knonlin=10, kmix=100,
+ *                                            kgaindb=0, koversample=0]
+ *
+ * Parameters follow the sliders of each script, with the same units and ranges,
+ * except that frequencies are given in Hz instead of the 0-100 scale of the
+ * scripts, switches are 0/1 with 1 meaning "on", and the stereo / mono switch is
+ * left out (these always process a stereo pair).
+ *
+ * The code follows the scripts closely (including their quirks) so that both
+ * versions produce the same output, see examples/liteon-comparison.csd. The state
+ * of the two channels is kept in arrays of two and the per-sample code is written
+ * as a loop over the pair, which lets the compiler process both channels at once.
+ * Coefficients are recomputed only when a parameter changes, like the @slider
+ * section of the scripts, and parameters interpolated by a script in @block are
+ * interpolated in the same way here
+ */
+
+static const MYFLT liteon_mv = 0.97715996843424887;   // 2^(-0.2/6)
+
+// eel2 compares for equality with a tolerance
+static inline bool eel_eq(MYFLT a, MYFLT b) {
+    return fabs(a - b) < 0.00001;
+}
+
+static inline MYFLT liteon_clip(MYFLT x, MYFLT lim) {
+    return min(max(x, -lim), lim);
+}
+
+// true if any of the n parameters changed since the last call. last should start as NaN
+static inline bool liteon_params_changed(MYFLT **params, MYFLT *last, int n) {
+    bool changed = false;
+    for(int i=0; i < n; i++) {
+        if(*params[i] != last[i]) {
+            last[i] = *params[i];
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+/*
+ * The 2x "power series" oversampling used by several of the scripts: each sample is
+ * split in two, both halves go through the nonlinearity f(half, chan, x), are band-
+ * limited by a short FIR, joined again and restored by another FIR with gain fgain
+ */
+template<int N>
+struct liteon_os2x {
+    MYFLT ps2[N];
+    MYFLT bl1[2][N], bl2[2][N], bl3[2][N];
+    MYFLT o2[N];
+    MYFLT s1[N], s2[N], s3[N];
+};
+
+template<int N, typename F>
+static inline void liteon_os2x_process(liteon_os2x<N> &s, const MYFLT *in, MYFLT *out,
+                                       MYFLT fgain, F f) {
+    MYFLT x[2][N];
+    for(int c=0; c < N; c++) {
+        const MYFLT ps1 = 0.5*(in[c] + s.ps2[c]);
+        s.ps2[c] = 0.5*ps1;
+        x[0][c] = ps1;
+        x[1][c] = s.ps2[c];
+    }
+    for(int h=0; h < 2; h++) {
+        for(int c=0; c < N; c++) {
+            s.bl3[h][c] = s.bl2[h][c];
+            s.bl2[h][c] = s.bl1[h][c];
+            s.bl1[h][c] = f(h, c, x[h][c]);
+            x[h][c] = s.bl1[h][c]*0.52 + s.bl2[h][c]*0.54 + s.bl3[h][c]*-0.02;
+        }
+    }
+    for(int c=0; c < N; c++) {
+        const MYFLT o1 = 0.5*(x[0][c] + s.o2[c]);
+        s.o2[c] = 0.5*(x[1][c] + o1);
+        s.s3[c] = s.s2[c];
+        s.s2[c] = s.s1[c];
+        s.s1[c] = o1;
+        out[c] = (s.s1[c] + s.s2[c]*-0.75 + s.s3[c]*0.17)*fgain;
+    }
+}
+
+
+/*
+ * butterworth24db
+ *
+ * aL, aR butterworth24db aL, aR, kmode, kfreq [, kres=0, kgaindb=0, klimiter=1]
+ *
+ * kmode: 0 = lowpass (24 dB/oct), 1 = highpass (6 dB/oct)
+ * kres: 0-0.9, only used above 150 Hz. Below 300 Hz the output is always limited
+ */
+
+struct t_butterworth24db {
+    OPDS h;
+    MYFLT *outs[2];
+    MYFLT *ins[2];
+    MYFLT *kmode, *kfreq, *kres, *kgain, *klimiter;
+
+    MYFLT last[5];
+    MYFLT gain, coef0, coef1, coef2, coef3, outgain;
+    MYFLT h1[2], h2[2], h3[2], h4[2];
+};
+
+static int32_t butterworth24db_init(CSOUND *csound, t_butterworth24db *p) {
+    for(int i=0; i < 5; i++)
+        p->last[i] = std::numeric_limits<MYFLT>::quiet_NaN();
+    for(int c=0; c < 2; c++)
+        p->h1[c] = p->h2[c] = p->h3[c] = p->h4[c] = 0;
+    return OK;
+}
+
+static void butterworth24db_slider(CSOUND *csound, t_butterworth24db *p) {
+    const MYFLT fs = _GetLocalSr(csound, &(p->h));
+    const MYFLT pi = 22.0/7;   // sic
+    const MYFLT t0 = 4*fs*fs, t1 = 8*fs*fs, t2 = 2*fs, t3 = pi/fs;
+    const MYFLT cutoff = *p->kfreq;
+    const MYFLT wp = t2*tan(t3*cutoff);
+    const MYFLT q = cutoff > 150 ? (*p->kres*6)+1 : (0.1*6)+1;
+    MYFLT b1 = (0.765367/q)/wp;
+    const MYFLT b2 = 1/(wp*wp);
+    const MYFLT bd_tmp = t0*b2+1;
+    MYFLT bd = 1/(bd_tmp+t2*b1);
+    p->gain = bd;
+    p->coef2 = (2-t1*b2);
+    p->coef0 = p->coef2*bd;
+    p->coef1 = (bd_tmp-t2*b1)*bd;
+    b1 = (1.847759/q)/wp;
+    bd = 1/(bd_tmp+t2*b1);
+    p->gain *= bd;
+    p->coef2 *= bd;
+    p->coef3 = (bd_tmp-t2*b1)*bd;
+    p->outgain = pow(10, *p->kgain/20);
+}
+
+static int32_t butterworth24db_perf(CSOUND *csound, t_butterworth24db *p) {
+    if(liteon_params_changed(&(p->kmode), p->last, 5))
+        butterworth24db_slider(csound, p);
+    const int nsmps = p->h.insdshead->ksmps;
+    const bool highpass = *p->kmode == 1;
+    const bool autolimit = *p->kfreq < 300;
+    const bool limiter = *p->klimiter != 0;
+    const MYFLT gain = p->gain, coef0 = p->coef0, coef1 = p->coef1;
+    const MYFLT coef2 = p->coef2, coef3 = p->coef3, outgain = p->outgain;
+    MYFLT h1[2], h2[2], h3[2], h4[2];
+    for(int c=0; c < 2; c++) {
+        h1[c] = p->h1[c]; h2[c] = p->h2[c]; h3[c] = p->h3[c]; h4[c] = p->h4[c];
+    }
+    MYFLT *in0 = p->ins[0], *in1 = p->ins[1], *out0 = p->outs[0], *out1 = p->outs[1];
+    for(int n=0; n < nsmps; n++) {
+        const MYFLT input[2] = {in0[n], in1[n]};
+        MYFLT output[2];
+        for(int c=0; c < 2; c++) {
+            MYFLT out = input[c]*gain;
+            out -= h1[c]*coef0;
+            MYFLT new_hist = out-h2[c]*coef1;
+            out = new_hist+h1[c]*2;
+            out += h2[c];
+            h2[c] = h1[c];
+            h1[c] = new_hist;
+            out -= h3[c]*coef2;
+            new_hist = out-h4[c]*coef3;
+            out = new_hist+h3[c]*2;
+            out += h4[c];
+            h4[c] = h3[c];
+            h3[c] = new_hist;
+            if(highpass)
+                out = input[c]-out;
+            if(autolimit)
+                out = liteon_clip(out, liteon_mv);
+            out = out*outgain;
+            output[c] = limiter ? liteon_clip(out, liteon_mv) : out;
+        }
+        out0[n] = output[0];
+        out1[n] = output[1];
+    }
+    for(int c=0; c < 2; c++) {
+        p->h1[c] = h1[c]; p->h2[c] = h2[c]; p->h3[c] = h3[c]; p->h4[c] = h4[c];
+    }
+    return OK;
+}
+
+
+/*
+ * moog24db
+ *
+ * aL, aR moog24db aL, aR, kmode, kfreq [, kres=0, kdrive=0, kgaindb=0, klimiter=1, koversample=0]
+ *
+ * kmode: 0 = lowpass (24 dB/oct), 1 = highpass, 2 = bandpass (6 dB/oct)
+ * kres: 0-0.85, kdrive: 0-100 (%)
+ */
+
+struct t_moog24db {
+    OPDS h;
+    MYFLT *outs[2];
+    MYFLT *ins[2];
+    MYFLT *kmode, *kfreq, *kres, *kdrive, *kgain, *klimiter, *koversample;
+
+    MYFLT last[7];
+    MYFLT drive, outgain;
+    MYFLT tgt_k, tgt_p, tgt_r, src_k, src_p, src_r;
+    MYFLT y1[2], y2[2], y3[2], y4[2];
+    MYFLT oldx[2], oldy1[2], oldy2[2], oldy3[2];
+    liteon_os2x<2> os;
+};
+
+static int32_t moog24db_init(CSOUND *csound, t_moog24db *p) {
+    for(int i=0; i < 7; i++)
+        p->last[i] = std::numeric_limits<MYFLT>::quiet_NaN();
+    p->src_k = p->src_p = p->src_r = 0;
+    for(int c=0; c < 2; c++) {
+        p->y1[c] = p->y2[c] = p->y3[c] = p->y4[c] = 0;
+        p->oldx[c] = p->oldy1[c] = p->oldy2[c] = p->oldy3[c] = 0;
+    }
+    memset(&(p->os), 0, sizeof(p->os));
+    return OK;
+}
+
+static void moog24db_slider(CSOUND *csound, t_moog24db *p) {
+    const MYFLT fs = _GetLocalSr(csound, &(p->h));
+    p->drive = 1+*p->kdrive/100;
+    p->outgain = pow(10, *p->kgain/20);
+    const MYFLT f = 2 * *p->kfreq / fs;
+    p->tgt_k = 3.6*f-1.6*f*f-1;
+    p->tgt_p = (p->tgt_k+1)*0.5;
+    const MYFLT scale = pow(2.718281828459045, (1-p->tgt_p)*1.386249);
+    p->tgt_r = *p->kres*scale;
+}
+
+static inline MYFLT moog24db_drive(MYFLT x, MYFLT drive) {
+    return x*(fabs(x) + drive)/(x*x + (drive-1)*fabs(x) + 1)*(drive/1.2);
+}
+
+static int32_t moog24db_perf(CSOUND *csound, t_moog24db *p) {
+    if(liteon_params_changed(&(p->kmode), p->last, 7))
+        moog24db_slider(csound, p);
+    const int nsmps = p->h.insdshead->ksmps;
+    // @block
+    const MYFLT d_p = (p->tgt_p-p->src_p)/nsmps;
+    MYFLT tp = p->src_p;
+    p->src_p = p->tgt_p;
+    const MYFLT d_k = (p->tgt_k-p->src_k)/nsmps;
+    MYFLT tk = p->src_k;
+    p->src_k = p->tgt_k;
+    const MYFLT d_r = (p->tgt_r-p->src_r)/nsmps;
+    MYFLT tr = p->src_r;
+    p->src_r = p->tgt_r;
+
+    const int mode = static_cast<int>(*p->kmode);
+    const bool limiter = *p->klimiter != 0;
+    const bool oversample = *p->koversample != 0;
+    const MYFLT drive = p->drive, outgain = p->outgain;
+    MYFLT *in0 = p->ins[0], *in1 = p->ins[1], *out0 = p->outs[0], *out1 = p->outs[1];
+    MYFLT *y1 = p->y1, *y2 = p->y2, *y3 = p->y3, *y4 = p->y4;
+    MYFLT *oldx = p->oldx, *oldy1 = p->oldy1, *oldy2 = p->oldy2, *oldy3 = p->oldy3;
+    for(int n=0; n < nsmps; n++) {
+        tk += d_k;
+        tp += d_p;
+        tr += d_r;
+        const MYFLT in[2] = {in0[n], in1[n]};
+        MYFLT input[2], output[2];
+        if(drive > 1) {
+            if(oversample)
+                liteon_os2x_process<2>(p->os, in, input, 5,
+                                       [drive](int, int, MYFLT x) { return moog24db_drive(x, drive); });
+            else
+                for(int c=0; c < 2; c++)
+                    input[c] = moog24db_drive(in[c], drive);
+        } else {
+            input[0] = in[0];
+            input[1] = in[1];
+        }
+        for(int c=0; c < 2; c++) {
+            const MYFLT x = input[c]-tr*y4[c];
+            y1[c] = x*tp+oldx[c]*tp-tk*y1[c];
+            y2[c] = y1[c]*tp+oldy1[c]*tp-tk*y2[c];
+            y3[c] = y2[c]*tp+oldy2[c]*tp-tk*y3[c];
+            y4[c] = y3[c]*tp+oldy3[c]*tp-tk*y4[c];
+            oldx[c] = x;
+            oldy1[c] = y1[c];
+            oldy2[c] = y2[c];
+            oldy3[c] = y3[c];
+            MYFLT out = mode == 1 ? input[c]-y4[c] : mode == 2 ? 6*(y3[c]-y4[c]) : y4[c];
+            out = out*outgain;
+            output[c] = limiter ? liteon_clip(out+1e-30, liteon_mv) : out;
+        }
+        out0[n] = output[0];
+        out1[n] = output[1];
+    }
+    return OK;
+}
+
+
+/*
+ * bassmanager
+ *
+ * aL, aR bassmanager aL, aR, kfreq, kboostdb [, kdrive=0, kmuffle=0, kgaindb=0, khipass=0,
+ *                                              klimiter=1, koversample=0, knarrow=0]
+ *
+ * kfreq: 30-250 Hz, kboostdb: 0-24, kdrive, kmuffle: 0-100 (%)
+ * khipass: cutoff of the highpass in Hz, 0 = off. klimiter limits the output to ±0.98
+ */
+
+struct t_bassmanager {
+    OPDS h;
+    MYFLT *outs[2];
+    MYFLT *ins[2];
+    MYFLT *kfreq, *kboost, *kdrive, *kmuffle, *kgain, *khipass, *klimiter, *koversample, *knarrow;
+
+    MYFLT last[9];
+    MYFLT drv_k, outgain;
+    MYFLT s_a1, s_a2, s_b0, s_b1, s_b2;
+    MYFLT h_a1, h_a2, h_b0, h_b1;
+    MYFLT lp_a0, lp_a1, lp_b1;
+    MYFLT s_i1[2], s_i2[2], s_o1[2], s_o2[2];
+    MYFLT h_i1[2], h_i2[2], h_o1[2], h_o2[2];
+    MYFLT lp_output[2];
+    liteon_os2x<2> os;
+};
+
+static int32_t bassmanager_init(CSOUND *csound, t_bassmanager *p) {
+    for(int i=0; i < 9; i++)
+        p->last[i] = std::numeric_limits<MYFLT>::quiet_NaN();
+    for(int c=0; c < 2; c++) {
+        p->s_i1[c] = p->s_i2[c] = p->s_o1[c] = p->s_o2[c] = 0;
+        p->h_i1[c] = p->h_i2[c] = p->h_o1[c] = p->h_o2[c] = 0;
+        p->lp_output[c] = 0;
+    }
+    memset(&(p->os), 0, sizeof(p->os));
+    return OK;
+}
+
+static void bassmanager_slider(CSOUND *csound, t_bassmanager *p) {
+    const MYFLT sr = _GetLocalSr(csound, &(p->h));
+    const MYFLT S = *p->knarrow == 0 ? 0.3 : 1;
+    const MYFLT drive = 0+*p->kdrive/99-0.07;
+    p->drv_k = drive/(1-drive);
+    p->outgain = pow(10, *p->kgain/20);
+    if(*p->kboost > 0) {
+        const MYFLT A = pow(10, *p->kboost/20);
+        const MYFLT omega = (2*PI * *p->kfreq) / sr;
+        const MYFLT sn = sin(omega);
+        const MYFLT cs = cos(omega);
+        const MYFLT temp1 = A + 1.0;
+        const MYFLT temp2 = A - 1.0;
+        const MYFLT temp3 = temp1 * cs;
+        const MYFLT temp4 = temp2 * cs;
+        const MYFLT beta = sn * sqrt((A * A + 1.0) / S - temp2 * temp2);
+        const MYFLT s_a0 = 1.0 / (temp1 + temp4 + beta);
+        p->s_a1 = (-2.0 * (temp2 + temp3)) * s_a0;
+        p->s_a2 = (temp1 + temp4 - beta) * s_a0;
+        p->s_b0 = (A * (temp1 - temp4 + beta)) * s_a0;
+        p->s_b1 = (2.0 * A * (temp2 - temp3)) * s_a0;
+        p->s_b2 = (A * (temp1 - temp4 - beta)) * s_a0;
+    }
+    if(*p->khipass > 0) {
+        const MYFLT omega = (2*PI * *p->khipass) / sr;
+        const MYFLT sn = sin(omega);
+        const MYFLT cs = cos(omega);
+        const MYFLT alpha = sn / (2.0 * 1);
+        const MYFLT h_a0 = 1.0 / (1.0 + alpha);
+        p->h_a1 = (-2.0 * cs) * h_a0;
+        p->h_a2 = (1.0 - alpha) * h_a0;
+        p->h_b1 = -(1.0 + cs) * h_a0 * 1;
+        p->h_b0 = -p->h_b1 * 0.5;
+    }
+    if(*p->kmuffle > 0) {
+        const MYFLT muffle = 20000-(*p->kmuffle*100+9000);
+        const MYFLT lp_cut = 2*PI*muffle;
+        const MYFLT lp_n = 1/(lp_cut + 2*sr);
+        p->lp_b1 = (2*sr - lp_cut)*lp_n;
+        p->lp_a0 = p->lp_a1 = lp_cut*lp_n;
+    }
+}
+
+static int32_t bassmanager_perf(CSOUND *csound, t_bassmanager *p) {
+    if(liteon_params_changed(&(p->kfreq), p->last, 9))
+        bassmanager_slider(csound, p);
+    const int nsmps = p->h.insdshead->ksmps;
+    const bool boost = *p->kboost > 0, drive = *p->kdrive > 0;
+    const bool hipass = *p->khipass > 0, muffle = *p->kmuffle > 0;
+    const bool limiter = *p->klimiter != 0, oversample = *p->koversample != 0;
+    const MYFLT drv_k = p->drv_k, outgain = p->outgain;
+    const MYFLT s_a1 = p->s_a1, s_a2 = p->s_a2, s_b0 = p->s_b0, s_b1 = p->s_b1, s_b2 = p->s_b2;
+    const MYFLT h_a1 = p->h_a1, h_a2 = p->h_a2, h_b0 = p->h_b0, h_b1 = p->h_b1;
+    const MYFLT lp_a0 = p->lp_a0, lp_a1 = p->lp_a1, lp_b1 = p->lp_b1;
+    MYFLT *in0 = p->ins[0], *in1 = p->ins[1], *out0 = p->outs[0], *out1 = p->outs[1];
+    auto shaper = [drv_k](int, int, MYFLT x) { return (1+drv_k)*x/(1+drv_k*fabs(x)); };
+    for(int n=0; n < nsmps; n++) {
+        const MYFLT in[2] = {in0[n], in1[n]};
+        MYFLT s_output[2], drv_output[2], output[2];
+        if(boost) {
+            for(int c=0; c < 2; c++) {
+                s_output[c] = s_b0*in[c] + s_b1*p->s_i1[c] + s_b2*p->s_i2[c] - s_a1*p->s_o1[c] - s_a2*p->s_o2[c];
+                p->s_o2[c] = p->s_o1[c];
+                p->s_o1[c] = s_output[c];
+                p->s_i2[c] = p->s_i1[c];
+                p->s_i1[c] = in[c];
+            }
+        } else {
+            s_output[0] = in[0];
+            s_output[1] = in[1];
+        }
+        if(drive && oversample) {
+            liteon_os2x_process<2>(p->os, s_output, drv_output, 4.5, shaper);
+        } else {
+            for(int c=0; c < 2; c++)
+                drv_output[c] = drive ? shaper(0, c, s_output[c]) : s_output[c];
+        }
+        for(int c=0; c < 2; c++) {
+            MYFLT h_output = drv_output[c];
+            if(hipass) {
+                h_output = h_b0*drv_output[c] + h_b1*p->h_i1[c] + h_b0*p->h_i2[c] - h_a1*p->h_o1[c] - h_a2*p->h_o2[c];
+                p->h_o2[c] = p->h_o1[c];
+                p->h_o1[c] = h_output;
+                p->h_i2[c] = p->h_i1[c];
+                p->h_i1[c] = drv_output[c];
+            }
+            p->lp_output[c] = muffle ? h_output*lp_a0 + h_output*lp_a1 + p->lp_output[c]*lp_b1 : h_output;
+            MYFLT out = p->lp_output[c]*outgain;
+            output[c] = limiter ? liteon_clip(out, 0.98) : out;
+        }
+        out0[n] = output[0];
+        out1[n] = output[1];
+    }
+    return OK;
+}
+
+
+/*
+ * presenceeq
+ *
+ * aL, aR presenceeq aL, aR, kfreq, kboostdb [, kbw=0.2, kgaindb=0]
+ *
+ * kfreq: 3100-18500 Hz, kboostdb: -15-15, kbw: 0.07-0.4
+ */
+
+struct t_presenceeq {
+    OPDS h;
+    MYFLT *outs[2];
+    MYFLT *ins[2];
+    MYFLT *kfreq, *kboost, *kbw, *kgain;
+
+    MYFLT last[4];
+    MYFLT a0, a1, a2, b1, b2, outgain;
+    MYFLT x1[2], x2[2], y1[2], y2[2];
+};
+
+static int32_t presenceeq_init(CSOUND *csound, t_presenceeq *p) {
+    for(int i=0; i < 4; i++)
+        p->last[i] = std::numeric_limits<MYFLT>::quiet_NaN();
+    for(int c=0; c < 2; c++)
+        p->x1[c] = p->x2[c] = p->y1[c] = p->y2[c] = 0;
+    return OK;
+}
+
+static void presenceeq_slider(CSOUND *csound, t_presenceeq *p) {
+    const MYFLT cf = *p->kfreq / _GetLocalSr(csound, &(p->h));
+    const MYFLT boost = *p->kboost;
+    const MYFLT bw = *p->kbw < 0 ? 0.2 : *p->kbw;
+    p->outgain = pow(10, *p->kgain/20);
+    const MYFLT ca = tan(PI*(cf-0.25));
+    const MYFLT A = pow(10, boost/20);
+    MYFLT F;
+    if(boost < 6.0 && boost > -6.0)
+        F = sqrt(A);
+    else
+        F = A > 1 ? A/sqrt(2) : A*sqrt(2);
+    const MYFLT T = tan(2*PI*bw);
+    const MYFLT as2 = ca*ca;
+    const MYFLT as4 = as2*as2;
+    const MYFLT sn = (1 + as4)*T;
+    const MYFLT cs = (1 - as4);
+    // the script uses the magnitude itself, which is >= 1 for the whole bw range, as
+    // the argument of asin. Clamp it, otherwise all coefficients are NaN
+    const MYFLT d = min(sqrt(sn*sn + cs*cs), MYFLT(1));
+    const MYFLT delta = atan2(sn, cs);
+    const MYFLT asnd = asin(d);
+    MYFLT theta = 0.5*(PI - asnd - delta);
+    MYFLT tmp = 0.5*(asnd-delta);
+    if(tmp > 0 && tmp < theta)
+        theta = tmp;
+    const MYFLT xfmbw = theta/(2*PI);
+    const MYFLT C = 1/tan(2*PI*xfmbw);
+    const MYFLT F2 = F*F;
+    tmp = A*A - F2;
+    const MYFLT alphad = fabs(tmp) <= 0 ? C : sqrt(C*C*(F2-1)/tmp);
+    const MYFLT alphan = A*alphad;
+    const MYFLT a2plus1 = 1 + as2;
+    const MYFLT ma2plus1 = 1 - as2;
+    const MYFLT b0 = a2plus1 + alphad*ma2plus1;
+    const MYFLT recipb0 = 1/b0;
+    p->a0 = (a2plus1 + alphan*ma2plus1) * recipb0;
+    p->a1 = (4.0*ca) * recipb0;
+    p->a2 = (a2plus1 - alphan*ma2plus1) * recipb0;
+    p->b1 = -p->a1;
+    p->b2 = -((a2plus1 - alphad*ma2plus1) * recipb0);
+}
+
+static int32_t presenceeq_perf(CSOUND *csound, t_presenceeq *p) {
+    if(liteon_params_changed(&(p->kfreq), p->last, 4))
+        presenceeq_slider(csound, p);
+    const int nsmps = p->h.insdshead->ksmps;
+    const MYFLT a0 = p->a0, a1 = p->a1, a2 = p->a2, b1 = p->b1, b2 = p->b2, outgain = p->outgain;
+    MYFLT x1[2], x2[2], y1[2], y2[2];
+    for(int c=0; c < 2; c++) {
+        x1[c] = p->x1[c]; x2[c] = p->x2[c]; y1[c] = p->y1[c]; y2[c] = p->y2[c];
+    }
+    MYFLT *in0 = p->ins[0], *in1 = p->ins[1], *out0 = p->outs[0], *out1 = p->outs[1];
+    for(int n=0; n < nsmps; n++) {
+        const MYFLT x[2] = {in0[n], in1[n]};
+        MYFLT y[2];
+        for(int c=0; c < 2; c++) {
+            y[c] = a0*x[c] + a1*x1[c] + a2*x2[c] + b1*y1[c] + b2*y2[c];
+            x2[c] = x1[c];
+            x1[c] = x[c];
+            y2[c] = y1[c];
+            y1[c] = y[c];
+        }
+        out0[n] = y[0]*outgain;
+        out1[n] = y[1]*outgain;
+    }
+    for(int c=0; c < 2; c++) {
+        p->x1[c] = x1[c]; p->x2[c] = x2[c]; p->y1[c] = y1[c]; p->y2[c] = y2[c];
+    }
+    return OK;
+}
+
+
+/*
+ * np1136peaklimiter
+ *
+ * aL, aR np1136peaklimiter aL, aR, kthreshdb, kratio [, kattack=30, krelease=45, khpfreq=0,
+ *                                                     kgrlimitdb=-18, kmakeupdb=0, ktiltfreq=639,
+ *                                                     ktiltdb=0, kwet=100, klink=1, kclip=0]
+ *
+ * kthreshdb: -40-0, kratio: 1-20 (20: program dependent mode), kattack, krelease: 0-100
+ * khpfreq: highpass of the detector in Hz (<= 20: off), kgrlimitdb: -40-0 (-40: off)
+ * kmakeupdb: 0-30, ktiltfreq: center of the tilt eq in Hz, ktiltdb: -6-6, kwet: 0-100 (%)
+ * klink: 1 = one detector for both channels, 0 = one per channel. kclip: hard clip
+ * The sidechain input of the script is not supported
+ */
+
+struct t_np1136peaklimiter {
+    OPDS h;
+    MYFLT *outs[2];
+    MYFLT *ins[2];
+    MYFLT *kthresh, *kratio, *kattack, *krelease, *khpfreq, *kgrlimit, *kmakeup,
+          *ktiltfreq, *ktilt, *kwet, *klink, *kclip;
+
+    MYFLT last[12];
+    MYFLT sr;
+    MYFLT cutoff, hpa0, hpa1, hpa2, hpb1, hpb2;
+    MYFLT thr, rat, att, rel;
+    MYFLT tlt_gain, lgain, hgain, tgt_ta0, tgt_tb1, src_ta0, src_tb1, ta0, tb1, d_ta0, d_tb1;
+    MYFLT grlimit, outgain, mix;
+    // per channel
+    MYFLT mem1[2], mem2[2], mem3[2], mem4[2];
+    MYFLT dt[2], env[2], cgain[2], lp_out[2];
+    MYFLT pdatt[2], pdrel[2], pdrat[2];
+    MYFLT d_pdatt[2], d_pdrel[2], d_pdrat[2];
+    MYFLT src_pdatt[2], src_pdrel[2], src_pdrat[2];
+};
+
+static int32_t np1136peaklimiter_init(CSOUND *csound, t_np1136peaklimiter *p) {
+    for(int i=0; i < 12; i++)
+        p->last[i] = std::numeric_limits<MYFLT>::quiet_NaN();
+    p->sr = _GetLocalSr(csound, &(p->h));
+    p->src_ta0 = p->src_tb1 = p->ta0 = p->tb1 = p->d_ta0 = p->d_tb1 = 0;
+    for(int c=0; c < 2; c++) {
+        p->mem1[c] = p->mem2[c] = p->mem3[c] = p->mem4[c] = 0;
+        p->dt[c] = p->env[c] = p->cgain[c] = p->lp_out[c] = 0;
+        p->pdatt[c] = p->pdrel[c] = p->pdrat[c] = 0;
+        p->d_pdatt[c] = p->d_pdrel[c] = p->d_pdrat[c] = 0;
+        p->src_pdatt[c] = p->src_pdrel[c] = p->src_pdrat[c] = 0;
+    }
+    return OK;
+}
+
+static void np1136peaklimiter_slider(t_np1136peaklimiter *p) {
+    const MYFLT sr = p->sr;
+    const MYFLT attack = *p->kattack < 0 ? 30 : *p->kattack;
+    const MYFLT release = *p->krelease < 0 ? 45 : *p->krelease;
+    const MYFLT grl = *p->kgrlimit > 0 ? -18 : *p->kgrlimit;
+    const MYFLT tf = *p->ktiltfreq < 0 ? 639 : *p->ktiltfreq;
+    const MYFLT wet = *p->kwet < 0 ? 100 : *p->kwet;
+    // detector hp (12db/oct)
+    p->cutoff = *p->khpfreq;
+    const MYFLT cpi = PI*(2*p->cutoff/sr);
+    const MYFLT fk = 0.67*sin(cpi);
+    const MYFLT c1 = 0.5*(1 - fk)/(1 + fk);
+    const MYFLT c2 = (0.5 + c1)*cos(cpi);
+    const MYFLT c3 = (0.5 + c1 + c2)*0.25;
+    p->hpa0 = 2*c3;
+    p->hpa1 = -4*c3;
+    p->hpa2 = 2*c3;
+    p->hpb1 = -2*c2;
+    p->hpb2 = 2*c1;
+    // compressor
+    p->thr = pow(10, 2 * (*p->kthresh/40+1) - 2);
+    p->rat = (*p->kratio-1)/19;
+    p->att = pow(10, -0.002 - 3.97772619*(attack/100));
+    p->rel = pow(10, -3.11 - 1.8698*(release/100));
+    // tilt filter
+    const MYFLT amp = 6/log(2.0);
+    p->tlt_gain = *p->ktilt;
+    MYFLT g1, g2;
+    if(p->tlt_gain > 0) {
+        g1 = -4*p->tlt_gain;
+        g2 = p->tlt_gain;
+    } else {
+        g1 = -p->tlt_gain;
+        g2 = 4*p->tlt_gain;
+    }
+    p->lgain = exp(g1/amp)-1;
+    p->hgain = exp(g2/amp)-1;
+    const MYFLT tomega = 2*PI*tf;
+    const MYFLT sr3 = 3*sr;
+    const MYFLT tn = 1/(sr3 + tomega);
+    p->tgt_ta0 = 2*tomega*tn;
+    p->tgt_tb1 = (sr3 - tomega)*tn;
+    // mix
+    p->grlimit = eel_eq(grl, -40) ? pow(10, -6*64/20.0) : pow(10, (grl-0.3)/20);
+    p->outgain = pow(10, *p->kmakeup/20);
+    p->mix = (100-wet)/100;
+}
+
+static int32_t np1136peaklimiter_perf(CSOUND *csound, t_np1136peaklimiter *p) {
+    IGN(csound);
+    if(liteon_params_changed(&(p->kthresh), p->last, 12))
+        np1136peaklimiter_slider(p);
+    const int nsmps = p->h.insdshead->ksmps;
+    const bool pdmode = eel_eq(p->rat, 1);
+    const bool tilt = !eel_eq(p->tlt_gain, 0);
+    // @block
+    if(tilt) {
+        p->d_ta0 = (p->tgt_ta0-p->src_ta0)/nsmps;
+        p->ta0 = p->src_ta0;
+        p->src_ta0 = p->tgt_ta0;
+        p->d_tb1 = (p->tgt_tb1-p->src_tb1)/nsmps;
+        p->tb1 = p->src_tb1;
+        p->src_tb1 = p->tgt_tb1;
+    }
+    if(pdmode) {
+        const MYFLT att = p->att, rel = p->rel, rat = p->rat;
+        for(int c=0; c < 2; c++) {
+            const MYFLT tgt_att = min(att*0.95+att*p->dt[c]*7, 0.995405);
+            p->d_pdatt[c] = (tgt_att-p->src_pdatt[c])/nsmps;
+            p->pdatt[c] = p->src_pdatt[c];
+            p->src_pdatt[c] = tgt_att;
+            const MYFLT tgt_rel = min(rel*0.9+rel*p->dt[c]*4, 0.00077625);
+            p->d_pdrel[c] = (tgt_rel-p->src_pdrel[c])/nsmps;
+            p->pdrel[c] = p->src_pdrel[c];
+            p->src_pdrel[c] = tgt_rel;
+            const MYFLT tgt_rat = max(rat-p->dt[c]*2, 0.57);
+            p->d_pdrat[c] = (tgt_rat-p->src_pdrat[c])/nsmps;
+            p->pdrat[c] = p->src_pdrat[c];
+            p->src_pdrat[c] = tgt_rat;
+        }
+    }
+
+    const bool link = *p->klink != 0, hardclip = *p->kclip != 0;
+    const bool hpfilter = p->cutoff > 20;
+    const MYFLT hpa0 = p->hpa0, hpa1 = p->hpa1, hpa2 = p->hpa2, hpb1 = p->hpb1, hpb2 = p->hpb2;
+    const MYFLT thr = p->thr, maxgain = 1/p->grlimit, outgain = p->outgain, mix = p->mix;
+    const MYFLT lgain = p->lgain, hgain = p->hgain, d_ta0 = p->d_ta0, d_tb1 = p->d_tb1;
+    MYFLT ta0 = p->ta0, tb1 = p->tb1;
+    MYFLT *in0 = p->ins[0], *in1 = p->ins[1], *out0 = p->outs[0], *out1 = p->outs[1];
+    for(int n=0; n < nsmps; n++) {
+        const MYFLT spl[2] = {in0[n], in1[n]};
+        MYFLT det[2] = {spl[0], spl[1]};
+        // with a linked detector only the left filter and envelope are used
+        const int numdet = link ? 1 : 2;
+        if(link)
+            det[0] = (det[0]+det[1])/2;
+        for(int c=0; c < numdet; c++) {
+            if(hpfilter) {
+                const MYFLT in = hpa0*det[c] + hpa1*p->mem1[c] + hpa2*p->mem2[c] - hpb1*p->mem3[c] - hpb2*p->mem4[c];
+                p->mem2[c] = p->mem1[c];
+                p->mem1[c] = det[c];
+                p->mem4[c] = p->mem3[c];
+                p->mem3[c] = in;
+                p->dt[c] = fabs(in);
+            } else {
+                p->dt[c] = fabs(det[c]);
+            }
+        }
+        if(link)
+            p->dt[1] = p->dt[0];
+        for(int c=0; c < numdet; c++) {
+            if(pdmode) {
+                p->pdatt[c] += p->d_pdatt[c];
+                p->pdrel[c] += p->d_pdrel[c];
+                p->pdrat[c] += p->d_pdrat[c];
+            } else {
+                p->pdatt[c] = p->att;
+                p->pdrel[c] = p->rel;
+                p->pdrat[c] = p->rat;
+            }
+        }
+        if(link && !pdmode) {
+            p->pdatt[1] = p->att;
+            p->pdrel[1] = p->rel;
+            p->pdrat[1] = p->rat;
+        }
+        for(int c=0; c < numdet; c++) {
+            MYFLT env = p->env[c];
+            env = p->dt[c] > env ? env + p->pdatt[c]*(p->dt[c] - env) : env*(1 - p->pdrel[c]);
+            p->cgain[c] = env > thr ? min(1+(p->pdrat[c]*((env/thr)-1)), maxgain) : 1;
+            p->env[c] = env < 1e-10 ? 0 : env;
+        }
+        if(link)
+            p->cgain[1] = p->cgain[0];
+        ta0 += d_ta0;
+        tb1 += d_tb1;
+        MYFLT out[2];
+        for(int c=0; c < 2; c++) {
+            const MYFLT cout = spl[c]*outgain/p->cgain[c];
+            MYFLT tout = cout;
+            if(tilt) {
+                p->lp_out[c] = ta0*cout + tb1*p->lp_out[c];
+                tout = cout + lgain*p->lp_out[c] + hgain*(cout - p->lp_out[c]);
+            }
+            const MYFLT o = mix*spl[c] + (1-mix)*tout;
+            out[c] = hardclip ? liteon_clip(o+1e-30, liteon_mv) : o+1e-30;
+        }
+        out0[n] = out[0];
+        out1[n] = out[1];
+    }
+    p->ta0 = ta0;
+    p->tb1 = tb1;
+    return OK;
+}
+
+
+/*
+ * ringmodulator
+ *
+ * aL, aR ringmodulator aL, aR, kfreq [, kdiode=0, kfeedback=0, knonlin=10, kmix=100,
+ *                                       kgaindb=0, koversample=0]
+ *
+ * kfreq: frequency of the modulator, in Hz. kdiode: pass only the positive half of
+ * the modulator. kfeedback, knonlin, kmix: 0-100 (%). kgaindb: -40-40 (-40: mute)
+ * The non-linearities are random, so the output only matches that of the script
+ * if knonlin is 0
+ */
+
+struct t_ringmodulator {
+    OPDS h;
+    MYFLT *outs[2];
+    MYFLT *ins[2];
+    MYFLT *kfreq, *kdiode, *kfeedback, *knonlin, *kmix, *kgain, *koversample;
+
+    MYFLT last[7];
+    int seed;
+    MYFLT sr;
+    MYFLT tgt_f, src_f, tgt_mix, src_mix, fb, nl, outgain;
+    MYFLT sinp;
+    MYFLT fp[2], fp_os[2][2];
+    liteon_os2x<1> sin_os;
+    liteon_os2x<2> fx_os;
+};
+
+static int32_t ringmodulator_init(CSOUND *csound, t_ringmodulator *p) {
+    for(int i=0; i < 7; i++)
+        p->last[i] = std::numeric_limits<MYFLT>::quiet_NaN();
+    p->seed = csound->GetRandomSeedFromTime();
+    p->sr = _GetLocalSr(csound, &(p->h));
+    p->src_f = p->src_mix = 0;
+    p->sinp = 0;
+    p->fp[0] = p->fp[1] = 0;
+    p->fp_os[0][0] = p->fp_os[0][1] = p->fp_os[1][0] = p->fp_os[1][1] = 0;
+    memset(&(p->sin_os), 0, sizeof(p->sin_os));
+    memset(&(p->fx_os), 0, sizeof(p->fx_os));
+    return OK;
+}
+
+static void ringmodulator_slider(t_ringmodulator *p) {
+    const MYFLT nl = *p->knonlin < 0 ? 10 : *p->knonlin;
+    const MYFLT mix = *p->kmix < 0 ? 100 : *p->kmix;
+    p->tgt_f = *p->kfreq;
+    p->fb = *p->kfeedback/100;
+    p->tgt_mix = mix/100;
+    p->nl = nl;
+    p->outgain = eel_eq(*p->kgain, -40) ? 0 : pow(10, *p->kgain/20);
+}
+
+static int32_t ringmodulator_perf(CSOUND *csound, t_ringmodulator *p) {
+    if(liteon_params_changed(&(p->kfreq), p->last, 7))
+        ringmodulator_slider(p);
+    const int nsmps = p->h.insdshead->ksmps;
+    const MYFLT pi2 = 2*PI, r = 0.85;
+    // @block
+    const MYFLT d_f = (p->tgt_f-p->src_f)/nsmps;
+    MYFLT tf = p->src_f;
+    p->src_f = p->tgt_f;
+    const MYFLT d_mix = (p->tgt_mix-p->src_mix)/nsmps;
+    MYFLT tmix = p->src_mix;
+    p->src_mix = p->tgt_mix;
+
+    const bool diode = *p->kdiode != 0, oversample = *p->koversample != 0;
+    const MYFLT fb = p->fb, nl = p->nl, outgain = p->outgain, sr = p->sr;
+    MYFLT *in0 = p->ins[0], *in1 = p->ins[1], *out0 = p->outs[0], *out1 = p->outs[1];
+    MYFLT sinp = p->sinp;
+    for(int n=0; n < nsmps; n++) {
+        // modulator, shared by both channels
+        MYFLT nl_f = 0, nl_fb = 0;
+        if(nl > 0) {
+            nl_f = rand(csound, 1, &p->seed)*4*nl - 2*nl;
+            nl_fb = (rand(csound, 1, &p->seed)*2*nl - nl)*0.001;
+        }
+        tf += d_f;
+        tmix += d_mix;
+        const MYFLT sina = pi2*(tf-nl_f)/sr;
+        const MYFLT sinout = sin(sinp);
+        sinp = sinp+sina;
+        if(sinp >= pi2)
+            sinp -= pi2;
+        MYFLT m_out = sinout;
+        if(diode) {
+            if(!oversample)
+                m_out = fabs(sinout)*2-0.20260;
+            else
+                liteon_os2x_process<1>(p->sin_os, &sinout, &m_out, 4,
+                                       [](int, int, MYFLT x) { return fabs(x)*2-0.20260; });
+        }
+        if(fb == 0)
+            nl_fb = 0;
+        const MYFLT fbk = fb-nl_fb;
+
+        const MYFLT in[2] = {in0[n], in1[n]};
+        MYFLT fx_out[2], out[2];
+        if(!oversample) {
+            for(int c=0; c < 2; c++) {
+                p->fp[c] = (in[c]+fbk*p->fp[c])*sinout*r;
+                const MYFLT s_out = m_out*in[c] + p->fp[c];
+                const MYFLT o = s_out*tmix+in[c]*(1-tmix);
+                fx_out[c] = o*r*outgain;
+            }
+        } else {
+            liteon_os2x_process<2>(p->fx_os, in, fx_out, 4, [p, fbk, sinout, m_out, r](int h, int c, MYFLT x) {
+                p->fp_os[h][c] = (x+fbk*p->fp_os[h][c])*sinout*r;
+                return m_out*x + p->fp_os[h][c];
+            });
+        }
+        for(int c=0; c < 2; c++) {
+            const MYFLT o = fx_out[c]*tmix+in[c]*(1-tmix);
+            out[c] = o*r*outgain;
+        }
+        out0[n] = out[0];
+        out1[n] = out[1];
+    }
+    p->sinp = sinp;
+    return OK;
+}
+
 // ----------------------------------------------------------------------------------------
 
 #define S(x) sizeof(x)
@@ -1448,15 +3366,21 @@ extern "C" {
         // a1 [, a2, ...] jsfx Spath, a1, [a2, ...], [id0, kval0, id1, kval1, ...]
         { (char*)"jsfx", S(t_jsfx), 0, 3, (char*)"i*", (char*)"S*", (SUBR)jsfx_opcode_init, (SUBR)jsfx_opcode_perf, nullptr, nullptr},
 
-        // ihandle jsfx_new Spath
-        { (char*)"jsfx_new", S(t_jsfx_new), 0, 1, (char*)"i", (char*)"S", (SUBR)jsfx_new_init, nullptr, nullptr, nullptr },
+        // ihandle jsfx_new Spath [, ioversample]
+        { (char*)"jsfx_new", S(t_jsfx_new), 0, 1, (char*)"i", (char*)"So", (SUBR)jsfx_new_init, nullptr, nullptr, nullptr },
 
         // a1, [a2, ...] jsfx_play ihandle, a1, [a2, ...]
         { (char*)"jsfx_play", S(t_jsfx_play), 0, 3, (char*)"mmmmmmmm", (char*)"iM", (SUBR)jsfx_play_init, (SUBR)jsfx_play_perf, nullptr, nullptr },
 
+        // aOut[] jsfx_chain iHandles[], aIn[] [, ithreads]
+        { (char*)"jsfx_chain", S(t_jsfx_chain), 0, 3, (char*)"a[]", (char*)"i[]a[]o", (SUBR)jsfx_chain_init, (SUBR)jsfx_chain_perf, nullptr, nullptr },
+
         // jsfx_dump ihandle, ktrig
         { (char*)"jsfx_dump", S(t_jsfx_dump), 0, 3, (char*)"", (char*)"ik", (SUBR)jsfx_dump_init, (SUBR)jsfx_dump_perf, nullptr, nullptr },
 
+        // ilatency jsfx_latency ihandle
+        { (char*)"jsfx_latency", S(t_jsfx_latency), 0, 1, (char*)"i", (char*)"i", (SUBR)jsfx_latency_init, nullptr, nullptr, nullptr },
+
         // kval jsfx_getslider ihandle, ksliderid
         { (char*)"jsfx_getslider", S(t_jsfx_getslider), 0, 3, (char*)"k", (char*)"ik", (SUBR)jsfx_getslider_init, (SUBR)jsfx_getslider_perf, nullptr, nullptr },
 
@@ -1467,10 +3391,37 @@ extern "C" {
         // jsfx_setslider ihandle, id0, kval0 [, id1, kval1, ...]
         { (char*)"jsfx_setslider.many", S(t_jsfx_setslider_many), 0, 3, (char*)"", (char*)"iM", (SUBR)jsfx_setslider_many_init, (SUBR)jsfx_setslider_many_perf, nullptr, nullptr },
 
+        // jsfx_sliderthreshold ihandle, id0, ithresh0 [, id1, ithresh1, ...]
+        { (char*)"jsfx_sliderthreshold", S(t_jsfx_sliderthreshold), 0, 1, (char*)"", (char*)"im", (SUBR)jsfx_sliderthreshold_init, nullptr, nullptr, nullptr },
+
+        // jsfx_midi ihandle, kstatus, kdata1, kdata2 [, koffset]
+        { (char*)"jsfx_midi", S(t_jsfx_midi), 0, 3, (char*)"", (char*)"ikkkO", (SUBR)jsfx_midi_init, (SUBR)jsfx_midi_perf, nullptr, nullptr },
+
+        // jsfx_midinote ihandle, inote, ivel [, ichan]
+        { (char*)"jsfx_midinote", S(t_jsfx_midinote), 0, 3, (char*)"", (char*)"iiio", (SUBR)jsfx_midinote_init, (SUBR)jsfx_midinote_perf, nullptr, nullptr },
+
         // a1, a2 tubeharmonics a1, a2, keven, kodd, kfluct, kinputdb, koutputdb, kgain
         { (char*)"tubeharmonics.2", S(t_tubeharmonics_stereo), 0, 3, (char*)"aa", (char*)"aaJJJOOO", (SUBR)tubeharmonics_stereo_init, (SUBR)tubeharmonics_stereo_perf, nullptr, nullptr},
 
         { (char*)"tubeharmonics.1", S(t_tubeharmonics_mono), 0, 3, (char*)"a", (char*)"aJJJOOO", (SUBR)tubeharmonics_mono_init, (SUBR)tubeharmonics_mono_perf, nullptr, nullptr},
+
+        // aL, aR butterworth24db aL, aR, kmode, kfreq [, kres, kgaindb, klimiter]
+        { (char*)"butterworth24db", S(t_butterworth24db), 0, 3, (char*)"aa", (char*)"aakkOOP", (SUBR)butterworth24db_init, (SUBR)butterworth24db_perf, nullptr, nullptr},
+
+        // aL, aR moog24db aL, aR, kmode, kfreq [, kres, kdrive, kgaindb, klimiter, koversample]
+        { (char*)"moog24db", S(t_moog24db), 0, 3, (char*)"aa", (char*)"aakkOOOPO", (SUBR)moog24db_init, (SUBR)moog24db_perf, nullptr, nullptr},
+
+        // aL, aR bassmanager aL, aR, kfreq, kboostdb [, kdrive, kmuffle, kgaindb, khipass, klimiter, koversample, knarrow]
+        { (char*)"bassmanager", S(t_bassmanager), 0, 3, (char*)"aa", (char*)"aakkOOOOPOO", (SUBR)bassmanager_init, (SUBR)bassmanager_perf, nullptr, nullptr},
+
+        // aL, aR presenceeq aL, aR, kfreq, kboostdb [, kbw, kgaindb]
+        { (char*)"presenceeq", S(t_presenceeq), 0, 3, (char*)"aa", (char*)"aakkJO", (SUBR)presenceeq_init, (SUBR)presenceeq_perf, nullptr, nullptr},
+
+        // aL, aR np1136peaklimiter aL, aR, kthreshdb, kratio [, kattack, krelease, khpfreq, kgrlimitdb, kmakeupdb, ktiltfreq, ktiltdb, kwet, klink, kclip]
+        { (char*)"np1136peaklimiter", S(t_np1136peaklimiter), 0, 3, (char*)"aa", (char*)"aakkJJOVOJOJPO", (SUBR)np1136peaklimiter_init, (SUBR)np1136peaklimiter_perf, nullptr, nullptr},
+
+        // aL, aR ringmodulator aL, aR, kfreq [, kdiode, kfeedback, knonlin, kmix, kgaindb, koversample]
+        { (char*)"ringmodulator", S(t_ringmodulator), 0, 3, (char*)"aa", (char*)"aakOOJJOO", (SUBR)ringmodulator_init, (SUBR)ringmodulator_perf, nullptr, nullptr},
         // this signals end of loop
         { "", 0, 0, 0, 0, 0, 0, 0, 0, 0}
 
@@ -1478,17 +3429,23 @@ extern "C" {
         // aout jsfx Spath, ain, kparams... \
         // a1 [, a2, ...] jsfx Spath, a1, [a2, ...], [id0, kval0, id1, kval1, ...]
         
-        // ihandle jsfx_new Spath
-        { (char*)"jsfx_new",  S(t_jsfx_new),  0, (char*)"i",        (char*)"S",  (SUBR)jsfx_new_init,    nullptr,                nullptr, 0},
+        // ihandle jsfx_new Spath [, ioversample]
+        { (char*)"jsfx_new",  S(t_jsfx_new),  0, (char*)"i",        (char*)"So", (SUBR)jsfx_new_init,    nullptr,                (SUBR)jsfx_new_deinit, 0},
 
         { (char*)"jsfx",      S(t_jsfx),      0, (char*)"i*",       (char*)"S*", (SUBR)jsfx_opcode_init, (SUBR)jsfx_opcode_perf, (SUBR)jsfx_opcode_deinit, 0},
         
         // a1, [a2, ...] jsfx_play ihandle, a1, [a2, ...]
         { (char*)"jsfx_play", S(t_jsfx_play), 0, (char*)"mmmmmmmm", (char*)"iM", (SUBR)jsfx_play_init,   (SUBR)jsfx_play_perf, nullptr, 0},
 
+        // aOut[] jsfx_chain iHandles[], aIn[] [, ithreads]
+        { (char*)"jsfx_chain", S(t_jsfx_chain), 0, (char*)"a[]",    (char*)"i[]a[]o", (SUBR)jsfx_chain_init, (SUBR)jsfx_chain_perf, (SUBR)jsfx_chain_deinit, 0},
+
         // jsfx_dump ihandle, ktrig
         { (char*)"jsfx_dump", S(t_jsfx_dump), 0, (char*)"",         (char*)"ik", (SUBR)jsfx_dump_init,   (SUBR)jsfx_dump_perf, nullptr, 0},
 
+        // ilatency jsfx_latency ihandle
+        { (char*)"jsfx_latency", S(t_jsfx_latency), 0, (char*)"i", (char*)"i", (SUBR)jsfx_latency_init, nullptr, nullptr, 0},
+
         // kval jsfx_getslider ihandle, ksliderid
         { (char*)"jsfx_getslider", S(t_jsfx_getslider), 0, (char*)"k", (char*)"ik", (SUBR)jsfx_getslider_init, (SUBR)jsfx_getslider_perf, nullptr, 0},
 
@@ -1499,10 +3456,37 @@ extern "C" {
         // jsfx_setslider ihandle, id0, kval0 [, id1, kval1, ...]
         { (char*)"jsfx_setslider.many", S(t_jsfx_setslider_many), 0, (char*)"", (char*)"iM", (SUBR)jsfx_setslider_many_init, (SUBR)jsfx_setslider_many_perf, nullptr, 0},
 
+        // jsfx_sliderthreshold ihandle, id0, ithresh0 [, id1, ithresh1, ...]
+        { (char*)"jsfx_sliderthreshold", S(t_jsfx_sliderthreshold), 0, (char*)"", (char*)"im", (SUBR)jsfx_sliderthreshold_init, nullptr, nullptr, 0},
+
+        // jsfx_midi ihandle, kstatus, kdata1, kdata2 [, koffset]
+        { (char*)"jsfx_midi", S(t_jsfx_midi), 0, (char*)"", (char*)"ikkkO", (SUBR)jsfx_midi_init, (SUBR)jsfx_midi_perf, nullptr, 0},
+
+        // jsfx_midinote ihandle, inote, ivel [, ichan]
+        { (char*)"jsfx_midinote", S(t_jsfx_midinote), 0, (char*)"", (char*)"iiio", (SUBR)jsfx_midinote_init, (SUBR)jsfx_midinote_perf, (SUBR)jsfx_midinote_deinit, 0},
+
         // a1, a2 tubeharmonics a1, a2, keven, kodd, kfluct, kinputdb, koutputdb, kgain
         { (char*)"tubeharmonics.2", S(t_tubeharmonics_stereo), 0, (char*)"aa", (char*)"aaJJJOOO", (SUBR)tubeharmonics_stereo_init, (SUBR)tubeharmonics_stereo_perf, nullptr, 0},
 
         { (char*)"tubeharmonics.1", S(t_tubeharmonics_mono), 0, (char*)"a", (char*)"aJJJOOO", (SUBR)tubeharmonics_mono_init, (SUBR)tubeharmonics_mono_perf, nullptr, 0},
+
+        // aL, aR butterworth24db aL, aR, kmode, kfreq [, kres, kgaindb, klimiter]
+        { (char*)"butterworth24db", S(t_butterworth24db), 0, (char*)"aa", (char*)"aakkOOP", (SUBR)butterworth24db_init, (SUBR)butterworth24db_perf, nullptr, 0},
+
+        // aL, aR moog24db aL, aR, kmode, kfreq [, kres, kdrive, kgaindb, klimiter, koversample]
+        { (char*)"moog24db", S(t_moog24db), 0, (char*)"aa", (char*)"aakkOOOPO", (SUBR)moog24db_init, (SUBR)moog24db_perf, nullptr, 0},
+
+        // aL, aR bassmanager aL, aR, kfreq, kboostdb [, kdrive, kmuffle, kgaindb, khipass, klimiter, koversample, knarrow]
+        { (char*)"bassmanager", S(t_bassmanager), 0, (char*)"aa", (char*)"aakkOOOOPOO", (SUBR)bassmanager_init, (SUBR)bassmanager_perf, nullptr, 0},
+
+        // aL, aR presenceeq aL, aR, kfreq, kboostdb [, kbw, kgaindb]
+        { (char*)"presenceeq", S(t_presenceeq), 0, (char*)"aa", (char*)"aakkJO", (SUBR)presenceeq_init, (SUBR)presenceeq_perf, nullptr, 0},
+
+        // aL, aR np1136peaklimiter aL, aR, kthreshdb, kratio [, kattack, krelease, khpfreq, kgrlimitdb, kmakeupdb, ktiltfreq, ktiltdb, kwet, klink, kclip]
+        { (char*)"np1136peaklimiter", S(t_np1136peaklimiter), 0, (char*)"aa", (char*)"aakkJJOVOJOJPO", (SUBR)np1136peaklimiter_init, (SUBR)np1136peaklimiter_perf, nullptr, 0},
+
+        // aL, aR ringmodulator aL, aR, kfreq [, kdiode, kfeedback, knonlin, kmix, kgaindb, koversample]
+        { (char*)"ringmodulator", S(t_ringmodulator), 0, (char*)"aa", (char*)"aakOOJJOO", (SUBR)ringmodulator_init, (SUBR)ringmodulator_perf, nullptr, 0},
         { (char*)"", 0, 0, (char*)"", (char*)"", nullptr, nullptr, nullptr, 0}
         // {(char *)"alwayson", sizeof(AlwaysOn), 0,  (char *)"", (char *)"im", (SUBR)&AlwaysOn::init_, 0, 0},
 #endif
@@ -29,6 +29,7 @@
 */
 
 #include "csdl.h"
+#include "sndfile.h"
 
 #include "../../common/_common.h"
 #include "pyinlib.h"
@@ -52,6 +53,11 @@ static const char *pyin_params[] = {
     "octave_cost",                    // 10
     "subharmonic_thresh",             // 11
     "drift",                          // 12
+    "fft",                            // 13
+    "spread",                         // 14
+    "async",                          // 15
+    "threads",                        // 16  (pyinoffline)
+    "channel",                        // 17  (pyinoffline)
     NULL
 };
 
@@ -69,43 +75,53 @@ static int _key_index(char *key, const char **options) {
 
 typedef struct {
     OPDS h;
+    // outputs: kfreq, kconf, kvoiced, [klatency]
+    // inputs:  asig, Sarg1, ivalue1, ...
+    void *args[40];
+
     MYFLT *kfreq;
     MYFLT *kconf;
     MYFLT *kvoiced;
-
+    MYFLT *klatency;
     MYFLT *asig;
-    void *ctrls[30];
+    void **ctrls;
+    int numouts;
+
     PYINContext *pyinctx;
+    struct PYIN_WORKER_ *worker;   // non-NULL in async mode
 
     MYFLT last_freq;
     MYFLT last_conf;
     MYFLT last_voiced;
 
+    AUXCH blockmem;     // ksmps floats, the input converted for pyin_process_block
+
 } PYIN_OPCODE;
 
 
-static int32_t pyin_init(CSOUND *csound, PYIN_OPCODE *p) {
-    PYINConfig cfg = pyin_config_default();
-    cfg.sample_rate = LOCAL_SR(p);
-    cfg.block_size = LOCAL_KSMPS(p);
+typedef struct {
+    int threads;
+    int channel;
+} PYIN_OFFLINE_OPTS;
+
+// Parse the key/value pairs shared by pyin and pyinoffline into cfg.
+// opts is NULL for pyin, which does not accept the offline-only parameters
+static int32_t pyin_parse_params(CSOUND *csound, void **ctrls, int numargs,
+                                 PYINConfig *cfg, PYIN_OFFLINE_OPTS *opts) {
     STRINGDAT *key;
     CS_TYPE *cstype;
-    int numargs = _GetInputArgCnt(csound, p) - 1;
     if(numargs % 2) {
         INITERRF("Expected event number of arguments, got %d\n", numargs);
         return NOTOK;
     }
-    p->last_freq = 0.;
-    p->last_conf = 0.;
-    p->last_voiced = 0.;
     if(numargs > 0) {
         for(int i=0; i < numargs / 2; i++) {
-            cstype = _GetTypeForArg(csound, p->ctrls[i*2]);
+            cstype = _GetTypeForArg(csound, ctrls[i*2]);
             if(cstype->varTypeName[0] != 'S') {
                 INITERRF("Expected a string for arg %d, got %s\n", i+1, cstype->varTypeName);
                 return NOTOK;
             }
-            key = (STRINGDAT*)(p->ctrls[i*2]);
+            key = (STRINGDAT*)(ctrls[i*2]);
             int paramindex = _key_index(key->data, pyin_params);
             if(paramindex < 0) {
                 INITERRF("Unknown parmeter %s. Known parameters: ", key->data);
@@ -114,54 +130,180 @@ static int32_t pyin_init(CSOUND *csound, PYIN_OPCODE *p) {
                 }
                 return NOTOK;
             }
-            MYFLT value = *(MYFLT *)(p->ctrls[i*2+1]);
+            MYFLT value = *(MYFLT *)(ctrls[i*2+1]);
             switch(paramindex) {
             case 0:   // framesize
-                cfg.frame_size = (int)value;
+                cfg->frame_size = (int)value;
                 break;
             case 1:   // hop
-                cfg.hop_size = (int)value;
+                cfg->hop_size = (int)value;
                 break;
             case 2:   // fmin
-                cfg.f0_min = value;
+                cfg->f0_min = value;
                 break;
             case 3:   // fmax
-                cfg.f0_max = value;
+                cfg->f0_max = value;
                 break;
             case 4:   // bins
-                cfg.cents_per_semitone = (int)value;
+                cfg->cents_per_semitone = (int)value;
                 break;
             case 5:   // transition_weight
-                cfg.voiced_transition_weight = value;
+                cfg->voiced_transition_weight = value;
                 break;
             case 6:   // beta_a
-                cfg.beta_a = value;
+                cfg->beta_a = value;
                 break;
             case 7:   // beta_b
-                cfg.beta_b = value;
+                cfg->beta_b = value;
                 break;
             case 8:   // minrms
-                cfg.energy_gate_rms = value;
+                cfg->energy_gate_rms = value;
                 break;
             case 9:   // voiced_obs_floor
-                cfg.voiced_obs_floor = value;
+                cfg->voiced_obs_floor = value;
                 break;
             case 10:  // octave_cost
-                cfg.octave_cost_weight = value;
+                cfg->octave_cost_weight = value;
                 break;
             case 11:  // subharmonic_thresh
-                cfg.octave_subharmonic_threshold = value;
+                cfg->octave_subharmonic_threshold = value;
                 break;
             case 12:  // drift
-                cfg.pitch_sigma_cents = value;
+                cfg->pitch_sigma_cents = value;
+                break;
+            case 13:  // fft
+                // -1: auto, 0: direct, 1: fft
+                cfg->diff_method = value < 0 ? PYIN_DIFF_AUTO :
+                                   value > 0 ? PYIN_DIFF_FFT : PYIN_DIFF_DIRECT;
+                break;
+            case 14:  // spread
+                cfg->spread_analysis = value > 0;
+                break;
+            case 15:  // async
+                cfg->async_mode = value > 0;
+                break;
+            case 16:  // threads
+            case 17:  // channel
+                if(opts == NULL) {
+                    INITERRF("Parameter %s is only valid for pyinoffline", key->data);
+                    return NOTOK;
+                }
+                if(paramindex == 16)
+                    opts->threads = (int)value;
+                else
+                    opts->channel = (int)value;
                 break;
             default:
                 INITERRF("Invalid parameter index: %d", paramindex);
                 return NOTOK;
             }
         }
-        if(cfg.hop_size == 0)
-            cfg.hop_size = cfg.frame_size / 4;
+        if(cfg->hop_size == 0)
+            cfg->hop_size = cfg->frame_size / 4;
+    }
+    return OK;
+}
+
+// ----- async mode: one analysis thread per engine -----
+
+#define PYIN_WORKER_VARNAME "__pyin_worker__"
+#define PYIN_POOL_CAPACITY 256
+
+typedef struct PYIN_WORKER_ {
+    CSOUND *csound;
+    PYINPool *pool;
+    void *thread;
+    void *wakeup;
+    volatile int quit;
+} PYIN_WORKER;
+
+static uintptr_t pyin_worker_thread(void *data) {
+    PYIN_WORKER *w = (PYIN_WORKER *)data;
+    CSOUND *csound = w->csound;
+    while(!w->quit) {
+        csound->WaitThreadLock(w->wakeup, 100);
+        pyin_pool_work(w->pool);
+    }
+    return 0;
+}
+
+static int32_t pyin_worker_reset(CSOUND *csound, PYIN_WORKER *w) {
+    w->quit = 1;
+    csound->NotifyThreadLock(w->wakeup);
+    csound->JoinThread(w->thread);
+    csound->DestroyThreadLock(w->wakeup);
+    // destroys any context still in the pool
+    pyin_pool_destroy(w->pool);
+    csound->DestroyGlobalVariable(csound, PYIN_WORKER_VARNAME);
+    return OK;
+}
+
+static PYIN_WORKER *pyin_worker(CSOUND *csound) {
+    PYIN_WORKER *w = csound->QueryGlobalVariable(csound, PYIN_WORKER_VARNAME);
+    if(w != NULL) return w;
+    if(csound->CreateGlobalVariable(csound, PYIN_WORKER_VARNAME, sizeof(PYIN_WORKER)) != 0)
+        return NULL;
+    w = csound->QueryGlobalVariable(csound, PYIN_WORKER_VARNAME);
+    w->csound = csound;
+    w->quit = 0;
+    w->pool = pyin_pool_create(PYIN_POOL_CAPACITY);
+    w->wakeup = csound->CreateThreadLock();
+    w->thread = w->pool != NULL && w->wakeup != NULL
+        ? csound->CreateThread(pyin_worker_thread, (void *)w) : NULL;
+    if(w->thread == NULL) {
+        if(w->wakeup != NULL)
+            csound->DestroyThreadLock(w->wakeup);
+        pyin_pool_destroy(w->pool);
+        csound->DestroyGlobalVariable(csound, PYIN_WORKER_VARNAME);
+        return NULL;
+    }
+    csound->RegisterResetCallback(csound, (void *)w, (int32_t(*)(CSOUND*, void*))pyin_worker_reset);
+    return w;
+}
+
+
+// The block passed to pyin_process_block holds ksmps samples, which has no
+// upper bound
+static void pyin_blockmem_alloc(CSOUND *csound, AUXCH *mem, int ksmps) {
+    size_t size = sizeof(float) * (size_t)ksmps;
+    if(mem->auxp == NULL || mem->size < size)
+        csound->AuxAlloc(csound, size, mem);
+}
+
+static int32_t pyin_init(CSOUND *csound, PYIN_OPCODE *p) {
+    PYINConfig cfg = pyin_config_default();
+    cfg.sample_rate = LOCAL_SR(p);
+    cfg.block_size = LOCAL_KSMPS(p);
+    p->numouts = _GetOutputArgCnt(csound, p);
+    p->kfreq = (MYFLT *)p->args[0];
+    p->kconf = (MYFLT *)p->args[1];
+    p->kvoiced = (MYFLT *)p->args[2];
+    p->klatency = p->numouts > 3 ? (MYFLT *)p->args[3] : NULL;
+    p->asig = (MYFLT *)p->args[p->numouts];
+    p->ctrls = &(p->args[p->numouts + 1]);
+    int numargs = _GetInputArgCnt(csound, p) - 1;
+    p->last_freq = 0.;
+    p->last_conf = 0.;
+    p->last_voiced = 0.;
+    if(pyin_parse_params(csound, p->ctrls, numargs, &cfg, NULL) != OK)
+        return NOTOK;
+    pyin_blockmem_alloc(csound, &(p->blockmem), cfg.block_size);
+    p->worker = NULL;
+    if(cfg.async_mode) {
+        // The context is destroyed by the worker thread, so it uses calloc/free
+        // instead of the (not thread-safe) csound allocator
+        PYIN_WORKER *w = pyin_worker(csound);
+        PYINContext *ctx = w != NULL ? pyin_create(cfg, NULL, NULL, NULL) : NULL;
+        if(ctx != NULL && pyin_pool_add(w->pool, ctx)) {
+            p->pyinctx = ctx;
+            p->worker = w;
+            if(p->klatency != NULL)
+                *p->klatency = 0;
+            return OK;
+        }
+        pyin_destroy(ctx);
+        csound->Warning(csound, "pyin: could not start async analysis, running synchronously");
+        cfg.async_mode = false;
     }
     PYINContext *ctx = pyin_create(cfg, (allocfn_t)(csound->Calloc), (freefn_t)csound->Free, csound);
     if(!ctx) {
@@ -169,22 +311,35 @@ static int32_t pyin_init(CSOUND *csound, PYIN_OPCODE *p) {
         return NOTOK;
     }
     p->pyinctx = ctx;
+    if(p->klatency != NULL)
+        *p->klatency = pyin_get_latency(ctx) / cfg.sample_rate;
     return OK;
 }
 
 static int32_t pyin_deinit(CSOUND *csound, PYIN_OPCODE *p) {
-    pyin_destroy(p->pyinctx);
+    if(p->worker != NULL)
+        pyin_pool_release(p->pyinctx);   // destroyed by the worker thread
+    else
+        pyin_destroy(p->pyinctx);
+    p->pyinctx = NULL;
     return OK;
 }
 
 static int32_t pyin_perf(CSOUND *csound, PYIN_OPCODE *p) {
     PYINResult res;
-    float block[512];
+    float *block = (float *)p->blockmem.auxp;
     MYFLT *asig = p->asig;
     for(uint32_t i=0; i < LOCAL_KSMPS(p); i++) {
         block[i] = (float)asig[i];
     }
-    int hasresult = pyin_process_block(p->pyinctx, block, &res);
+    int hasresult;
+    if(p->worker != NULL) {
+        if(pyin_async_push(p->pyinctx, block))
+            csound->NotifyThreadLock(p->worker->wakeup);
+        hasresult = pyin_async_poll(p->pyinctx, &res);
+    } else {
+        hasresult = pyin_process_block(p->pyinctx, block, &res);
+    }
     if(hasresult) {
         p->last_freq = res.pitch_hz;
         p->last_conf = res.confidence;
@@ -193,10 +348,313 @@ static int32_t pyin_perf(CSOUND *csound, PYIN_OPCODE *p) {
     *p->kfreq = p->last_freq;
     *p->kconf = p->last_conf;
     *p->kvoiced = p->last_voiced;
+    if(p->klatency != NULL)
+        *p->klatency = pyin_get_latency(p->pyinctx) / LOCAL_SR(p);
+    return OK;
+}
+
+
+// -------------------------------------------------------------------------------------
+
+// kFreq[], kConf[], kVoiced[] pyin aIn[], [Sarg1, ivalue1, ...]
+//
+// Tracks each channel of an audio array. All channels share one set of
+// lookup tables (HMM transitions, lag interpolation, beta CDF), so the
+// per-channel cost is only the ring buffer, the frame and the trellis
+
+#define PYIN_MAX_CHANNELS 256
+
+typedef struct {
+    OPDS h;
+    ARRAYDAT *kfreq;
+    ARRAYDAT *kconf;
+    ARRAYDAT *kvoiced;
+    ARRAYDAT *ain;
+    void *ctrls[40];
+
+    int numchans;
+    PYINContext *ctxs[PYIN_MAX_CHANNELS];
+    struct PYIN_WORKER_ *worker;   // non-NULL in async mode
+    AUXCH blockmem;     // ksmps floats, see PYIN_OPCODE
+} PYIN_ARRAY;
+
+static int32_t pyin_array_deinit(CSOUND *csound, PYIN_ARRAY *p) {
+    for(int ch=0; ch < p->numchans; ch++) {
+        if(p->worker != NULL)
+            pyin_pool_release(p->ctxs[ch]);
+        else
+            pyin_destroy(p->ctxs[ch]);
+        p->ctxs[ch] = NULL;
+    }
+    p->numchans = 0;
+    return OK;
+}
+
+static int32_t pyin_array_create(CSOUND *csound, PYIN_ARRAY *p, PYINConfig cfg, int numchans) {
+    allocfn_t allocfn = NULL;
+    freefn_t freefn = NULL;
+    if(!cfg.async_mode) {
+        allocfn = (allocfn_t)(csound->Calloc);
+        freefn = (freefn_t)csound->Free;
+    }
+    PYINTables *tables = pyin_tables_create(cfg, allocfn, freefn, csound);
+    if(tables == NULL)
+        return NOTOK;
+    for(int ch=0; ch < numchans; ch++) {
+        PYINContext *ctx = pyin_create_shared(cfg, tables, allocfn, freefn, csound);
+        if(ctx == NULL)
+            break;
+        if(p->worker != NULL && !pyin_pool_add(p->worker->pool, ctx)) {
+            pyin_destroy(ctx);
+            break;
+        }
+        p->ctxs[p->numchans++] = ctx;
+    }
+    // each context holds its own reference
+    pyin_tables_release(tables);
+    if(p->numchans < numchans) {
+        pyin_array_deinit(csound, p);
+        return NOTOK;
+    }
+    return OK;
+}
+
+static int32_t pyin_array_init(CSOUND *csound, PYIN_ARRAY *p) {
+    PYINConfig cfg = pyin_config_default();
+    cfg.sample_rate = LOCAL_SR(p);
+    cfg.block_size = LOCAL_KSMPS(p);
+    int numargs = _GetInputArgCnt(csound, p) - 1;
+    if(pyin_parse_params(csound, p->ctrls, numargs, &cfg, NULL) != OK)
+        return NOTOK;
+    if(p->ain->dimensions != 1)
+        return INITERR("Only 1D audio arrays supported");
+    int numchans = p->ain->sizes[0];
+    if(numchans < 1 || numchans > PYIN_MAX_CHANNELS)
+        return INITERRF("Invalid number of channels: %d (max. %d)", numchans, PYIN_MAX_CHANNELS);
+    pyin_blockmem_alloc(csound, &(p->blockmem), cfg.block_size);
+    p->numchans = 0;
+    p->worker = NULL;
+    if(cfg.async_mode) {
+        // Contexts are destroyed by the worker thread, see pyin_init
+        p->worker = pyin_worker(csound);
+        if(p->worker == NULL || pyin_array_create(csound, p, cfg, numchans) != OK) {
+            csound->Warning(csound, "pyin: could not start async analysis, running synchronously");
+            p->worker = NULL;
+            cfg.async_mode = false;
+        }
+    }
+    if(p->numchans == 0 && pyin_array_create(csound, p, cfg, numchans) != OK)
+        return INITERR("Error while creating PYIN context");
+    tabinit_compat(csound, p->kfreq, numchans, &(p->h));
+    tabinit_compat(csound, p->kconf, numchans, &(p->h));
+    tabinit_compat(csound, p->kvoiced, numchans, &(p->h));
+    for(int ch=0; ch < numchans; ch++) {
+        p->kfreq->data[ch] = 0;
+        p->kconf->data[ch] = 0;
+        p->kvoiced->data[ch] = 0;
+    }
+    return OK;
+}
+
+static int32_t pyin_array_perf(CSOUND *csound, PYIN_ARRAY *p) {
+    PYINResult res;
+    float *block = (float *)p->blockmem.auxp;
+    const uint32_t ksmps = LOCAL_KSMPS(p);
+    int numchans = p->ain->sizes[0];
+    if(numchans > p->numchans)
+        numchans = p->numchans;
+    int notify = 0;
+    for(int ch=0; ch < numchans; ch++) {
+        MYFLT *asig = p->ain->data + ch * ksmps;
+        for(uint32_t i=0; i < ksmps; i++) {
+            block[i] = (float)asig[i];
+        }
+        int hasresult;
+        if(p->worker != NULL) {
+            notify |= pyin_async_push(p->ctxs[ch], block);
+            hasresult = pyin_async_poll(p->ctxs[ch], &res);
+        } else {
+            hasresult = pyin_process_block(p->ctxs[ch], block, &res);
+        }
+        if(hasresult) {
+            p->kfreq->data[ch] = res.pitch_hz;
+            p->kconf->data[ch] = res.confidence;
+            p->kvoiced->data[ch] = (MYFLT)res.voiced;
+        }
+    }
+    if(notify)
+        csound->NotifyThreadLock(p->worker->wakeup);
+    return OK;
+}
+
+
+// -------------------------------------------------------------------------------------
+
+// iFreq[], iConf[], iVoiced[] pyinoffline ifn, [Sarg1, ivalue1, ...]
+// iFreq[], iConf[], iVoiced[] pyinoffline Sfile, [Sarg1, ivalue1, ...]
+//
+// Analyses a whole table / soundfile at init time with full Viterbi decoding
+// (see pyin_offline_* in pyinlib.h). Frame i is centred at time i*hop/sr
+
+#define PYIN_MAX_THREADS 64
+
+typedef struct {
+    OPDS h;
+    ARRAYDAT *ofreq;
+    ARRAYDAT *oconf;
+    ARRAYDAT *ovoiced;
+    void *src;
+    void *ctrls[40];
+} PYIN_OFFLINE;
+
+typedef struct {
+    PYINOffline *off;
+    int worker;
+    int phase;
+} PYIN_OFFLINE_JOB;
+
+static uintptr_t pyin_offline_thread(void *data) {
+    PYIN_OFFLINE_JOB *job = (PYIN_OFFLINE_JOB *)data;
+    if(job->phase == 0)
+        pyin_offline_observe(job->off, job->worker);
+    else
+        pyin_offline_refine(job->off, job->worker);
+    return 0;
+}
+
+// Run one parallel phase. Frames are handed out dynamically, so if a thread
+// cannot be created the remaining workers take over its share
+static void pyin_offline_phase(CSOUND *csound, PYINOffline *off, int numthreads, int phase) {
+    PYIN_OFFLINE_JOB jobs[PYIN_MAX_THREADS];
+    void *threads[PYIN_MAX_THREADS];
+    for(int i=0; i < numthreads; i++) {
+        jobs[i].off = off;
+        jobs[i].worker = i;
+        jobs[i].phase = phase;
+    }
+    for(int i=1; i < numthreads; i++)
+        threads[i] = csound->CreateThread(pyin_offline_thread, &jobs[i]);
+    pyin_offline_thread(&jobs[0]);
+    for(int i=1; i < numthreads; i++) {
+        if(threads[i] != NULL)
+            csound->JoinThread(threads[i]);
+    }
+}
+
+// Extract one channel (1-based) or, if channel is 0, the mix of all channels
+static void _deinterleave(float *dst, const MYFLT *src, long numframes, int nchnls, int channel) {
+    if(channel > 0) {
+        for(long i=0; i < numframes; i++)
+            dst[i] = (float)src[i*nchnls + channel - 1];
+        return;
+    }
+    for(long i=0; i < numframes; i++) {
+        MYFLT sum = 0;
+        for(int ch=0; ch < nchnls; ch++)
+            sum += src[i*nchnls + ch];
+        dst[i] = (float)(sum / nchnls);
+    }
+}
+
+static float *pyin_load_table(CSOUND *csound, MYFLT ifn, int channel, long *numframes, MYFLT *sr) {
+    FUNC *ftp = csound->FTFind(csound, &ifn);
+    if(ftp == NULL) {
+        INITERRF("Table %d not found", (int)ifn);
+        return NULL;
+    }
+    int nchnls = ftp->nchanls > 0 ? ftp->nchanls : 1;
+    if(channel > nchnls) {
+        INITERRF("Channel %d out of range, table has %d channels", channel, nchnls);
+        return NULL;
+    }
+    *numframes = ftp->flen / nchnls;
+    *sr = ftp->gen01args.sample_rate > 0 ? ftp->gen01args.sample_rate : csound->GetSr(csound);
+    float *samples = csound->Malloc(csound, sizeof(float) * (*numframes + 1));
+    _deinterleave(samples, ftp->ftable, *numframes, nchnls, channel);
+    return samples;
+}
+
+static float *pyin_load_soundfile(CSOUND *csound, const char *path, int channel, long *numframes, MYFLT *sr) {
+    SF_INFO sfinfo;
+    memset(&sfinfo, 0, sizeof(SF_INFO));
+    SNDFILE *file = sf_open(path, SFM_READ, &sfinfo);
+    if(file == NULL) {
+        INITERRF("Not able to open input file %s", path);
+        return NULL;
+    }
+    if(channel > sfinfo.channels) {
+        sf_close(file);
+        INITERRF("Channel %d out of range, %s has %d channels", channel, path, sfinfo.channels);
+        return NULL;
+    }
+    MYFLT *interleaved = csound->Malloc(csound, sizeof(MYFLT) * (sfinfo.frames * sfinfo.channels + 1));
+#ifdef USE_DOUBLE
+    sf_count_t read = sf_readf_double(file, interleaved, sfinfo.frames);
+#else
+    sf_count_t read = sf_readf_float(file, interleaved, sfinfo.frames);
+#endif
+    sf_close(file);
+    float *samples = csound->Malloc(csound, sizeof(float) * (read + 1));
+    _deinterleave(samples, interleaved, (long)read, sfinfo.channels, channel);
+    csound->Free(csound, interleaved);
+    *numframes = (long)read;
+    *sr = (MYFLT)sfinfo.samplerate;
+    return samples;
+}
+
+static int32_t pyinoffline_init(CSOUND *csound, PYIN_OFFLINE *p, int32_t isfile) {
+    PYINConfig cfg = pyin_config_default();
+    PYIN_OFFLINE_OPTS opts = {4, 0};
+    int numargs = _GetInputArgCnt(csound, p) - 1;
+    if(pyin_parse_params(csound, p->ctrls, numargs, &cfg, &opts) != OK)
+        return NOTOK;
+    if(opts.threads < 1)
+        opts.threads = 1;
+    else if(opts.threads > PYIN_MAX_THREADS)
+        opts.threads = PYIN_MAX_THREADS;
+    if(opts.channel < 0)
+        return INITERRF("Invalid channel: %d", opts.channel);
+
+    long numframes = 0;
+    MYFLT sr = 0;
+    float *samples = isfile
+        ? pyin_load_soundfile(csound, ((STRINGDAT *)p->src)->data, opts.channel, &numframes, &sr)
+        : pyin_load_table(csound, *(MYFLT *)p->src, opts.channel, &numframes, &sr);
+    if(samples == NULL)
+        return NOTOK;
+    cfg.sample_rate = sr;
+
+    PYINOffline *off = pyin_offline_create(cfg, samples, numframes, opts.threads);
+    if(off == NULL) {
+        csound->Free(csound, samples);
+        return INITERR("Error while creating PYIN context, check the parameters");
+    }
+    pyin_offline_phase(csound, off, opts.threads, 0);
+    pyin_offline_decode(off);
+    pyin_offline_phase(csound, off, opts.threads, 1);
+
+    int n = pyin_offline_num_frames(off);
+    const PYINResult *results = pyin_offline_results(off);
+    tabinit_compat(csound, p->ofreq, n, &(p->h));
+    tabinit_compat(csound, p->oconf, n, &(p->h));
+    tabinit_compat(csound, p->ovoiced, n, &(p->h));
+    for(int i=0; i < n; i++) {
+        p->ofreq->data[i] = results[i].pitch_hz;
+        p->oconf->data[i] = results[i].confidence;
+        p->ovoiced->data[i] = (MYFLT)results[i].voiced;
+    }
+    pyin_offline_destroy(off);
+    csound->Free(csound, samples);
     return OK;
 }
 
+static int32_t pyinoffline_table(CSOUND *csound, PYIN_OFFLINE *p) {
+    return pyinoffline_init(csound, p, 0);
+}
 
+static int32_t pyinoffline_file(CSOUND *csound, PYIN_OFFLINE *p) {
+    return pyinoffline_init(csound, p, 1);
+}
 
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -208,7 +666,11 @@ static int32_t pyin_perf(CSOUND *csound, PYIN_OPCODE *p) {
 static OENTRY localops[] = {};
 #else
 static OENTRY localops[] = {
-  { "pyin", S(PYIN_OPCODE), 0, "kkk", "a*", (SUBR)pyin_init, (SUBR)pyin_perf, (SUBR)pyin_deinit, NULL, 0}
+  { "pyin", S(PYIN_OPCODE), 0, "kkk", "a*", (SUBR)pyin_init, (SUBR)pyin_perf, (SUBR)pyin_deinit, NULL, 0},
+  { "pyin.latency", S(PYIN_OPCODE), 0, "kkkk", "a*", (SUBR)pyin_init, (SUBR)pyin_perf, (SUBR)pyin_deinit, NULL, 0},
+  { "pyin.arr", S(PYIN_ARRAY), 0, "k[]k[]k[]", "a[]*", (SUBR)pyin_array_init, (SUBR)pyin_array_perf, (SUBR)pyin_array_deinit, NULL, 0},
+  { "pyinoffline.i", S(PYIN_OFFLINE), 0, "i[]i[]i[]", "i*", (SUBR)pyinoffline_table, NULL, NULL, NULL, 0},
+  { "pyinoffline.S", S(PYIN_OFFLINE), 0, "i[]i[]i[]", "S*", (SUBR)pyinoffline_file, NULL, NULL, NULL, 0}
 };
 #endif
 
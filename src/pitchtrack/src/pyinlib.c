@@ -36,6 +36,47 @@
 // #include <assert.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <limits.h>
+
+#if defined(_MSC_VER)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#endif
+
+/* ── Atomics (async mode) ───────────────────────────────────────────────── */
+
+#if defined(_MSC_VER)
+static inline uint32_t atomic_load_u32(uint32_t *p)
+{ return (uint32_t)InterlockedCompareExchange((volatile LONG *)p, 0, 0); }
+static inline void atomic_store_u32(uint32_t *p, uint32_t v)
+{ InterlockedExchange((volatile LONG *)p, (LONG)v); }
+static inline void *atomic_load_ptr(void **p)
+{ return InterlockedCompareExchangePointer((PVOID volatile *)p, NULL, NULL); }
+static inline void atomic_store_ptr(void **p, void *v)
+{ InterlockedExchangePointer((PVOID volatile *)p, v); }
+static inline bool atomic_cas_ptr(void **p, void *expected, void *desired)
+{ return InterlockedCompareExchangePointer((PVOID volatile *)p, desired, expected) == expected; }
+static inline uint32_t atomic_fetch_add_u32(uint32_t *p, uint32_t v)
+{ return (uint32_t)InterlockedExchangeAdd((volatile LONG *)p, (LONG)v); }
+static inline void atomic_fence(void) { MemoryBarrier(); }
+#else
+static inline uint32_t atomic_load_u32(uint32_t *p)
+{ return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static inline void atomic_store_u32(uint32_t *p, uint32_t v)
+{ __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+static inline void *atomic_load_ptr(void **p)
+{ return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static inline void atomic_store_ptr(void **p, void *v)
+{ __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+static inline bool atomic_cas_ptr(void **p, void *expected, void *desired)
+{ return __atomic_compare_exchange_n(p, &expected, desired, false,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); }
+static inline uint32_t atomic_fetch_add_u32(uint32_t *p, uint32_t v)
+{ return __atomic_fetch_add(p, v, __ATOMIC_ACQ_REL); }
+static inline void atomic_fence(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+#endif
 
 /* ── Internal fixed constants ───────────────────────────────────────────── */
 
@@ -44,6 +85,11 @@
 
 #define VITERBI_DEPTH       20
 
+/* Destination states per tile of the voiced Viterbi kernel.  The running
+ * best score / predecessor of a tile stay in L1 (2 KB) while the band is
+ * walked, see viterbi_voiced */
+#define VITERBI_TILE        256
+
 #define HMM_MIDI_MIN        21
 #define HMM_SEMITONES       88
 
@@ -132,12 +178,12 @@ static inline void ring_push(RingBuffer *r, const float *src, int n)
     r->write += (uint32_t)n;
 }
 
-static inline void ring_read_latest(const RingBuffer *r, float *dst, int len)
+/* Copy len samples starting at absolute write position `start` */
+static inline void ring_read_at(const RingBuffer *r, float *dst, uint32_t start, int len)
 {
-    // assert((uint32_t)len <= r->fill);
     uint32_t cap   = r->cap;
     uint32_t mask  = cap - 1;
-    uint32_t start = (r->write - (uint32_t)len) & mask;
+    start &= mask;
 
     uint32_t chunk1 = cap - start;   // floats available before wrap
     if ((uint32_t)len <= chunk1) {
@@ -149,6 +195,12 @@ static inline void ring_read_latest(const RingBuffer *r, float *dst, int len)
     }
 }
 
+static inline void ring_read_latest(const RingBuffer *r, float *dst, int len)
+{
+    // assert((uint32_t)len <= r->fill);
+    ring_read_at(r, dst, r->write - (uint32_t)len, len);
+}
+
 void *_calloc(allocfn_t allocfn, void *ctx, size_t n, size_t size) {
     if(ctx && allocfn) {
         return allocfn(ctx, n*size);
@@ -171,20 +223,29 @@ void _free(freefn_t freefn, void *ctx, void *ptr) {
  * n_total = n_pitched + 1.
  * The unvoiced state is always the last index: UNVOICED_IDX = n_pitched.
  *
- * Trellis arrays are flat [VITERBI_DEPTH × n_total].
- * back[] stores int16 predecessor indices; n_total ≤ 1761, fits in int16.
+ * score[] is flat [VITERBI_DEPTH × n_total].
+ *
+ * Backpointers are stored compactly.  A voiced destination s can only be
+ * reached from a voiced state inside its band or from the unvoiced state,
+ * so back[] stores the band offset f - s + band_half (or BACK_FROM_UV) in
+ * one byte, or two if the band is wider than 254 states (back_size).  The
+ * unvoiced destination can be reached from any state; its predecessor is
+ * stored as an absolute index in back_uv[], one per column.
  */
 typedef struct {
-    float   *score;          /* [VITERBI_DEPTH * n_total]       */
-    int16_t *back;           /* [VITERBI_DEPTH * n_total]       */
+    float   *score;          /* [VITERBI_DEPTH * n_total]           */
+    uint8_t *back;           /* [VITERBI_DEPTH * n_pitched * back_size] */
+    int16_t *back_uv;        /* [VITERBI_DEPTH]                     */
     int      head;
     int      filled;
 
     int      n_pitched;      /* number of voiced pitch states   */
     int      n_total;        /* n_pitched + 1  (includes unvoiced) */
     int      band_half;
+    int      back_size;      /* bytes per backpointer, 1 or 2   */
 
-    /* Voiced↔voiced transition band (shift-invariant Gaussian) */
+    /* Voiced↔voiced transition band (shift-invariant Gaussian),
+     * shared, see hmm_init_transitions */
     float   *log_trans_band; /* [2*band_half + 1]               */
 
     /* Voiced↔unvoiced / unvoiced↔voiced scalar log-probs */
@@ -196,28 +257,50 @@ typedef struct {
 } HMM;
 
 #define HMM_SCORE(h, slot, s)  (h)->score[(slot) * (h)->n_total + (s)]
-#define HMM_BACK(h, slot, s)   (h)->back [(slot) * (h)->n_total + (s)]
+#define HMM_BACK(h, slot)      ((h)->back + (size_t)(slot) * (h)->n_pitched * (h)->back_size)
+
+/* Backpointer code of a voiced destination reached from the unvoiced state */
+#define BACK_FROM_UV(h)        ((h)->back_size == 1 ? 0xFF : 0xFFFF)
+
+static inline int back_load(const HMM *h, const uint8_t *back, int s)
+{
+    return h->back_size == 1 ? back[s] : ((const uint16_t *)back)[s];
+}
+
+/* Predecessor of voiced state s given its backpointer code */
+static inline int back_state(const HMM *h, int s, int code)
+{
+    return code == BACK_FROM_UV(h) ? h->n_pitched : s + code - h->band_half;
+}
 
 #define MAX_BANDWIDTH 8192
 
-static bool hmm_alloc(HMM *h, int n_pitched, int band_half,
-                      float state_cents, float voiced_transition_weight,
-                      double sigma_cents, allocfn_t alloc_fn, void *alloc_ctx)
+/*
+ * The transition model (band + scalars) only depends on the config and is
+ * shared by all contexts created from the same PYINTables; each context
+ * owns its trellis (score/back), see hmm_alloc_trellis.
+ */
+static bool hmm_init_transitions(HMM *h, int n_pitched, int band_half,
+                                 float state_cents, float voiced_transition_weight,
+                                 double sigma_cents, allocfn_t alloc_fn, void *alloc_ctx)
 {
     h->n_pitched = n_pitched;
     h->n_total   = n_pitched + 1;      /* +1 for the unvoiced state */
     h->band_half = band_half;
     h->head      = 0;
     h->filled    = 0;
+    h->score     = NULL;
+    h->back      = NULL;
+    h->back_uv   = NULL;
 
     int band_width = 2 * band_half + 1;
     if(band_width > MAX_BANDWIDTH)
         return false;
+    /* codes 0 … band_width-1, plus BACK_FROM_UV */
+    h->back_size = band_width < 0xFF ? 1 : 2;
 
     h->log_trans_band = (float*)_calloc(alloc_fn, alloc_ctx, band_width, sizeof(float));
-    h->score = (float *)_calloc(alloc_fn, alloc_ctx, VITERBI_DEPTH * h->n_total, sizeof(float));
-    h->back = (int16_t *)_calloc(alloc_fn, alloc_ctx, VITERBI_DEPTH * h->n_total, sizeof(int16_t));
-    if (!h->score || !h->back || !h->log_trans_band) return false;
+    if (!h->log_trans_band) return false;
 
     /* ── Voiced→voiced Gaussian band ────────────────────────────────────
      *
@@ -280,14 +363,23 @@ static bool hmm_alloc(HMM *h, int n_pitched, int band_half,
     return true;
 }
 
+static bool hmm_alloc_trellis(HMM *h, const HMM *trans, allocfn_t alloc_fn, void *alloc_ctx)
+{
+    *h = *trans;
+    h->score   = (float *)_calloc(alloc_fn, alloc_ctx, VITERBI_DEPTH * h->n_total, sizeof(float));
+    h->back    = (uint8_t *)_calloc(alloc_fn, alloc_ctx, VITERBI_DEPTH * h->n_pitched, h->back_size);
+    h->back_uv = (int16_t *)_calloc(alloc_fn, alloc_ctx, VITERBI_DEPTH, sizeof(int16_t));
+    return h->score && h->back && h->back_uv;
+}
+
 static void hmm_free(HMM *h)
 {
     free(h->score);
     free(h->back);
-    free(h->log_trans_band);
+    free(h->back_uv);
     h->score          = NULL;
     h->back           = NULL;
-    h->log_trans_band = NULL;
+    h->back_uv        = NULL;
 }
 
 static void hmm_clear(HMM *h)
@@ -295,7 +387,8 @@ static void hmm_clear(HMM *h)
     if (h->score) memset(h->score, 0,
                          (size_t)(VITERBI_DEPTH * h->n_total) * sizeof(float));
     if (h->back)  memset(h->back,  0,
-                         (size_t)(VITERBI_DEPTH * h->n_total) * sizeof(int16_t));
+                         (size_t)(VITERBI_DEPTH * h->n_pitched * h->back_size));
+    if (h->back_uv) memset(h->back_uv, 0, VITERBI_DEPTH * sizeof(int16_t));
     h->head   = 0;
     h->filled = 0;
 }
@@ -311,75 +404,206 @@ static void hmm_clear(HMM *h)
  *   voiced s  → unvoiced   : log_p_vu
  *   unvoiced  → voiced s'  : log_p_uv  (same for every s')
  *   unvoiced  → unvoiced   : log_p_uu
+ *
+ * The column kernels viterbi_voiced/viterbi_unvoiced compute one trellis
+ * column from the previous one; they are shared by the windowed realtime
+ * trellis and the full offline decoder (pyin_offline_*).
+ *
+ * The realtime step is split so it can be spread over several calls:
+ *   hmm_step_voiced(s_begin, s_end)  – voiced destinations in [s_begin, s_end)
+ *   hmm_step_unvoiced()              – the unvoiced destination
+ *   hmm_advance()                    – commit the new trellis column
+ * analysis_run() calls them in this order, the voiced step possibly spread
+ * over several calls.
  */
-static void hmm_push(HMM *h, const float *log_obs)
+/* Store the backpointer codes of count destinations starting at s */
+static inline void back_store(const HMM *h, uint8_t *back, int s,
+                              const int32_t *code, int count)
 {
-    int np  = h->n_pitched;
-    int nu  = h->n_total;        /* = np + 1              */
-    int uv  = np;                /* index of unvoiced state */
-    int bh  = h->band_half;
-    int cur  = h->head;
-    int prev = (cur - 1 + VITERBI_DEPTH) % VITERBI_DEPTH;
+    if (h->back_size == 1) {
+        for (int l = 0; l < count; l++)
+            back[s + l] = (uint8_t)code[l];
+    } else {
+        uint16_t *back16 = (uint16_t *)back;
+        for (int l = 0; l < count; l++)
+            back16[s + l] = (uint16_t)code[l];
+    }
+}
 
-    if (h->filled == 0) {
-        /* Uniform prior over all states (voiced + unvoiced) */
-        float log_prior = -logf((float)nu);
-        for (int s = 0; s < nu; s++) {
-            HMM_SCORE(h, cur, s) = log_prior + log_obs[s];
-            HMM_BACK (h, cur, s) = (int16_t)s;
+/* One voiced destination whose band is clipped by the edges of the pitch
+ * range, or which does not fill a block of lanes */
+static inline void viterbi_voiced_scalar(const HMM *h, const float * restrict prev,
+                                         float * restrict cur, uint8_t *back,
+                                         const float *log_obs, int s)
+{
+    const int np = h->n_pitched;
+    const int bh = h->band_half;
+    const float * restrict log_trans_band = h->log_trans_band;
+    float   best = -1e30f;
+    int32_t code = 0;
+
+    /* From voiced states (banded Gaussian) */
+    int f_lo = s - bh; if (f_lo < 0)   f_lo = 0;
+    int f_hi = s + bh; if (f_hi >= np) f_hi = np - 1;
+    for (int f = f_lo; f <= f_hi; f++) {
+        float v = prev[f] + log_trans_band[(f - s) + bh];
+        int cond = v > best;
+        best = cond ? v : best;
+        code = cond ? (f - s) + bh : code;
+    }
+
+    /* From unvoiced state */
+    float v = prev[np] + h->log_p_uv;
+    if (v > best) { best = v; code = BACK_FROM_UV(h); }
+
+    cur[s] = best + log_obs[s];
+    back_store(h, back, s, &code, 1);
+}
+
+/*
+ * Voiced destinations [s_begin, s_end).
+ *
+ * Destinations whose band lies entirely inside the pitch range are
+ * processed in tiles of up to VITERBI_TILE states: the outer loop walks the
+ * band, the inner loop the destinations of the tile.  The inner loop is an
+ * add, a compare and two selects over contiguous arrays, which the compiler
+ * vectorises (8 destinations per AVX instruction, 4 with SSE / NEON), the
+ * compare mask giving the argmax without branches.  The band is walked
+ * from the lowest source upwards and only a strictly better score replaces
+ * the running best, so ties resolve exactly as in the scalar loop.
+ */
+static void viterbi_voiced(const HMM *h, const float * restrict prev,
+                           float * restrict cur, uint8_t *back,
+                           const float *log_obs, int s_begin, int s_end)
+{
+    const int np = h->n_pitched;
+    const int bh = h->band_half;
+    const int bw = 2 * bh + 1;
+    const float * restrict log_trans_band = h->log_trans_band;
+    const float   from_uv   = prev[np] + h->log_p_uv;
+    const int32_t code_uv   = BACK_FROM_UV(h);
+
+    /* Interior: the whole band [s - bh, s + bh] is inside [0, np) */
+    int in_lo = bh < s_begin ? s_begin : bh;
+    int in_hi = np - bh < s_end ? np - bh : s_end;
+    if (in_hi < in_lo) in_hi = in_lo = s_end;
+
+    int s = s_begin;
+    for (; s < in_lo; s++)
+        viterbi_voiced_scalar(h, prev, cur, back, log_obs, s);
+
+    float   best[VITERBI_TILE];
+    int32_t code[VITERBI_TILE];
+    for (; s < in_hi; s += VITERBI_TILE) {
+        const int n = in_hi - s < VITERBI_TILE ? in_hi - s : VITERBI_TILE;
+        const float * restrict src = prev + (s - bh);
+        for (int l = 0; l < n; l++) {
+            best[l] = -1e30f;
+            code[l] = 0;
         }
-    } else {
-        /* ── Voiced destination states ────────────────────────────────── */
-        const float * restrict log_trans_band = h->log_trans_band;
-        for (int s = 0; s < np; s++) {
-            float best      = -1e30f;
-            int   best_from = 0;
-
-            /* From voiced states (banded Gaussian) */
-            int f_lo = s - bh; if (f_lo < 0)   f_lo = 0;
-            int f_hi = s + bh; if (f_hi >= np)  f_hi = np - 1;
-
-            for (int f = f_lo; f <= f_hi; f++) {
-                float v = HMM_SCORE(h, prev, f)
-                        + log_trans_band[(f - s) + bh];
-                best = v > best ? v : best;
-                best_from = v > best ? f : best_from;
-                // if (v > best) { best = v; best_from = f; }
+        for (int c = 0; c < bw; c++) {
+            const float w = log_trans_band[c];
+            const float * restrict src_c = src + c;
+            for (int l = 0; l < n; l++) {
+                float v  = src_c[l] + w;
+                int cond = v > best[l];
+                best[l]  = cond ? v : best[l];
+                code[l]  = cond ? c : code[l];
             }
+        }
+        for (int l = 0; l < n; l++) {
+            int cond = from_uv > best[l];
+            best[l]  = cond ? from_uv : best[l];
+            code[l]  = cond ? code_uv : code[l];
+            cur[s + l] = best[l] + log_obs[s + l];
+        }
+        back_store(h, back, s, code, n);
+    }
 
-            /* From unvoiced state */
-            {
-                float v = HMM_SCORE(h, prev, uv) + h->log_p_uv;
-                if (v > best) { best = v; best_from = uv; }
-            }
+    for (s = in_hi; s < s_end; s++)
+        viterbi_voiced_scalar(h, prev, cur, back, log_obs, s);
+}
 
-            HMM_SCORE(h, cur, s) = best + log_obs[s];
-            HMM_BACK (h, cur, s) = (int16_t)best_from;
+/*
+ * The unvoiced destination: max over all voiced states at the flat cost
+ * p_vu.  Since the cost is the same for every source this is the maximum
+ * of prev[] (a vectorised reduction) and the predecessor its first
+ * occurrence, located a block at a time.
+ */
+static void viterbi_unvoiced(const HMM *h, const float * restrict prev,
+                             float * restrict cur, int16_t *back_uv,
+                             const float *log_obs)
+{
+    const int np = h->n_pitched;
+    const int uv = np;
+
+    float top = -1e30f;
+    for (int f = 0; f < np; f++)
+        top = prev[f] > top ? prev[f] : top;
+
+    int best_from = 0;
+    for (int f = 0; f < np; f += 16) {
+        const int n = np - f < 16 ? np - f : 16;
+        int hit = 0;
+        for (int l = 0; l < n; l++)
+            hit |= prev[f + l] == top;
+        if (hit) {
+            while (prev[f] != top) f++;
+            best_from = f;
+            break;
         }
+    }
+    float best = top + h->log_p_vu;
 
-        /* ── Unvoiced destination state ───────────────────────────────── */
-        {
-            float best      = -1e30f;
-            int   best_from = 0;
+    /* From unvoiced state */
+    {
+        float v = prev[uv] + h->log_p_uu;
+        if (v > best) { best = v; best_from = uv; }
+    }
 
-            /* From any voiced state (flat cost p_vu, not banded) */
-            for (int f = 0; f < np; f++) {
-                float v = HMM_SCORE(h, prev, f) + h->log_p_vu;
-                if (v > best) { best = v; best_from = f; }
-            }
+    cur[uv]  = best + log_obs[uv];
+    *back_uv = (int16_t)best_from;
+}
 
-            /* From unvoiced state */
-            {
-                float v = HMM_SCORE(h, prev, uv) + h->log_p_uu;
-                if (v > best) { best = v; best_from = uv; }
-            }
+static void hmm_step_voiced(HMM *h, const float *log_obs, int s_begin, int s_end)
+{
+    int cur  = h->head;
+    int prev = (cur - 1 + VITERBI_DEPTH) % VITERBI_DEPTH;
 
-            HMM_SCORE(h, cur, uv) = best + log_obs[uv];
-            HMM_BACK (h, cur, uv) = (int16_t)best_from;
+    if (h->filled == 0) {
+        /* Uniform prior over all states (voiced + unvoiced) */
+        float log_prior = -logf((float)h->n_total);
+        int32_t self = h->band_half;
+        for (int s = s_begin; s < s_end; s++) {
+            HMM_SCORE(h, cur, s) = log_prior + log_obs[s];
+            back_store(h, HMM_BACK(h, cur), s, &self, 1);
         }
+        return;
+    }
+
+    viterbi_voiced(h, &HMM_SCORE(h, prev, 0), &HMM_SCORE(h, cur, 0),
+                   HMM_BACK(h, cur), log_obs, s_begin, s_end);
+}
+
+static void hmm_step_unvoiced(HMM *h, const float *log_obs)
+{
+    int uv  = h->n_pitched;
+    int cur  = h->head;
+    int prev = (cur - 1 + VITERBI_DEPTH) % VITERBI_DEPTH;
+
+    if (h->filled == 0) {
+        HMM_SCORE(h, cur, uv) = -logf((float)h->n_total) + log_obs[uv];
+        h->back_uv[cur] = (int16_t)uv;
+        return;
     }
 
-    h->head   = (cur + 1) % VITERBI_DEPTH;
+    viterbi_unvoiced(h, &HMM_SCORE(h, prev, 0), &HMM_SCORE(h, cur, 0),
+                     &h->back_uv[cur], log_obs);
+}
+
+static inline void hmm_advance(HMM *h)
+{
+    h->head   = (h->head + 1) % VITERBI_DEPTH;
     h->filled = (h->filled < VITERBI_DEPTH) ? h->filled + 1 : VITERBI_DEPTH;
 }
 
@@ -646,26 +870,21 @@ static FORCE_INLINE float dot_product(const float * restrict a,
 }
 
 /*
- * compute_diff — YIN difference function with auto-vectorization.
+ * compute_diff_range — YIN difference function with auto-vectorization,
+ * for lags [tau_begin, tau_end).
  *
- * Precondition: `frame` must be allocated with 32-byte alignment.
- * e.g.  float *frame = aligned_alloc(32, W * sizeof(float));
+ * *r_x / *r_y hold the running sub-window energies for lag tau_begin - 1
+ * (both equal to the full-frame energy before lag 1) and are updated in
+ * place, so consecutive ranges can be computed in separate calls.
  */
-static void compute_diff(const float * restrict frame, int W,
-                         float       * restrict diff,  int max_lag)
+static void compute_diff_range(const float * restrict frame, int W,
+                               float * restrict diff, int tau_begin, int tau_end,
+                               float *r_x_io, float *r_y_io)
 {
-    // const float *af = ASSUME_ALIGNED(frame, 32);
     const float *af = frame;
-    /* --- full-frame energy r_x(0) = r_y(0) --- */
-    float r_x = 0.0f, r_y = 0.0f;
-    for (int j = 0; j < W; j++) {
-        float xj = af[j];
-        r_x += xj * xj;            /* auto-vectorizes: simple reduce */
-    }
-    r_y  = r_x;
-    diff[0] = 0.0f;
+    float r_x = *r_x_io, r_y = *r_y_io;
 
-    for (int tau = 1; tau <= max_lag; tau++) {
+    for (int tau = tau_begin; tau < tau_end; tau++) {
         /* O(1) energy updates — intentionally scalar, no loop to vectorize */
         float drop_left  = af[W - tau];
         float drop_right = af[tau - 1];
@@ -679,8 +898,20 @@ static void compute_diff(const float * restrict frame, int W,
         diff[tau] = r_x + r_y - 2.0f * rt;
     }
 
+    *r_x_io = r_x;
+    *r_y_io = r_y;
 }
 
+/* Full-frame energy r_x(0) = r_y(0), the starting point of compute_diff_range */
+static inline float frame_energy(const float * restrict frame, int W)
+{
+    float r = 0.0f;
+    for (int j = 0; j < W; j++) {
+        float xj = frame[j];
+        r += xj * xj;              /* auto-vectorizes: simple reduce */
+    }
+    return r;
+}
 
 static void compute_diff0(const float * restrict frame, int W,
                          float * restrict diff, int max_lag)
@@ -743,6 +974,210 @@ static void compute_diff0(const float * restrict frame, int W,
     }
 }
 
+/* ── FFT autocorrelation ────────────────────────────────────────────────── */
+
+/*
+ * For large frames the O(W × lag_max) cross-product dominates the analysis
+ * (framesize 4096 at fmin 40 Hz is ~4.5M multiply-adds per frame).  The
+ * lagged cross-product of the zero-padded frame is its linear
+ * autocorrelation, which can be obtained in O(N log N) as
+ *
+ *   r(τ) = IFFT(|FFT(x)|²)[τ]
+ *
+ * N = next_pow2(W + lag_max) is the smallest power of two for which the
+ * circular correlation does not wrap into the lags we read back.
+ *
+ * The real transform of size N is done with a complex transform of size
+ * M = N/2 on z[n] = x[2n] + i·x[2n+1]; since z is stored interleaved, the
+ * packed input is simply the frame itself.  Everything is computed in double
+ * precision so the result matches the direct path up to float rounding.
+ *
+ * The computation is split into fft_autocorr_nsteps() steps of similar
+ * cost (one per butterfly pass) so that it can be spread over several calls.
+ */
+typedef struct {
+    int     n;          /* real transform size N                     */
+    int     m;          /* complex transform size M = N/2            */
+    int     log2m;
+    double *mem;        /* single allocation for the arrays below    */
+    double *twr;        /* [M]    cos(2πk/N)                         */
+    double *twi;        /* [M]    sin(2πk/N)                         */
+    double *work;       /* [2*M]  interleaved re/im                  */
+    double *power;      /* [M+1]  |X[k]|², k = 0 … N/2               */
+} FFTAutocorr;
+
+static bool fft_autocorr_alloc(FFTAutocorr *f, int n, allocfn_t allocfn, void *allocdata)
+{
+    const int m = n / 2;
+    f->n = n;
+    f->m = m;
+    f->log2m = 0;
+    while ((1 << f->log2m) < m) f->log2m++;
+    f->mem = (double *)_calloc(allocfn, allocdata, (size_t)m * 5 + 1, sizeof(double));
+    if (!f->mem) return false;
+    f->twr   = f->mem;
+    f->twi   = f->twr + m;
+    f->work  = f->twi + m;
+    f->power = f->work + 2 * m;
+    for (int k = 0; k < m; k++) {
+        double phase = 2.0 * M_PI * (double)k / (double)n;
+        f->twr[k] = cos(phase);
+        f->twi[k] = sin(phase);
+    }
+    return true;
+}
+
+/* Bit-reversal permutation of M interleaved complex values */
+static void fft_bitrev(double *buf, int m)
+{
+    for (int i = 1, j = 0; i < m; i++) {
+        int bit = m >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            double tr = buf[2*i], ti = buf[2*i+1];
+            buf[2*i]   = buf[2*j];
+            buf[2*i+1] = buf[2*j+1];
+            buf[2*j]   = tr;
+            buf[2*j+1] = ti;
+        }
+    }
+}
+
+/*
+ * One radix-2 butterfly pass (sub-transform length len) of an in-place
+ * complex FFT of size M on bit-reversed interleaved data.
+ * Twiddles come from the size-N table: e^{∓2πij/len} = tw[j · N/len].
+ * The inverse is unnormalised.
+ */
+static void fft_pass(double *buf, int m, int len, const double *twr, const double *twi,
+                     bool inverse)
+{
+    const double sign = inverse ? 1.0 : -1.0;
+    const int half = len >> 1;
+    const int step = 2 * m / len;
+    for (int i = 0; i < m; i += len) {
+        double *a = buf + 2 * i;
+        double *b = a + 2 * half;
+        for (int j = 0; j < half; j++) {
+            double wr = twr[j * step];
+            double wi = sign * twi[j * step];
+            double xr = b[2*j] * wr - b[2*j+1] * wi;
+            double xi = b[2*j] * wi + b[2*j+1] * wr;
+            b[2*j]   = a[2*j]   - xr;
+            b[2*j+1] = a[2*j+1] - xi;
+            a[2*j]   += xr;
+            a[2*j+1] += xi;
+        }
+    }
+}
+
+/*
+ * Unpack the half-size spectrum Z into the power spectrum of x and repack
+ * it for the half-size inverse transform:
+ *
+ *   E[k] = (Z[k] + conj(Z[M-k])) / 2
+ *   O[k] = (Z[k] - conj(Z[M-k])) / 2i
+ *   X[k] = E[k] + e^{-2πik/N} · O[k],   P[k] = |X[k]|²
+ *
+ *   Y[k] = (P[k] + P[M-k])/2 + i · e^{+2πik/N} · (P[k] - P[M-k])/2
+ */
+static void fft_power_repack(FFTAutocorr *f)
+{
+    const int m = f->m;
+    double * restrict z     = f->work;
+    double * restrict power = f->power;
+    const double *twr = f->twr;
+    const double *twi = f->twi;
+
+    power[0] = (z[0] + z[1]) * (z[0] + z[1]);
+    power[m] = (z[0] - z[1]) * (z[0] - z[1]);
+    for (int k = 1; k < m; k++) {
+        double zr = z[2*k],       zi = z[2*k+1];
+        double cr = z[2*(m-k)],   ci = z[2*(m-k)+1];
+        double er = 0.5 * (zr + cr), ei = 0.5 * (zi - ci);
+        double or_ = 0.5 * (zi + ci), oi = -0.5 * (zr - cr);
+        double c = twr[k], s = twi[k];
+        double xr = er + c * or_ + s * oi;
+        double xi = ei + c * oi  - s * or_;
+        power[k] = xr * xr + xi * xi;
+    }
+
+    for (int k = 0; k < m; k++) {
+        double a = 0.5 * (power[k] + power[m-k]);
+        double b = 0.5 * (power[k] - power[m-k]);
+        z[2*k]   = a - b * twi[k];
+        z[2*k+1] = b * twr[k];
+    }
+}
+
+/*
+ * Steps of the autocorrelation of frame[0 … W-1]:
+ *
+ *   0                      load frame, bit-reverse
+ *   1 … log2m              forward butterfly passes
+ *   log2m + 1              power spectrum + repack, bit-reverse
+ *   log2m + 2 … 2·log2m+1  inverse butterfly passes
+ *
+ * After the last step f->work holds M·r(τ) for τ = 0 … N-1 (only
+ * τ ≤ N - W is free of wrap-around).  Each step costs roughly 5·M.
+ */
+static inline int fft_autocorr_nsteps(const FFTAutocorr *f)
+{
+    return 2 * f->log2m + 2;
+}
+
+static void fft_autocorr_step(FFTAutocorr *f, const float *frame, int W, int step)
+{
+    const int m  = f->m;
+    const int lm = f->log2m;
+    double *z = f->work;
+
+    if (step == 0) {
+        for (int j = 0; j < W; j++)
+            z[j] = (double)frame[j];
+        memset(z + W, 0, (size_t)(2 * m - W) * sizeof(double));
+        fft_bitrev(z, m);
+    } else if (step <= lm) {
+        fft_pass(z, m, 1 << step, f->twr, f->twi, false);
+    } else if (step == lm + 1) {
+        fft_power_repack(f);
+        fft_bitrev(z, m);
+    } else {
+        fft_pass(z, m, 1 << (step - lm - 1), f->twr, f->twi, true);
+    }
+}
+
+/*
+ * Difference function from the autocorrelation left in f->work by the
+ * last fft_autocorr_step().  Same result as compute_diff_range over
+ * 1 … max_lag.
+ */
+static void diff_from_autocorr(const FFTAutocorr *f, const float * restrict frame, int W,
+                               float * restrict diff, int max_lag)
+{
+    /* The interleaved output of the inverse transform is M·r(τ) in order */
+    const double *r   = f->work;
+    const double norm = 1.0 / (double)f->m;
+
+    double r_x = 0.0, r_y;
+    for (int j = 0; j < W; j++) {
+        double xj = (double)frame[j];
+        r_x += xj * xj;
+    }
+    r_y = r_x;
+    diff[0] = 0.0f;
+
+    for (int tau = 1; tau <= max_lag; tau++) {
+        double drop_left  = (double)frame[W - tau];
+        double drop_right = (double)frame[tau - 1];
+        r_x -= drop_left  * drop_left;
+        r_y -= drop_right * drop_right;
+        diff[tau] = (float)(r_x + r_y - 2.0 * norm * r[tau]);
+    }
+}
+
 static void compute_cmndf(const float *diff, float *cmndf, int max_lag)
 {
     cmndf[0] = 1.0f;
@@ -764,19 +1199,114 @@ static float parabolic_interp(const float *cmndf, int tau, int max_lag)
     return (float)tau + 0.5f * (s0 - s2) / denom;
 }
 
+/* ── Shared tables ──────────────────────────────────────────────────────── */
+
+/*
+ * Everything that only depends on the config: the HMM transition model, the
+ * state → lag interpolation used for the observations and the beta CDF.
+ * Immutable once built, so any number of contexts (e.g. the channels of a
+ * multichannel tracker) can share one instance.  Reference counted: every
+ * context holds a reference, released by pyin_destroy.
+ */
+
+#define BETA_TABLE_SIZE 4096
+
+struct PYINTables {
+    PYINConfig cfg;            /* config the tables were built for          */
+    int      lag_min;
+    int      lag_max;
+    int      n_pitched;
+    float    state_cents;
+
+    HMM      trans;            /* transition model only, no trellis         */
+
+    /* Observation of voiced state s: p_voiced_lag interpolated between
+     * lags obs_lag[s] and obs_lag[s] + 1 with weight obs_alpha[s].
+     * obs_lag[s] < 0: pitch outside the lag range, observation floored */
+    int32_t *obs_lag;          /* [n_pitched]                               */
+    float   *obs_alpha;        /* [n_pitched]                               */
+
+    /* p_voiced(d') = 1 - I_d'(a, b), tabulated over [0, 1].  NULL when
+     * a < 1 or b < 1, where the CDF is too steep at the ends to
+     * interpolate; it is then evaluated exactly. */
+    beta_cdf_ctx betacdf;
+    float   *beta_table;       /* [BETA_TABLE_SIZE + 2]                     */
+
+    uint32_t refcount;
+    allocfn_t allocfn;
+    freefn_t  freefn;
+    void     *allocdata;
+};
+
+static inline float tables_p_voiced(const PYINTables *t, float v)
+{
+    if (!t->beta_table)
+        return 1.0 - beta_cdf_eval(&t->betacdf, v);
+    float x = v * (float)BETA_TABLE_SIZE;
+    if (!(x > 0.0f)) x = 0.0f;
+    int   i = (int)x;
+    float f = x - (float)i;
+    return t->beta_table[i] + f * (t->beta_table[i + 1] - t->beta_table[i]);
+}
+
+/* Fields of the config the tables depend on */
+static bool tables_compatible(const PYINTables *t, const PYINConfig *c)
+{
+    const PYINConfig *tc = &t->cfg;
+    return tc->sample_rate == c->sample_rate
+        && tc->f0_min == c->f0_min
+        && tc->f0_max == c->f0_max
+        && tc->cents_per_semitone == c->cents_per_semitone
+        && tc->voiced_transition_weight == c->voiced_transition_weight
+        && tc->pitch_sigma_cents == c->pitch_sigma_cents
+        && tc->beta_a == c->beta_a
+        && tc->beta_b == c->beta_b;
+}
+
+/* ── Analysis job ───────────────────────────────────────────────────────── */
+
+typedef enum {
+    STAGE_IDLE = 0,
+    STAGE_GATE,
+    STAGE_DIFF,
+    STAGE_CMNDF,
+    STAGE_BETA,
+    STAGE_OCTAVE,
+    STAGE_OBS,
+    STAGE_HMM,
+    STAGE_DECODE,
+    STAGE_DONE
+} AnalysisStage;
+
+typedef struct {
+    AnalysisStage stage;
+    int        index;         /* next lag / state within the current stage  */
+    int        slice;         /* calls since the frame was captured         */
+    bool       gated;         /* frame below the energy gate                */
+    bool       observe_only;  /* stop before STAGE_HMM (offline analysis)   */
+    float      r_x, r_y;      /* running sub-window energies (STAGE_DIFF)   */
+    float      max_p_voiced;
+    PYINResult result;
+} AnalysisJob;
+
+/* Per-item cost estimates, in multiply-add units */
+#define COST_BETA   96    /* one beta_cdf_eval (continued fraction)        */
+#define COST_BETA_TABLE 4 /* one beta_table lookup                         */
+#define COST_OBS    32    /* powf + division + logf per voiced state       */
+
 /* ── Main context ───────────────────────────────────────────────────────── */
 
 struct PYINContext {
     PYINConfig cfg;
 
-    /* Derived */
+    /* Derived (copied from tables) */
     int    lag_min;
     int    lag_max;
     int    n_pitched;    /* voiced pitch states  = HMM_SEMITONES * cps       */
     int    band_half;
     float  state_cents;
-    double beta_a;       /* cached from cfg for hot-path use                 */
-    double beta_b;
+
+    PYINTables *tables;  /* shared, one reference held                       */
 
     /* Runtime */
     int samples_since_last_hop;
@@ -792,12 +1322,33 @@ struct PYINContext {
 
     HMM hmm;
 
+    /* FFT difference function (only allocated when use_fft) */
+    bool        use_fft;
+    FFTAutocorr fft;
+
+    /* Analysis job, spread over n_slices calls with cfg.spread_analysis */
+    AnalysisJob job;
+    int         n_slices;      /* hop_size / block_size                    */
+    long        slice_budget;  /* cost units per call                      */
+
+    /* Async mode: ring is written by the audio thread, frames are read by
+     * the analysis thread.  Positions are absolute sample counts (mod 2^32). */
+    uint32_t    async_write;     /* published ring.write (atomic)            */
+    uint32_t    async_due;       /* audio thread: end of the next due frame  */
+    uint32_t    async_next_end;  /* analysis thread: end of next frame       */
+    uint32_t    result_seq;      /* seqlock for async_result, odd = writing  */
+    uint32_t    result_seen;     /* audio thread: last seq polled            */
+    uint32_t    released;        /* set by pyin_pool_release (atomic)        */
+    uint32_t    dropped;         /* frames skipped by the analysis thread    */
+    PYINResult  async_result;
+
     allocfn_t allocfn;
     freefn_t freefn;
     void *allocdata;
-    beta_cdf_ctx betacdf;
 };
 
+static long analysis_cost(const PYINContext *ctx);
+
 /* ── Default config ─────────────────────────────────────────────────────── */
 
 PYINConfig pyin_config_default(void)
@@ -818,6 +1369,9 @@ PYINConfig pyin_config_default(void)
     c.voiced_obs_floor          = 0.0f;
     c.octave_cost_weight        = 0.0f;
     c.octave_subharmonic_threshold = 3.0f;
+    c.diff_method               = PYIN_DIFF_AUTO;
+    c.spread_analysis           = false;
+    c.async_mode                = false;
     return c;
 }
 
@@ -847,40 +1401,133 @@ static bool config_valid(const PYINConfig *c)
     if (c->voiced_obs_floor < 0.0f || c->voiced_obs_floor >= 0.5f) return false;
     if (c->octave_cost_weight < 0.0f)                               return false;
     if (c->octave_subharmonic_threshold <= 1.0f)                    return false;
+    if (c->diff_method < PYIN_DIFF_AUTO ||
+        c->diff_method > PYIN_DIFF_FFT)                                 return false;
+    if (c->spread_analysis && c->async_mode)                            return false;
     return true;
 }
 
 /* ── Public API ─────────────────────────────────────────────────────────── */
 
-PYINContext *pyin_create(PYINConfig cfg, allocfn_t allocfn, freefn_t freefn, void *allocdata)
+PYINTables *pyin_tables_create(PYINConfig cfg, allocfn_t allocfn, freefn_t freefn, void *allocdata)
 {
     if (!config_valid(&cfg)) return NULL;
 
-    PYINContext *ctx = (PYINContext *)_calloc(allocfn, allocdata, 1, sizeof(PYINContext));
-    if (!ctx) return NULL;
+    PYINTables *t = (PYINTables *)_calloc(allocfn, allocdata, 1, sizeof(PYINTables));
+    if (!t) return NULL;
 
-    ctx->allocfn = allocfn;
-    ctx->allocdata = allocdata;
-    ctx->freefn = freefn;
+    t->allocfn   = allocfn;
+    t->freefn    = freefn;
+    t->allocdata = allocdata;
+    t->refcount  = 1;
 
-    ctx->cfg         = cfg;
-    ctx->lag_min     = (int)(cfg.sample_rate / cfg.f0_max + 0.5f);
-    ctx->lag_max     = (int)(cfg.sample_rate / cfg.f0_min + 0.5f);
-    ctx->n_pitched   = HMM_SEMITONES * cfg.cents_per_semitone;
-    ctx->state_cents = 100.0f / (float)cfg.cents_per_semitone;
-    ctx->beta_a      = (double)cfg.beta_a;
-    ctx->beta_b      = (double)cfg.beta_b;
+    t->cfg         = cfg;
+    t->lag_min     = (int)(cfg.sample_rate / cfg.f0_max + 0.5f);
+    t->lag_max     = (int)(cfg.sample_rate / cfg.f0_min + 0.5f);
+    t->n_pitched   = HMM_SEMITONES * cfg.cents_per_semitone;
+    t->state_cents = 100.0f / (float)cfg.cents_per_semitone;
 
     /* Band half-width: ±TRANS_BAND_SIGMA × sigma, rounded up to whole states.
      * Capped so it never exceeds the full pitch range. */
     double sigma_cents = (double)cfg.pitch_sigma_cents;
     int band_half = (int)(TRANS_BAND_SIGMA * sigma_cents
-                          / (double)ctx->state_cents + 0.5);
+                          / (double)t->state_cents + 0.5);
     if (band_half < 1) band_half = 1;
-    if (band_half > ctx->n_pitched / 2) band_half = ctx->n_pitched / 2;
-    ctx->band_half = band_half;
+    if (band_half > t->n_pitched / 2) band_half = t->n_pitched / 2;
+
+    if (!hmm_init_transitions(&t->trans, t->n_pitched, band_half,
+                              t->state_cents, cfg.voiced_transition_weight,
+                              sigma_cents, allocfn, allocdata)) goto fail;
+
+    /* State → lag interpolation, see STAGE_OBS */
+    t->obs_lag   = (int32_t *)_calloc(allocfn, allocdata, t->n_pitched, sizeof(int32_t));
+    t->obs_alpha = (float *)_calloc(allocfn, allocdata, t->n_pitched, sizeof(float));
+    if (!t->obs_lag || !t->obs_alpha) goto fail;
+    for (int s = 0; s < t->n_pitched; s++) {
+        float hz    = state_to_hz(s, t->state_cents);
+        float tau_f = cfg.sample_rate / hz;
+        int   t0    = (int)tau_f;
+        if (t0 >= t->lag_min && t0 + 1 <= t->lag_max) {
+            t->obs_lag[s]   = t0;
+            t->obs_alpha[s] = tau_f - (float)t0;
+        } else if (t0 >= t->lag_min && t0 <= t->lag_max) {
+            t->obs_lag[s]   = t0;       /* t0 == lag_max: no interpolation */
+            t->obs_alpha[s] = 0.0f;
+        } else {
+            t->obs_lag[s]   = -1;
+        }
+    }
+
+    double a = (double)cfg.beta_a;
+    double b = (double)cfg.beta_b;
+    t->betacdf.a = a;
+    t->betacdf.b = b;
+    t->betacdf.lbeta = lgamma(a) + lgamma(b) - lgamma(a + b);
+    t->betacdf.threshold = (a + 1.0) / (a + b + 2.0);
+    if (a >= 1.0 && b >= 1.0) {
+        t->beta_table = (float *)_calloc(allocfn, allocdata, BETA_TABLE_SIZE + 2, sizeof(float));
+        if (!t->beta_table) goto fail;
+        for (int i = 0; i <= BETA_TABLE_SIZE; i++)
+            t->beta_table[i] = (float)(1.0 - beta_cdf_eval(&t->betacdf,
+                                                           (double)i / BETA_TABLE_SIZE));
+        t->beta_table[BETA_TABLE_SIZE + 1] = t->beta_table[BETA_TABLE_SIZE];
+    }
+    return t;
+
+fail:
+    pyin_tables_release(t);
+    return NULL;
+}
+
+void pyin_tables_release(PYINTables *t)
+{
+    if (!t) return;
+    if (atomic_fetch_add_u32(&t->refcount, (uint32_t)-1) != 1)
+        return;
+    _free(t->freefn, t->allocdata, t->trans.log_trans_band);
+    _free(t->freefn, t->allocdata, t->obs_lag);
+    _free(t->freefn, t->allocdata, t->obs_alpha);
+    _free(t->freefn, t->allocdata, t->beta_table);
+    _free(t->freefn, t->allocdata, t);
+}
+
+PYINContext *pyin_create(PYINConfig cfg, allocfn_t allocfn, freefn_t freefn, void *allocdata)
+{
+    PYINTables *tables = pyin_tables_create(cfg, allocfn, freefn, allocdata);
+    if (!tables) return NULL;
+    PYINContext *ctx = pyin_create_shared(cfg, tables, allocfn, freefn, allocdata);
+    /* The context holds its own reference */
+    pyin_tables_release(tables);
+    return ctx;
+}
+
+PYINContext *pyin_create_shared(PYINConfig cfg, PYINTables *tables,
+                                allocfn_t allocfn, freefn_t freefn, void *allocdata)
+{
+    if (!config_valid(&cfg)) return NULL;
+    if (!tables_compatible(tables, &cfg)) return NULL;
 
-    int ring_cap    = next_pow2(cfg.frame_size + cfg.block_size);
+    PYINContext *ctx = (PYINContext *)_calloc(allocfn, allocdata, 1, sizeof(PYINContext));
+    if (!ctx) return NULL;
+
+    ctx->allocfn = allocfn;
+    ctx->allocdata = allocdata;
+    ctx->freefn = freefn;
+
+    atomic_fetch_add_u32(&tables->refcount, 1);
+    ctx->tables      = tables;
+    ctx->cfg         = cfg;
+    ctx->lag_min     = tables->lag_min;
+    ctx->lag_max     = tables->lag_max;
+    ctx->n_pitched   = tables->n_pitched;
+    ctx->state_cents = tables->state_cents;
+    ctx->band_half   = tables->trans.band_half;
+
+    /* In async mode the ring also holds the backlog of the analysis thread */
+    int ring_cap    = cfg.async_mode
+                    ? next_pow2(cfg.frame_size + PYIN_ASYNC_BACKLOG_HOPS * cfg.hop_size
+                                + cfg.block_size)
+                    : next_pow2(cfg.frame_size + cfg.block_size);
     int lag_buf_len = ctx->lag_max + 2;
     int n_total     = ctx->n_pitched + 1;   /* +1 for unvoiced */
 
@@ -910,17 +1557,24 @@ PYINContext *pyin_create(PYINConfig cfg, allocfn_t allocfn, freefn_t freefn, voi
     // ctx->p_voiced_lag = (float *)calloc((size_t)lag_buf_len,    sizeof(float));
     // ctx->log_obs      = (float *)malloc ((size_t)n_total        * sizeof(float));
     //
-    if (!hmm_alloc(&ctx->hmm, ctx->n_pitched, ctx->band_half,
-                   ctx->state_cents, cfg.voiced_transition_weight,
-                   sigma_cents, ctx->allocfn, ctx->allocdata)) goto fail;
+    if (!hmm_alloc_trellis(&ctx->hmm, &tables->trans, allocfn, allocdata)) goto fail;
 
+    ctx->use_fft = cfg.diff_method == PYIN_DIFF_FFT ||
+                   (cfg.diff_method == PYIN_DIFF_AUTO &&
+                    (long)cfg.frame_size * ctx->lag_max >= PYIN_FFT_THRESHOLD);
+    if (ctx->use_fft &&
+        !fft_autocorr_alloc(&ctx->fft, next_pow2(cfg.frame_size + ctx->lag_max),
+                            allocfn, allocdata)) goto fail;
 
-    double a = ctx->beta_a;
-    double b = ctx->beta_b;
-    ctx->betacdf.a = a;
-    ctx->betacdf.b = b;
-    ctx->betacdf.lbeta = lgamma(a) + lgamma(b) - lgamma(a + b);
-    ctx->betacdf.threshold = (a + 1.0) / (a + b + 2.0);
+    ctx->job.stage    = STAGE_IDLE;
+    ctx->n_slices     = cfg.hop_size / cfg.block_size;
+    ctx->slice_budget = (analysis_cost(ctx) + ctx->n_slices - 1) / ctx->n_slices;
+
+    /* Same frame boundaries as pyin_process_block: the first frame ends at
+     * the first block boundary where the ring holds a full frame. */
+    ctx->async_due = (uint32_t)(((cfg.frame_size + cfg.block_size - 1) / cfg.block_size)
+                                * cfg.block_size);
+    ctx->async_next_end = ctx->async_due;
 
     return ctx;
 
@@ -938,7 +1592,9 @@ void pyin_destroy(PYINContext *ctx)
     // hmm_free(&ctx->hmm);
     _free(ctx->freefn, ctx->allocdata, ctx->hmm.score);
     _free(ctx->freefn, ctx->allocdata, ctx->hmm.back);
-    _free(ctx->freefn, ctx->allocdata, ctx->hmm.log_trans_band);
+    _free(ctx->freefn, ctx->allocdata, ctx->hmm.back_uv);
+    _free(ctx->freefn, ctx->allocdata, ctx->fft.mem);
+    pyin_tables_release(ctx->tables);
 
     _free(ctx->freefn, ctx->allocdata, ctx);
     // free(ctx);
@@ -949,6 +1605,23 @@ const PYINConfig *pyin_get_config(const PYINContext *ctx)
     return &ctx->cfg;
 }
 
+const float *pyin_get_cmndf(const PYINContext *ctx, int *len)
+{
+    *len = ctx->lag_max + 1;
+    return ctx->cmndf;
+}
+
+bool pyin_uses_fft(const PYINContext *ctx)
+{
+    return ctx->use_fft;
+}
+
+int pyin_get_latency(const PYINContext *ctx)
+{
+    if (!ctx->cfg.spread_analysis) return 0;
+    return ctx->cfg.hop_size - ctx->cfg.block_size;
+}
+
 // void pyin_reset(PYINContext *ctx)
 // {
 //     ring_clear(&ctx->ring);
@@ -958,179 +1631,34 @@ const PYINConfig *pyin_get_config(const PYINContext *ctx)
 
 /* ── Core analysis ──────────────────────────────────────────────────────── */
 
-static bool analyse_frame(PYINContext *ctx, PYINResult *result)
+/*
+ * Turn the decoded HMM state into a result, using the per-lag data of the
+ * frame (cmndf, p_voiced_lag) still held in ctx.
+ */
+static void decode_state(const PYINContext *ctx, int best, PYINResult *result)
 {
-    const int   W           = ctx->cfg.frame_size;
     const int   lag_min     = ctx->lag_min;
     const int   lag_max     = ctx->lag_max;
-    const int   n_pitched   = ctx->n_pitched;
     const float sample_rate = ctx->cfg.sample_rate;
-    const float state_cents = ctx->state_cents;
-
-    /* ── Energy gate ──────────────────────────────────────────────────────
-     * Pure silence → d(tau)=0 → d'(tau)=0 → beta_exceed(0)=1 for all lags.
-     * Short-circuit before any analysis to avoid feeding garbage to the HMM.
-     * We still push an unvoiced-only observation so the trellis advances.
-     * ──────────────────────────────────────────────────────────────────── */
-    {
-        double sum_sq = 0.0;
-        float *frame = ctx->frame;
-        for (int i = 0; i < W; i++) {
-            double val = frame[i];
-            sum_sq += val * val;
-        }
-        //    sum_sq += (double)ctx->frame[i] * (double)ctx->frame[i];
-
-        if (sqrtf((float)(sum_sq / W)) < ctx->cfg.energy_gate_rms) {
-            /* Feed a strongly unvoiced observation to the HMM */
-            const float FLOOR = 1e-7f;
-            const float logfloor = logf(FLOOR);
-            for (int s = 0; s < n_pitched; s++)
-                ctx->log_obs[s] = logfloor;
-            ctx->log_obs[n_pitched] = 0.0f;   /* log(1) = 0 → certain unvoiced */
-            hmm_push(&ctx->hmm, ctx->log_obs);
-
-            result->pitch_hz   = 0.0f;
-            result->confidence = 0.0f;
-            result->voiced     = false;
-            return true;
-        }
-    }
-
-    /* ── Step 1: YIN difference + CMNDF ─────────────────────────────────── */
-    compute_diff(ctx->frame, W, ctx->diff,  lag_max);
-    compute_cmndf(ctx->diff,     ctx->cmndf, lag_max);
-
-    /* ── Step 2: per-lag voiced probability ──────────────────────────────
-     * p_voiced(τ) = P(Beta(a,b) > d'(τ)) = 1 – I_{d'(τ)}(a, b)
-     * ──────────────────────────────────────────────────────────────────── */
-    float max_p_voiced = 0.0f;
-    for (int tau = lag_min; tau <= lag_max; tau++) {
-        float v = ctx->cmndf[tau];
-        if (v > 1.0f) v = 1.0f;
-        // float pv = beta_exceed(v, ctx->beta_a, ctx->beta_b);
-        // float pv = 1.0 - fast_beta_cdf_normal(v, ctx->beta_a, ctx->beta_b); // fast approx.
-        float pv = 1.0 - beta_cdf_eval(&(ctx->betacdf), v);  // full resolution, constant a,b
-        ctx->p_voiced_lag[tau] = pv;
-        if (pv > max_p_voiced) max_p_voiced = pv;
-    }
-
-    /* ── Octave-consistency penalty ───────────────────────────────────────
-     *
-     * Octave errors occur when a signal has a weak or missing fundamental
-     * (F0) but strong 2nd harmonic (2×F0).  The CMNDF then dips more
-     * strongly at lag τ = T/2 (period of 2×F0) than at τ = T (period of F0),
-     * causing the tracker to lock onto 2×F0 instead of F0.
-     *
-     * Detection: for each candidate lag τ, check whether τ×2 (the period of
-     * the sub-harmonic, i.e. half the frequency) also has a competitive dip.
-     * If cmndf[2τ] is within octave_subharmonic_threshold × cmndf[τ], the
-     * shorter lag τ is likely a harmonic alias of the true lower pitch, so
-     * p_voiced[τ] is penalised.
-     *
-     * Formula:
-     *   R = cmndf[2τ] / cmndf[τ]
-     *   if R < octave_subharmonic_threshold:
-     *     p_voiced[τ] *= (R / octave_subharmonic_threshold)^octave_cost_weight
-     *   else:
-     *     no penalty (sub-harmonic is much weaker → τ is likely the true pitch)
-     *
-     * Applied only when 2τ <= lag_max (sub-harmonic must be in the search range).
-     * ──────────────────────────────────────────────────────────────────── */
-    const float ocw = ctx->cfg.octave_cost_weight;
-    if (ocw > 0.0f) {
-        const float K = ctx->cfg.octave_subharmonic_threshold;
-        for (int tau = lag_min; tau <= lag_max; tau++) {
-            int tau2 = tau * 2;
-            if (tau2 > lag_max) continue;   /* sub-harmonic out of range */
-            float ct  = ctx->cmndf[tau];
-            float c2t = ctx->cmndf[tau2];
-            if (ct <= 0.0f) continue;
-            float R = c2t / ct;
-            if (R < K) {
-                /* sub-harmonic is competitive: τ may be a harmonic alias */
-                float penalty = powf(R / K, ocw);    /* in (0, 1) */
-                ctx->p_voiced_lag[tau] *= penalty;
-            }
-        }
-        /* Recompute max after penalty */
-        max_p_voiced = 0.0f;
-        for (int tau = lag_min; tau <= lag_max; tau++) {
-            if (ctx->p_voiced_lag[tau] > max_p_voiced)
-                max_p_voiced = ctx->p_voiced_lag[tau];
-        }
-    }
-
-    /* ── Step 3: HMM observation log-likelihoods ─────────────────────────
-     *
-     * Voiced states: log p(obs | voiced s) = log p_voiced(τ(s))
-     *   interpolated between bracketing integer lags.
-     *
-     * Unvoiced state: log p(obs | unvoiced) = log(1 - max_p_voiced)
-     *   The maximum per-lag voiced probability is the best evidence of any
-     *   periodicity; its complement is the evidence for aperiodicity.
-     *
-     * voiced_obs_floor: clamp max_p_voiced from below so a single bad frame
-     *   (creak, glottalization, microphone noise) cannot impose an arbitrarily
-     *   large penalty on the voiced path.  Does not affect per-lag values used
-     *   for the individual voiced-state observations.
-     * ──────────────────────────────────────────────────────────────────── */
-    const float FLOOR = 1e-7f;
-
-    /* Apply voiced observation floor to the unvoiced observation only;
-     * per-lag p_voiced values keep their original range for pitch accuracy. */
-    float max_pv_floored = max_p_voiced;
-    if (max_pv_floored < ctx->cfg.voiced_obs_floor)
-        max_pv_floored = ctx->cfg.voiced_obs_floor;
-
-    for (int s = 0; s < n_pitched; s++) {
-        float hz    = state_to_hz(s, state_cents);
-        float tau_f = sample_rate / hz;
-        int   t0    = (int)tau_f;
-        int   t1    = t0 + 1;
-        float p;
-
-        if (t0 >= lag_min && t1 <= lag_max) {
-            float alpha = tau_f - (float)t0;
-            p = (1.0f - alpha) * ctx->p_voiced_lag[t0]
-              +          alpha  * ctx->p_voiced_lag[t1];
-        } else if (t0 >= lag_min && t0 <= lag_max) {
-            p = ctx->p_voiced_lag[t0];
-        } else {
-            p = FLOOR;
-        }
-
-        ctx->log_obs[s] = logf(p < FLOOR ? FLOOR : p);
-    }
-
-    /* Unvoiced observation: uses floored value to bound voiced-path debt */
-    float p_unvoiced = 1.0f - max_pv_floored;
-    ctx->log_obs[n_pitched] = logf(p_unvoiced < FLOOR ? FLOOR : p_unvoiced);
-
-    /* ── Step 4: banded Viterbi update ──────────────────────────────────── */
-    hmm_push(&ctx->hmm, ctx->log_obs);
-
-    /* ── Step 5: decode ──────────────────────────────────────────────────── */
-    int best = hmm_best_state(&ctx->hmm);
 
     /*
      * If the best state is the unvoiced state: report unvoiced.
      * If it is a voiced pitch state: extract frequency and confidence.
      */
-    if (best == n_pitched) {
+    if (best == ctx->n_pitched) {
         result->pitch_hz   = 0.0f;
         result->confidence = 0.0f;
         result->voiced     = false;
-        return true;
+        return;
     }
 
-    float hz_raw   = state_to_hz(best, state_cents);
+    float hz_raw   = state_to_hz(best, ctx->state_cents);
     float tau_best = sample_rate / hz_raw;
     int   tau_i    = (int)roundf(tau_best);
     if (tau_i < lag_min) tau_i = lag_min;
     if (tau_i > lag_max) tau_i = lag_max;
 
-    /* ── Step 6: confidence ──────────────────────────────────────────────── */
+    /* ── Step 6: confidence ──────────────────────────────────────────── */
     /*
      * Confidence = p_voiced at the best lag.
      * The HMM has already made the voiced/unvoiced decision; this value
@@ -1147,11 +1675,322 @@ static bool analyse_frame(PYINContext *ctx, PYINResult *result)
     result->confidence = confidence;
     result->voiced     = true;
     result->pitch_hz   = pitch_hz;
+}
+
+/*
+ * The analysis of one frame is a resumable job so that, with
+ * cfg.spread_analysis, its cost can be spread evenly over the k-cycles of
+ * one hop instead of landing on the single cycle where the hop completes.
+ *
+ * Each stage processes items (lags, states) and charges their estimated
+ * cost, in multiply-add units, against the budget given to analysis_run().
+ * The stage and item index are kept in ctx->job between calls.
+ */
+static bool analysis_run(PYINContext *ctx, long budget)
+{
+    AnalysisJob *job        = &ctx->job;
+    const PYINTables *tables = ctx->tables;
+    const int   W           = ctx->cfg.frame_size;
+    const int   lag_min     = ctx->lag_min;
+    const int   lag_max     = ctx->lag_max;
+    const int   n_pitched   = ctx->n_pitched;
+    const float FLOOR       = 1e-7f;
+
+    for (;;) {
+        if (job->stage == STAGE_DONE) return true;
+        if (job->stage == STAGE_IDLE) return false;
+        if (job->stage == STAGE_HMM && job->observe_only) return true;
+        if (budget <= 0) return false;
+
+        switch (job->stage) {
+
+        /* ── Energy gate ──────────────────────────────────────────────────
+         * Pure silence → d(tau)=0 → d'(tau)=0 → beta_exceed(0)=1 for all lags.
+         * Short-circuit before any analysis to avoid feeding garbage to the HMM.
+         * We still push an unvoiced-only observation so the trellis advances.
+         * ──────────────────────────────────────────────────────────────── */
+        case STAGE_GATE: {
+            double sum_sq = 0.0;
+            float *frame = ctx->frame;
+            for (int i = 0; i < W; i++) {
+                double val = frame[i];
+                sum_sq += val * val;
+            }
+            budget -= W;
+            job->index = 0;
+
+            if (sqrtf((float)(sum_sq / W)) < ctx->cfg.energy_gate_rms) {
+                /* Feed a strongly unvoiced observation to the HMM */
+                const float logfloor = logf(FLOOR);
+                for (int s = 0; s < n_pitched; s++)
+                    ctx->log_obs[s] = logfloor;
+                ctx->log_obs[n_pitched] = 0.0f;   /* log(1) = 0 → certain unvoiced */
+                budget -= n_pitched;
+                job->gated = true;
+                job->stage = STAGE_HMM;
+            } else {
+                job->stage = STAGE_DIFF;
+            }
+            break;
+        }
+
+        /* ── Step 1: YIN difference + CMNDF ───────────────────────────── */
+        case STAGE_DIFF:
+            if (ctx->use_fft) {
+                /* One item per FFT step, then the diff itself */
+                const int nsteps = fft_autocorr_nsteps(&ctx->fft);
+                const long step_cost = 5L * ctx->fft.m;
+                for (; job->index < nsteps && budget > 0; job->index++) {
+                    fft_autocorr_step(&ctx->fft, ctx->frame, W, job->index);
+                    budget -= step_cost;
+                }
+                if (job->index == nsteps && budget > 0) {
+                    diff_from_autocorr(&ctx->fft, ctx->frame, W, ctx->diff, lag_max);
+                    budget -= W + lag_max;
+                    job->stage = STAGE_CMNDF;
+                }
+                break;
+            }
+            if (job->index == 0) {
+                job->r_x = frame_energy(ctx->frame, W);
+                job->r_y = job->r_x;
+                ctx->diff[0] = 0.0f;
+                job->index = 1;
+                budget -= W;
+            }
+            {
+                int tau_end = job->index;
+                while (tau_end <= lag_max && budget > 0) {
+                    budget -= W - tau_end;
+                    tau_end++;
+                }
+                compute_diff_range(ctx->frame, W, ctx->diff, job->index, tau_end,
+                                   &job->r_x, &job->r_y);
+                job->index = tau_end;
+            }
+            if (job->index > lag_max)
+                job->stage = STAGE_CMNDF;
+            break;
+
+        case STAGE_CMNDF:
+            compute_cmndf(ctx->diff, ctx->cmndf, lag_max);
+            budget -= lag_max;
+            job->max_p_voiced = 0.0f;
+            job->index = lag_min;
+            job->stage = STAGE_BETA;
+            break;
+
+        /* ── Step 2: per-lag voiced probability ───────────────────────────
+         * p_voiced(τ) = P(Beta(a,b) > d'(τ)) = 1 – I_{d'(τ)}(a, b)
+         * ──────────────────────────────────────────────────────────────── */
+        case STAGE_BETA: {
+            const long cost_beta = tables->beta_table ? COST_BETA_TABLE : COST_BETA;
+            int tau = job->index;
+            float max_p_voiced = job->max_p_voiced;
+            for (; tau <= lag_max && budget > 0; tau++) {
+                float v = ctx->cmndf[tau];
+                if (v > 1.0f) v = 1.0f;
+                float pv = tables_p_voiced(tables, v);
+                ctx->p_voiced_lag[tau] = pv;
+                if (pv > max_p_voiced) max_p_voiced = pv;
+                budget -= cost_beta;
+            }
+            job->max_p_voiced = max_p_voiced;
+            job->index = tau;
+            if (tau > lag_max)
+                job->stage = STAGE_OCTAVE;
+            break;
+        }
+
+        /* ── Octave-consistency penalty ───────────────────────────────────
+         *
+         * Octave errors occur when a signal has a weak or missing fundamental
+         * (F0) but strong 2nd harmonic (2×F0).  The CMNDF then dips more
+         * strongly at lag τ = T/2 (period of 2×F0) than at τ = T (period of F0),
+         * causing the tracker to lock onto 2×F0 instead of F0.
+         *
+         * Detection: for each candidate lag τ, check whether τ×2 (the period of
+         * the sub-harmonic, i.e. half the frequency) also has a competitive dip.
+         * If cmndf[2τ] is within octave_subharmonic_threshold × cmndf[τ], the
+         * shorter lag τ is likely a harmonic alias of the true lower pitch, so
+         * p_voiced[τ] is penalised.
+         *
+         * Formula:
+         *   R = cmndf[2τ] / cmndf[τ]
+         *   if R < octave_subharmonic_threshold:
+         *     p_voiced[τ] *= (R / octave_subharmonic_threshold)^octave_cost_weight
+         *   else:
+         *     no penalty (sub-harmonic is much weaker → τ is likely the true pitch)
+         *
+         * Applied only when 2τ <= lag_max (sub-harmonic must be in the search range).
+         * ──────────────────────────────────────────────────────────────── */
+        case STAGE_OCTAVE: {
+            const float ocw = ctx->cfg.octave_cost_weight;
+            if (ocw > 0.0f) {
+                const float K = ctx->cfg.octave_subharmonic_threshold;
+                for (int tau = lag_min; tau <= lag_max; tau++) {
+                    int tau2 = tau * 2;
+                    if (tau2 > lag_max) continue;   /* sub-harmonic out of range */
+                    float ct  = ctx->cmndf[tau];
+                    float c2t = ctx->cmndf[tau2];
+                    if (ct <= 0.0f) continue;
+                    float R = c2t / ct;
+                    if (R < K) {
+                        /* sub-harmonic is competitive: τ may be a harmonic alias */
+                        float penalty = powf(R / K, ocw);    /* in (0, 1) */
+                        ctx->p_voiced_lag[tau] *= penalty;
+                    }
+                }
+                /* Recompute max after penalty */
+                float max_p_voiced = 0.0f;
+                for (int tau = lag_min; tau <= lag_max; tau++) {
+                    if (ctx->p_voiced_lag[tau] > max_p_voiced)
+                        max_p_voiced = ctx->p_voiced_lag[tau];
+                }
+                job->max_p_voiced = max_p_voiced;
+                budget -= 2 * (lag_max - lag_min + 1);
+            }
+
+            /* Apply voiced observation floor to the unvoiced observation only;
+             * per-lag p_voiced values keep their original range for pitch
+             * accuracy.  Unvoiced observation uses the floored value to bound
+             * voiced-path debt (see Step 3). */
+            float max_pv_floored = job->max_p_voiced;
+            if (max_pv_floored < ctx->cfg.voiced_obs_floor)
+                max_pv_floored = ctx->cfg.voiced_obs_floor;
+            float p_unvoiced = 1.0f - max_pv_floored;
+            ctx->log_obs[n_pitched] = logf(p_unvoiced < FLOOR ? FLOOR : p_unvoiced);
+
+            job->index = 0;
+            job->stage = STAGE_OBS;
+            break;
+        }
+
+        /* ── Step 3: HMM observation log-likelihoods ──────────────────────
+         *
+         * Voiced states: log p(obs | voiced s) = log p_voiced(τ(s))
+         *   interpolated between bracketing integer lags.
+         *
+         * Unvoiced state: log p(obs | unvoiced) = log(1 - max_p_voiced)
+         *   The maximum per-lag voiced probability is the best evidence of any
+         *   periodicity; its complement is the evidence for aperiodicity.
+         *
+         * voiced_obs_floor: clamp max_p_voiced from below so a single bad frame
+         *   (creak, glottalization, microphone noise) cannot impose an arbitrarily
+         *   large penalty on the voiced path.  Does not affect per-lag values used
+         *   for the individual voiced-state observations.
+         * ──────────────────────────────────────────────────────────────── */
+        case STAGE_OBS: {
+            /* p_voiced_lag[lag_max + 1] is never written (0): states
+             * mapping to lag_max have alpha = 0 */
+            const int32_t *obs_lag   = tables->obs_lag;
+            const float   *obs_alpha = tables->obs_alpha;
+            int s = job->index;
+            for (; s < n_pitched && budget > 0; s++) {
+                int   t0 = obs_lag[s];
+                float p;
+
+                if (t0 >= 0) {
+                    float alpha = obs_alpha[s];
+                    p = (1.0f - alpha) * ctx->p_voiced_lag[t0]
+                      +          alpha  * ctx->p_voiced_lag[t0 + 1];
+                } else {
+                    p = FLOOR;
+                }
+
+                ctx->log_obs[s] = logf(p < FLOOR ? FLOOR : p);
+                budget -= COST_OBS;
+            }
+            job->index = s;
+            if (s >= n_pitched) {
+                job->index = 0;
+                job->stage = STAGE_HMM;
+            }
+            break;
+        }
+
+        /* ── Step 4: banded Viterbi update ────────────────────────────────── */
+        case STAGE_HMM: {
+            const long cost = 2 * ctx->band_half + 1;
+            int s_end = job->index;
+            while (s_end < n_pitched && budget > 0) {
+                budget -= cost;
+                s_end++;
+            }
+            hmm_step_voiced(&ctx->hmm, ctx->log_obs, job->index, s_end);
+            job->index = s_end;
+            if (s_end >= n_pitched) {
+                hmm_step_unvoiced(&ctx->hmm, ctx->log_obs);
+                hmm_advance(&ctx->hmm);
+                budget -= n_pitched;
+                job->stage = STAGE_DECODE;
+            }
+            break;
+        }
+
+        /* ── Step 5: decode ───────────────────────────────────────────────── */
+        case STAGE_DECODE:
+            job->stage = STAGE_DONE;
+            budget -= n_pitched + 1;
+            decode_state(ctx, job->gated ? n_pitched : hmm_best_state(&ctx->hmm),
+                         &job->result);
+            break;
+
+        default:
+            return false;
+        }
+    }
+}
+
+static inline void analysis_start(PYINContext *ctx)
+{
+    ctx->job.stage = STAGE_GATE;
+    ctx->job.index = 0;
+    ctx->job.slice = 0;
+    ctx->job.gated = false;
+    ctx->job.observe_only = false;
+}
+
+/* Estimated cost of analysing one frame, in the units used by analysis_run */
+static long analysis_cost(const PYINContext *ctx)
+{
+    const long W       = ctx->cfg.frame_size;
+    const long lag_max = ctx->lag_max;
+    const long n_lags  = ctx->lag_max - ctx->lag_min + 1;
+    const long np      = ctx->n_pitched;
+
+    long cost = W;                                          /* energy gate  */
+    cost += ctx->use_fft
+          ? 5L * ctx->fft.m * fft_autocorr_nsteps(&ctx->fft) + W + lag_max
+          : W + lag_max * W - lag_max * (lag_max + 1) / 2;   /* diff         */
+    cost += lag_max;                                        /* cmndf        */
+    cost += n_lags * (ctx->tables->beta_table ? COST_BETA_TABLE : COST_BETA); /* beta */
+    if (ctx->cfg.octave_cost_weight > 0.0f)
+        cost += 2 * n_lags;                                 /* octave       */
+    cost += np * COST_OBS;                                  /* observations */
+    cost += np * (2 * ctx->band_half + 1) + np;             /* viterbi      */
+    cost += np + 1;                                         /* decode       */
+    return cost;
+}
+
+static bool analyse_frame(PYINContext *ctx, PYINResult *result)
+{
+    analysis_start(ctx);
+    analysis_run(ctx, LONG_MAX);
+    ctx->job.stage = STAGE_IDLE;
+    *result = ctx->job.result;
     return true;
 }
 
 /* ── Public entry point ─────────────────────────────────────────────────── */
 
+/*
+ * With cfg.spread_analysis the frame captured when a hop completes is
+ * analysed over the next n_slices = hop_size / block_size calls (including
+ * the capturing one), each running a budget of ~1/n_slices of the total
+ * cost.  The result is always published on the last slice, so the extra
+ * latency is constant: hop_size - block_size samples.
+ */
 bool pyin_process_block(PYINContext   *ctx,
                         const float   *samples,
                         PYINResult    *result)
@@ -1159,13 +1998,396 @@ bool pyin_process_block(PYINContext   *ctx,
     ring_push(&ctx->ring, samples, ctx->cfg.block_size);
     ctx->samples_since_last_hop += ctx->cfg.block_size;
 
+    bool has_result = false;
+
+    if (ctx->job.stage != STAGE_IDLE) {
+        /* Spread mode: continue the frame captured in a previous call */
+        bool last = ++ctx->job.slice >= ctx->n_slices - 1;
+        analysis_run(ctx, last ? LONG_MAX : ctx->slice_budget);
+        if (last) {
+            ctx->job.stage = STAGE_IDLE;
+            *result = ctx->job.result;
+            has_result = true;
+        }
+    }
+
     if ((int)ctx->ring.fill < ctx->cfg.frame_size)
-        return false;
+        return has_result;
 
     if (ctx->samples_since_last_hop < ctx->cfg.hop_size)
-        return false;
+        return has_result;
 
     ctx->samples_since_last_hop = 0;
     ring_read_latest(&ctx->ring, ctx->frame, ctx->cfg.frame_size);
-    return analyse_frame(ctx, result);
+
+    if (!ctx->cfg.spread_analysis || ctx->n_slices <= 1)
+        return analyse_frame(ctx, result);
+
+    analysis_start(ctx);
+    analysis_run(ctx, ctx->slice_budget);
+    return has_result;
+}
+
+/* ── Asynchronous analysis ──────────────────────────────────────────────── */
+
+struct PYINPool {
+    int           capacity;
+    PYINContext **slots;       /* NULL = free; set by CAS in pyin_pool_add */
+};
+
+bool pyin_async_push(PYINContext *ctx, const float *samples)
+{
+    ring_push(&ctx->ring, samples, ctx->cfg.block_size);
+    /* Publish after the samples are written */
+    atomic_store_u32(&ctx->async_write, ctx->ring.write);
+    if ((int32_t)(ctx->ring.write - ctx->async_due) >= 0) {
+        ctx->async_due += (uint32_t)ctx->cfg.hop_size;
+        return true;
+    }
+    return false;
+}
+
+bool pyin_async_poll(PYINContext *ctx, PYINResult *result)
+{
+    for (int attempt = 0; attempt < 2; attempt++) {
+        uint32_t s1 = atomic_load_u32(&ctx->result_seq);
+        if (s1 == ctx->result_seen || (s1 & 1u))
+            return false;      /* nothing new, or being written: next cycle */
+        PYINResult r = ctx->async_result;
+        atomic_fence();
+        if (atomic_load_u32(&ctx->result_seq) != s1)
+            continue;          /* overwritten while copying */
+        *result = r;
+        ctx->result_seen = s1;
+        return true;
+    }
+    return false;
+}
+
+int pyin_async_dropped(const PYINContext *ctx)
+{
+    return (int)atomic_load_u32((uint32_t *)&ctx->dropped);
+}
+
+static void async_publish(PYINContext *ctx, const PYINResult *result)
+{
+    uint32_t seq = ctx->result_seq;      /* only the analysis thread writes it */
+    atomic_store_u32(&ctx->result_seq, seq + 1);
+    atomic_fence();
+    ctx->async_result = *result;
+    atomic_store_u32(&ctx->result_seq, seq + 2);
+}
+
+/*
+ * Analysis thread: read and analyse the next due frame, if any.
+ *
+ * The audio thread never waits for us, so the frame may have been
+ * overwritten (we fell more than PYIN_ASYNC_BACKLOG_HOPS behind) or be in
+ * the process of being overwritten while we copy it.  Both cases are
+ * detected from the write position and the frame is skipped.
+ */
+static bool async_analyse_next(PYINContext *ctx, PYINResult *result)
+{
+    const uint32_t W   = (uint32_t)ctx->cfg.frame_size;
+    const uint32_t hop = (uint32_t)ctx->cfg.hop_size;
+    const uint32_t bs  = (uint32_t)ctx->cfg.block_size;
+    const uint32_t cap = ctx->ring.cap;
+    uint32_t w = atomic_load_u32(&ctx->async_write);
+
+    for (;;) {
+        uint32_t end = ctx->async_next_end;
+        if ((int32_t)(w - end) < 0)
+            return false;
+        uint32_t start = end - W;
+        ctx->async_next_end += hop;
+        /* The block being written may already cover [w + bs - cap, ...) */
+        if (w + bs - start <= cap) {
+            ring_read_at(&ctx->ring, ctx->frame, start, (int)W);
+            atomic_fence();
+            w = atomic_load_u32(&ctx->async_write);
+            if (w + bs - start <= cap)
+                return analyse_frame(ctx, result);
+        }
+        atomic_store_u32(&ctx->dropped, ctx->dropped + 1);
+    }
+}
+
+PYINPool *pyin_pool_create(int capacity)
+{
+    if (capacity <= 0) return NULL;
+    PYINPool *pool = (PYINPool *)calloc(1, sizeof(PYINPool));
+    if (!pool) return NULL;
+    pool->slots = (PYINContext **)calloc((size_t)capacity, sizeof(PYINContext *));
+    if (!pool->slots) { free(pool); return NULL; }
+    pool->capacity = capacity;
+    return pool;
+}
+
+void pyin_pool_destroy(PYINPool *pool)
+{
+    if (!pool) return;
+    for (int i = 0; i < pool->capacity; i++)
+        pyin_destroy(pool->slots[i]);
+    free(pool->slots);
+    free(pool);
+}
+
+bool pyin_pool_add(PYINPool *pool, PYINContext *ctx)
+{
+    if (!ctx->cfg.async_mode) return false;
+    for (int i = 0; i < pool->capacity; i++) {
+        if (atomic_cas_ptr((void **)&pool->slots[i], NULL, ctx))
+            return true;
+    }
+    return false;
+}
+
+void pyin_pool_release(PYINContext *ctx)
+{
+    atomic_store_u32(&ctx->released, 1);
+}
+
+int pyin_pool_work(PYINPool *pool)
+{
+    int  frames = 0;
+    bool busy   = true;
+    PYINResult result;
+
+    /* One frame per context per round, so a context with a large backlog
+     * does not starve the others */
+    while (busy) {
+        busy = false;
+        for (int i = 0; i < pool->capacity; i++) {
+            PYINContext *ctx = (PYINContext *)atomic_load_ptr((void **)&pool->slots[i]);
+            if (!ctx) continue;
+            if (atomic_load_u32(&ctx->released)) {
+                atomic_store_ptr((void **)&pool->slots[i], NULL);
+                pyin_destroy(ctx);
+                continue;
+            }
+            if (async_analyse_next(ctx, &result)) {
+                async_publish(ctx, &result);
+                frames++;
+                busy = true;
+            }
+        }
+    }
+    return frames;
+}
+
+/* ── Offline analysis ───────────────────────────────────────────────────── */
+
+#define OFFLINE_CHUNK 8    /* frames handed out to a worker at a time */
+
+struct PYINOffline {
+    PYINConfig    cfg;
+    const float  *samples;
+    long          n_samples;
+    int           n_frames;
+    int           n_total;       /* n_pitched + 1                          */
+    int           n_workers;
+    PYINContext **workers;       /* per-worker scratch buffers and tables  */
+    float        *log_obs;       /* [n_frames * n_total]                   */
+    uint8_t      *back;          /* [n_frames * n_pitched * back_size]     */
+    int16_t      *back_uv;       /* [n_frames]                             */
+    float        *score;         /* [2 * n_total], decoder columns         */
+    uint8_t      *gated;         /* [n_frames]                             */
+    int          *path;          /* [n_frames]                             */
+    PYINResult   *results;       /* [n_frames]                             */
+    uint32_t      next_chunk;    /* work distribution within a phase       */
+};
+
+PYINOffline *pyin_offline_create(PYINConfig cfg, const float *samples, long n_samples,
+                                 int n_workers)
+{
+    if (n_samples < 0 || n_workers < 1) return NULL;
+    /* Frames are not tied to blocks offline */
+    cfg.block_size      = cfg.hop_size;
+    cfg.spread_analysis = false;
+    cfg.async_mode      = false;
+    if (cfg.hop_size <= 0 || n_samples / cfg.hop_size >= INT_MAX - 1) return NULL;
+
+    PYINOffline *off = (PYINOffline *)calloc(1, sizeof(PYINOffline));
+    if (!off) return NULL;
+    off->cfg       = cfg;
+    off->samples   = samples;
+    off->n_samples = n_samples;
+    off->n_frames  = (int)(n_samples / cfg.hop_size) + 1;
+    off->n_workers = n_workers;
+    off->workers   = (PYINContext **)calloc((size_t)n_workers, sizeof(PYINContext *));
+    if (!off->workers) goto fail;
+    PYINTables *tables = pyin_tables_create(cfg, NULL, NULL, NULL);
+    for (int w = 0; w < n_workers && tables; w++) {
+        off->workers[w] = pyin_create_shared(cfg, tables, NULL, NULL, NULL);
+        if (!off->workers[w]) break;
+    }
+    pyin_tables_release(tables);
+    if (!off->workers[n_workers - 1]) goto fail;
+    off->n_total = off->workers[0]->n_pitched + 1;
+
+    const HMM   *h     = &off->workers[0]->hmm;
+    const size_t cells = (size_t)off->n_frames * (size_t)off->n_total;
+    off->log_obs = (float *)malloc(cells * sizeof(float));
+    off->back    = (uint8_t *)malloc((size_t)off->n_frames * (size_t)h->n_pitched
+                                     * (size_t)h->back_size);
+    off->back_uv = (int16_t *)malloc((size_t)off->n_frames * sizeof(int16_t));
+    off->score   = (float *)malloc(2 * (size_t)off->n_total * sizeof(float));
+    off->gated   = (uint8_t *)calloc((size_t)off->n_frames, sizeof(uint8_t));
+    off->path    = (int *)calloc((size_t)off->n_frames, sizeof(int));
+    off->results = (PYINResult *)calloc((size_t)off->n_frames, sizeof(PYINResult));
+    if (!off->log_obs || !off->back || !off->back_uv || !off->score || !off->gated ||
+        !off->path || !off->results) goto fail;
+    return off;
+
+fail:
+    pyin_offline_destroy(off);
+    return NULL;
+}
+
+void pyin_offline_destroy(PYINOffline *off)
+{
+    if (!off) return;
+    if (off->workers) {
+        for (int w = 0; w < off->n_workers; w++)
+            pyin_destroy(off->workers[w]);
+        free(off->workers);
+    }
+    free(off->log_obs);
+    free(off->back);
+    free(off->back_uv);
+    free(off->score);
+    free(off->gated);
+    free(off->path);
+    free(off->results);
+    free(off);
+}
+
+int pyin_offline_num_frames(const PYINOffline *off)
+{
+    return off->n_frames;
+}
+
+const PYINResult *pyin_offline_results(const PYINOffline *off)
+{
+    return off->results;
+}
+
+/* Copy the (centred, zero padded) frame i into ctx->frame and compute its
+ * observations, leaving the per-lag data of the frame in ctx */
+static void offline_observe_frame(const PYINOffline *off, PYINContext *ctx, int i)
+{
+    const int  W     = off->cfg.frame_size;
+    const long start = (long)i * off->cfg.hop_size - W / 2;
+    long lo = start < 0 ? 0 : start;
+    long hi = start + W > off->n_samples ? off->n_samples : start + W;
+
+    memset(ctx->frame, 0, (size_t)W * sizeof(float));
+    if (hi > lo)
+        memcpy(ctx->frame + (lo - start), off->samples + lo,
+               (size_t)(hi - lo) * sizeof(float));
+
+    analysis_start(ctx);
+    ctx->job.observe_only = true;
+    analysis_run(ctx, LONG_MAX);
+}
+
+/* Claim the next chunk of frames; returns false when the phase is done */
+static bool offline_next_chunk(PYINOffline *off, int *begin, int *end)
+{
+    long b = (long)atomic_fetch_add_u32(&off->next_chunk, 1) * OFFLINE_CHUNK;
+    if (b >= off->n_frames) return false;
+    *begin = (int)b;
+    *end   = b + OFFLINE_CHUNK < off->n_frames ? (int)b + OFFLINE_CHUNK : off->n_frames;
+    return true;
+}
+
+void pyin_offline_observe(PYINOffline *off, int worker)
+{
+    PYINContext *ctx = off->workers[worker];
+    const int n_total = off->n_total;
+    int begin, end;
+    while (offline_next_chunk(off, &begin, &end)) {
+        for (int i = begin; i < end; i++) {
+            offline_observe_frame(off, ctx, i);
+            memcpy(off->log_obs + (size_t)i * n_total, ctx->log_obs,
+                   (size_t)n_total * sizeof(float));
+            off->gated[i] = ctx->job.gated;
+        }
+    }
+}
+
+void pyin_offline_decode(PYINOffline *off)
+{
+    const HMM *h       = &off->workers[0]->hmm;
+    const int  np      = h->n_pitched;
+    const int  n_total = off->n_total;
+    float *prev = off->score;
+    float *cur  = off->score + n_total;
+
+    /* Uniform prior over all states (voiced + unvoiced) */
+    float log_prior = -logf((float)n_total);
+    for (int s = 0; s < n_total; s++)
+        prev[s] = log_prior + off->log_obs[s];
+
+    for (int t = 1; t < off->n_frames; t++) {
+        const float *log_obs = off->log_obs + (size_t)t * n_total;
+        uint8_t     *back    = off->back + (size_t)t * np * h->back_size;
+        viterbi_voiced(h, prev, cur, back, log_obs, 0, np);
+        viterbi_unvoiced(h, prev, cur, &off->back_uv[t], log_obs);
+
+        /* Renormalise: scores would otherwise grow without bound over a
+         * long signal and lose float resolution.  A constant shift does
+         * not change any decision. */
+        float top = cur[0];
+        for (int s = 1; s < n_total; s++)
+            top = cur[s] > top ? cur[s] : top;
+        for (int s = 0; s < n_total; s++)
+            cur[s] -= top;
+
+        float *tmp = prev; prev = cur; cur = tmp;
+    }
+
+    /* Backtrace from the best final state */
+    int best = 0;
+    for (int s = 1; s < n_total; s++)
+        if (prev[s] > prev[best]) best = s;
+    off->path[off->n_frames - 1] = best;
+    for (int t = off->n_frames - 1; t > 0; t--) {
+        const int s = off->path[t];
+        off->path[t - 1] = s == np
+            ? off->back_uv[t]
+            : back_state(h, s, back_load(h, off->back + (size_t)t * np * h->back_size, s));
+    }
+
+    off->next_chunk = 0;   /* for pyin_offline_refine */
+}
+
+void pyin_offline_refine(PYINOffline *off, int worker)
+{
+    PYINContext *ctx = off->workers[worker];
+    const int np = ctx->n_pitched;
+    int begin, end;
+    while (offline_next_chunk(off, &begin, &end)) {
+        for (int i = begin; i < end; i++) {
+            if (off->gated[i] || off->path[i] == np) {
+                decode_state(ctx, np, &off->results[i]);
+                continue;
+            }
+            offline_observe_frame(off, ctx, i);
+            decode_state(ctx, off->path[i], &off->results[i]);
+        }
+    }
+}
+
+bool pyin_analyse_signal(PYINConfig cfg, const float *samples, long n_samples,
+                         PYINResult *results)
+{
+    PYINOffline *off = pyin_offline_create(cfg, samples, n_samples, 1);
+    if (!off) return false;
+    pyin_offline_observe(off, 0);
+    pyin_offline_decode(off);
+    pyin_offline_refine(off, 0);
+    memcpy(results, off->results, (size_t)off->n_frames * sizeof(PYINResult));
+    pyin_offline_destroy(off);
+    return true;
 }
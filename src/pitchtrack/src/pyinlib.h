@@ -30,6 +30,8 @@
  *   f0_max < sample_rate / 2
  *   cents_per_semitone in {1, 2, 4, 5, 10, 20, 25, 50, 100}
  *   voiced_transition_weight in (0, 1]
+ *   diff_method in {PYIN_DIFF_AUTO, PYIN_DIFF_DIRECT, PYIN_DIFF_FFT}
+ *   not both spread_analysis and async_mode
  */
 typedef struct {
     float sample_rate;          /* Hz  (e.g. 44100, 48000)                   */
@@ -239,8 +241,73 @@ typedef struct {
      */
     float octave_subharmonic_threshold;  /* Default: 3.0f */
 
+    /**
+     * Method used to compute the lagged cross-product of the YIN difference
+     * function.
+     *
+     *   PYIN_DIFF_AUTO   – direct for small frames, FFT once
+     *                      frame_size × lag_max exceeds PYIN_FFT_THRESHOLD
+     *   PYIN_DIFF_DIRECT – one dot product per lag, O(W × lag_max)
+     *   PYIN_DIFF_FFT    – autocorrelation via a real FFT, O(N log N) with
+     *                      N = next_pow2(frame_size + lag_max)
+     *
+     * Both paths produce the same CMNDF up to float rounding.
+     * Default: PYIN_DIFF_AUTO
+     */
+    int diff_method;  /* Default: PYIN_DIFF_AUTO */
+
+    /**
+     * Spread the analysis of each frame over the hop_size / block_size calls
+     * to pyin_process_block() that follow its capture, instead of running it
+     * all in the call where the hop completes.
+     *
+     * With hop 512 and block 32 the default mode does all the work in one of
+     * every 16 calls; spreading it gives a (roughly) constant cost per call,
+     * at the price of hop_size - block_size samples of extra latency, see
+     * pyin_get_latency().  Results are identical.
+     *
+     * Default: false
+     */
+    bool spread_analysis;  /* Default: false */
+
+    /**
+     * Analyse frames on a worker thread (see "Asynchronous analysis" below).
+     *
+     * The audio thread only pushes samples (pyin_async_push) into a
+     * single-producer / single-consumer lock-free ring and polls for the
+     * latest result (pyin_async_poll); frames are analysed by whichever
+     * thread calls pyin_pool_work() on the PYINPool the context was added
+     * to.  pyin_process_block() must not be used with such a context.
+     *
+     * The worker may lag up to PYIN_ASYNC_BACKLOG_HOPS hops behind the audio
+     * thread; older frames are skipped.  Cannot be combined with
+     * spread_analysis.
+     *
+     * Default: false
+     */
+    bool async_mode;  /* Default: false */
+
 } PYINConfig;
 
+enum {
+    PYIN_DIFF_AUTO   = 0,
+    PYIN_DIFF_DIRECT = 1,
+    PYIN_DIFF_FFT    = 2
+};
+
+/**
+ * With PYIN_DIFF_AUTO the FFT path is used when frame_size × lag_max is at
+ * least this value (e.g. framesize 2048 with fmin ≲ 85 Hz at 44.1 kHz), which
+ * is roughly where the FFT path starts to be faster.
+ */
+#define PYIN_FFT_THRESHOLD  (1 << 20)
+
+/**
+ * With async_mode, number of hops the analysis thread can fall behind the
+ * audio thread before frames are dropped.
+ */
+#define PYIN_ASYNC_BACKLOG_HOPS  8
+
 /**
  * Return a PYINConfig filled with sensible defaults:
  *   sample_rate               = 44100 Hz
@@ -258,6 +325,9 @@ typedef struct {
  *   voiced_obs_floor          = 0.0
  *   octave_cost_weight        = 0.0
  *   octave_subharmonic_threshold = 3.0
+ *   diff_method               = PYIN_DIFF_AUTO
+ *   spread_analysis           = false
+ *   async_mode                = false
  */
 PYINConfig pyin_config_default(void);
 
@@ -272,6 +342,7 @@ typedef struct {
 /* ── Opaque context ──────────────────────────────────────────────────────── */
 
 typedef struct PYINContext PYINContext;
+typedef struct PYINTables  PYINTables;
 
 typedef void* (*allocfn_t)(void *p, size_t num);
 typedef void (*freefn_t)(void *p, void *mem);
@@ -290,6 +361,39 @@ PYINContext *pyin_create(PYINConfig cfg, allocfn_t allocfn, freefn_t freefn, voi
  */
 void pyin_destroy(PYINContext *ctx);
 
+/* ── Shared tables ──────────────────────────────────────────────────────── */
+
+/*
+ * The lookup tables derived from the config (HMM transition band, state →
+ * lag interpolation, beta CDF) are immutable and can be shared by several
+ * contexts, e.g. the channels of a multichannel tracker.  pyin_create()
+ * builds a private set; to share, build them once and create the contexts
+ * with pyin_create_shared().
+ *
+ * Tables are reference counted: each context holds a reference, so the
+ * caller can release its own reference as soon as the contexts exist.
+ * Release is thread-safe, but the tables are freed with the allocator they
+ * were created with, by whichever thread drops the last reference.
+ */
+
+/**
+ * Build the tables for cfg.  Returns NULL on invalid config or allocation
+ * failure.  The returned reference is owned by the caller.
+ */
+PYINTables *pyin_tables_create(PYINConfig cfg, allocfn_t allocfn, freefn_t freefn, void *allocdata);
+
+/** Drop a reference.  Safe to call with NULL. */
+void pyin_tables_release(PYINTables *tables);
+
+/**
+ * Like pyin_create(), using shared tables.  cfg may differ from the config
+ * of the tables only in fields which do not affect them (frame/hop/block
+ * size, energy gate, octave cost, voiced_obs_floor, diff_method, spread /
+ * async mode); returns NULL otherwise.
+ */
+PYINContext *pyin_create_shared(PYINConfig cfg, PYINTables *tables,
+                                allocfn_t allocfn, freefn_t freefn, void *allocdata);
+
 /**
  * Return a read-only pointer to the configuration stored in ctx.
  */
@@ -300,6 +404,8 @@ const PYINConfig *pyin_get_config(const PYINContext *ctx);
  *
  * Once the ring-buffer holds a full frame and cfg.hop_size new samples have
  * arrived since the last analysis, one frame is processed and *result is set.
+ * With cfg.spread_analysis the result for that frame is delivered
+ * pyin_get_latency() samples later.
  *
  * Returns true  → *result holds a fresh pitch estimate.
  * Returns false → more samples needed; *result is unchanged.
@@ -308,6 +414,156 @@ bool pyin_process_block(PYINContext   *ctx,
                         const float   *samples,  /* length == cfg.block_size */
                         PYINResult    *result);
 
+/**
+ * Return the CMNDF computed for the most recently analysed frame and set
+ * *len to its length (lag_max + 1).  Values are undefined before the first
+ * analysed frame and for frames skipped by the energy gate.
+ * Intended for testing and visualisation.
+ */
+const float *pyin_get_cmndf(const PYINContext *ctx, int *len);
+
+/**
+ * Return true if ctx computes the difference function via FFT.
+ */
+bool pyin_uses_fft(const PYINContext *ctx);
+
+/**
+ * Extra latency, in samples, added by cfg.spread_analysis
+ * (hop_size - block_size), 0 otherwise.
+ */
+int pyin_get_latency(const PYINContext *ctx);
+
+/* ── Asynchronous analysis ──────────────────────────────────────────────── */
+
+/*
+ * Contexts created with cfg.async_mode are analysed on a separate thread:
+ *
+ *   audio thread                      analysis thread
+ *   ────────────                      ───────────────
+ *   pyin_async_push(ctx, block)  ─┐
+ *     (returns true → wake worker) └─▶ pyin_pool_work(pool)
+ *                                       analyses every pending frame of
+ *                                       every context in the pool
+ *   pyin_async_poll(ctx, &res)   ◀──── publishes the latest PYINResult
+ *
+ * Samples go through a lock-free SPSC ring and results through a seqlock,
+ * so neither side ever blocks the other.  pyin_async_push/poll are
+ * wait-free and do not allocate.
+ *
+ * Ownership: once a context has been added to a pool, release it with
+ * pyin_pool_release(); the pool destroys it from the analysis thread, so
+ * its allocator must be thread-safe (e.g. pass NULL to use calloc/free).
+ */
+
+typedef struct PYINPool PYINPool;
+
+/**
+ * Create a pool holding up to `capacity` contexts.  Returns NULL on failure.
+ */
+PYINPool *pyin_pool_create(int capacity);
+
+/**
+ * Destroy the pool and every context still in it.  No thread may be inside
+ * pyin_pool_work() or using any of its contexts.
+ */
+void pyin_pool_destroy(PYINPool *pool);
+
+/**
+ * Add an async_mode context.  Lock-free, callable from any thread.
+ * Returns false if the pool is full or ctx is not in async_mode.
+ */
+bool pyin_pool_add(PYINPool *pool, PYINContext *ctx);
+
+/**
+ * Hand ctx back to the pool: it will be destroyed by the next
+ * pyin_pool_work() call.  ctx must not be used after this.
+ */
+void pyin_pool_release(PYINContext *ctx);
+
+/**
+ * Analyse all pending frames of all contexts in the pool, round-robin one
+ * frame per context at a time, and destroy released contexts.
+ * Call from a single (analysis) thread.  Returns the number of frames
+ * analysed.
+ */
+int pyin_pool_work(PYINPool *pool);
+
+/**
+ * Audio thread: push exactly cfg.block_size samples.  Returns true when a
+ * new frame became due, i.e. the analysis thread should be woken up.
+ */
+bool pyin_async_push(PYINContext *ctx, const float *samples);
+
+/**
+ * Audio thread: if a result newer than the last one polled has been
+ * published, copy it to *result and return true.
+ */
+bool pyin_async_poll(PYINContext *ctx, PYINResult *result);
+
+/**
+ * Number of frames the analysis thread skipped because it fell more than
+ * PYIN_ASYNC_BACKLOG_HOPS hops behind.  Callable from any thread.
+ */
+int pyin_async_dropped(const PYINContext *ctx);
+
+/* ── Offline analysis ───────────────────────────────────────────────────── */
+
+/*
+ * Whole-signal analysis with full (non-causal) Viterbi decoding, as in the
+ * original pYIN: the realtime tracker reports the best *current* state of a
+ * VITERBI_DEPTH window, the offline decoder backtraces the single best path
+ * through the whole signal.
+ *
+ * Frames are centred: frame i covers [i*hop - frame_size/2, ...) of the
+ * signal (zero padded at both ends), so there are n_samples/hop + 1 frames
+ * and frame i corresponds to time i*hop/sr.  cfg.block_size is ignored.
+ *
+ * The work is split in three phases; phases 1 and 3 can run on several
+ * threads, each calling the phase function once with its own worker index
+ * in [0, n_workers).  All workers must finish a phase before the next
+ * phase starts.
+ *
+ *   1. pyin_offline_observe(off, worker)   per-frame observations
+ *   2. pyin_offline_decode(off)            full Viterbi + backtrace
+ *   3. pyin_offline_refine(off, worker)    confidence and refined pitch
+ *
+ * Memory: about n_frames * (n_pitched + 1) * 6 bytes for the observations
+ * and backpointers (n_pitched = 88 * cents_per_semitone).
+ */
+
+typedef struct PYINOffline PYINOffline;
+
+/**
+ * Prepare the analysis of samples[0 .. n_samples-1].  The samples are not
+ * copied and must stay valid until pyin_offline_destroy().  Returns NULL on
+ * invalid config or allocation failure.
+ */
+PYINOffline *pyin_offline_create(PYINConfig cfg, const float *samples, long n_samples,
+                                 int n_workers);
+
+void pyin_offline_destroy(PYINOffline *off);
+
+int  pyin_offline_num_frames(const PYINOffline *off);
+
+/** Phase 1. Frames are handed out to the workers in chunks. */
+void pyin_offline_observe(PYINOffline *off, int worker);
+
+/** Phase 2, single threaded. */
+void pyin_offline_decode(PYINOffline *off);
+
+/** Phase 3. Only voiced frames are re-analysed. */
+void pyin_offline_refine(PYINOffline *off, int worker);
+
+/** Results, one per frame, valid after phase 3. */
+const PYINResult *pyin_offline_results(const PYINOffline *off);
+
+/**
+ * Convenience: run all three phases on the calling thread and copy
+ * n_samples/hop + 1 results to `results`.  Returns false on failure.
+ */
+bool pyin_analyse_signal(PYINConfig cfg, const float *samples, long n_samples,
+                         PYINResult *results);
+
 /**
  * Reset all internal state (ring-buffer, HMM trellis, hop counter).
  * Configuration is preserved.
@@ -0,0 +1,223 @@
+/*
+ * pyin_async_test.c – asynchronous analysis vs. synchronous analysis
+ *
+ * Runs the synthetic speech signal from pyin_signals.h through a regular
+ * pYIN context and through async contexts served by a PYINPool:
+ *
+ *   lockstep  the pool is worked from the audio loop right after each due
+ *             push; the async track must equal the synchronous one exactly.
+ *   threaded  the pool is worked by a separate thread while several
+ *             contexts are pushed at SPEEDUP times real time.  Results of
+ *             contexts that dropped no frame must match the synchronous
+ *             track, in order (poll only returns the latest result, so some
+ *             may be missing); after a drop the HMM sees a different
+ *             observation sequence, so only plausibility is checked.
+ *
+ * Exits with status 0 on success, 1 on failure.
+ *
+ * Compile:
+ *   gcc -O2 -Wall -Wextra -I../src -o pyin_async_test pyin_async_test.c ../src/pyinlib.c -lm -lpthread
+ */
+
+#include "pyinlib.h"
+#include "pyin_signals.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#define MAX_RESULTS  4096
+#define N_CONTEXTS   4
+
+/* The threaded test pushes blocks at this multiple of real time */
+#define SPEEDUP      2
+
+typedef struct {
+    PYINResult res[MAX_RESULTS];
+    int        count;
+} Track;
+
+static bool same_result(const PYINResult *a, const PYINResult *b)
+{
+    return a->voiced == b->voiced && a->pitch_hz == b->pitch_hz
+        && a->confidence == b->confidence;
+}
+
+static PYINConfig test_config(float sr, bool async)
+{
+    PYINConfig cfg = pyin_config_default();
+    cfg.sample_rate = sr;
+    cfg.frame_size  = 2048;
+    cfg.hop_size    = 256;
+    cfg.block_size  = 64;
+    cfg.energy_gate_rms = 1e-8f;
+    cfg.async_mode  = async;
+    return cfg;
+}
+
+static const float *get_block(const float *samples, int n_samples, int pos, int bsz, float *block)
+{
+    int copy = n_samples - pos;
+    if (copy > bsz) copy = bsz;
+    memset(block, 0, (size_t)bsz * sizeof(float));
+    memcpy(block, samples + pos, (size_t)copy * sizeof(float));
+    return block;
+}
+
+static void run_sync(const float *samples, int n_samples, float sr, Track *t)
+{
+    PYINContext *ctx = pyin_create(test_config(sr, false), NULL, NULL, NULL);
+    float block[64];
+    t->count = 0;
+    for (int pos = 0; pos < n_samples; pos += 64) {
+        PYINResult res;
+        if (pyin_process_block(ctx, get_block(samples, n_samples, pos, 64, block), &res)
+            && t->count < MAX_RESULTS)
+            t->res[t->count++] = res;
+    }
+    pyin_destroy(ctx);
+}
+
+static bool test_lockstep(const float *samples, int n_samples, float sr, const Track *ref)
+{
+    PYINPool *pool = pyin_pool_create(1);
+    PYINContext *ctx = pyin_create(test_config(sr, true), NULL, NULL, NULL);
+    if (!pool || !ctx || !pyin_pool_add(pool, ctx)) {
+        fprintf(stderr, "lockstep: setup failed\n");
+        pyin_destroy(ctx);
+        pyin_pool_destroy(pool);
+        return false;
+    }
+    static Track t;
+    float block[64];
+    int mismatches = 0;
+    t.count = 0;
+    for (int pos = 0; pos < n_samples; pos += 64) {
+        PYINResult res;
+        if (pyin_async_push(ctx, get_block(samples, n_samples, pos, 64, block)))
+            pyin_pool_work(pool);
+        if (pyin_async_poll(ctx, &res) && t.count < MAX_RESULTS)
+            t.res[t.count++] = res;
+    }
+    if (t.count != ref->count)
+        mismatches++;
+    for (int i = 0; i < t.count && i < ref->count; i++)
+        if (!same_result(&t.res[i], &ref->res[i]))
+            mismatches++;
+
+    pyin_pool_release(ctx);
+    pyin_pool_work(pool);           /* destroys the released context */
+    pyin_pool_destroy(pool);
+
+    bool ok = mismatches == 0;
+    printf("%s  lockstep  results=%d/%d\n", ok ? "PASS" : "FAIL", t.count, ref->count);
+    return ok;
+}
+
+typedef struct {
+    PYINPool *pool;
+    int       quit;
+} Worker;
+
+static void *worker_main(void *arg)
+{
+    Worker *w = (Worker *)arg;
+    while (!__atomic_load_n(&w->quit, __ATOMIC_ACQUIRE)) {
+        if (pyin_pool_work(w->pool) == 0)
+            sched_yield();
+    }
+    return NULL;
+}
+
+static bool test_threaded(const float *samples, int n_samples, float sr, const Track *ref)
+{
+    PYINPool *pool = pyin_pool_create(N_CONTEXTS);
+    PYINContext *ctx[N_CONTEXTS];
+    static Track t[N_CONTEXTS];
+    int mismatches = 0;
+    for (int c = 0; c < N_CONTEXTS; c++) {
+        ctx[c] = pyin_create(test_config(sr, true), NULL, NULL, NULL);
+        if (!pool || !ctx[c] || !pyin_pool_add(pool, ctx[c])) {
+            fprintf(stderr, "threaded: setup failed\n");
+            return false;
+        }
+        t[c].count = 0;
+    }
+
+    Worker w = { pool, 0 };
+    pthread_t thread;
+    pthread_create(&thread, NULL, worker_main, &w);
+
+    const long block_ns = (long)(64.0 / sr * 1e9 / SPEEDUP);
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    float block[64];
+    for (int pos = 0; pos < n_samples; pos += 64) {
+        deadline.tv_nsec += block_ns;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_nsec -= 1000000000L;
+            deadline.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+        get_block(samples, n_samples, pos, 64, block);
+        for (int c = 0; c < N_CONTEXTS; c++) {
+            PYINResult res;
+            pyin_async_push(ctx[c], block);
+            if (!pyin_async_poll(ctx[c], &res) || t[c].count >= MAX_RESULTS)
+                continue;
+            t[c].res[t[c].count++] = res;
+        }
+    }
+
+    __atomic_store_n(&w.quit, 1, __ATOMIC_RELEASE);
+    pthread_join(thread, NULL);
+
+    const PYINConfig *cfg = pyin_get_config(ctx[0]);
+    int delivered = 0, dropped = 0;
+    for (int c = 0; c < N_CONTEXTS; c++) {
+        const int ctx_dropped = pyin_async_dropped(ctx[c]);
+        int next = 0;       /* next candidate index into ref */
+        for (int i = 0; i < t[c].count; i++) {
+            const PYINResult *res = &t[c].res[i];
+            if (ctx_dropped == 0) {
+                while (next < ref->count && !same_result(res, &ref->res[next]))
+                    next++;
+                if (next == ref->count) mismatches++;
+                else next++;
+            } else if (!isfinite(res->pitch_hz) || !isfinite(res->confidence) ||
+                       (res->voiced && (res->pitch_hz < cfg->f0_min || res->pitch_hz > cfg->f0_max))) {
+                mismatches++;
+            }
+        }
+        delivered += t[c].count;
+        dropped   += ctx_dropped;
+        pyin_pool_release(ctx[c]);
+    }
+    pyin_pool_work(pool);
+    pyin_pool_destroy(pool);
+
+    bool ok = mismatches == 0 && delivered > 0;
+    printf("%s  threaded  contexts=%d  results=%d  dropped=%d  mismatches=%d\n",
+           ok ? "PASS" : "FAIL", N_CONTEXTS, delivered, dropped, mismatches);
+    return ok;
+}
+
+int main(void)
+{
+    const float sr = 44100.0f;
+    const int   n  = (int)(2.0f * sr);
+    float *buf = (float *)malloc((size_t)n * sizeof(float));
+    if (!buf) { fprintf(stderr, "Out of memory\n"); return 1; }
+    synth_speech(buf, n, sr);
+
+    static Track ref;
+    run_sync(buf, n, sr, &ref);
+
+    bool ok = true;
+    ok &= test_lockstep(buf, n, sr, &ref);
+    ok &= test_threaded(buf, n, sr, &ref);
+
+    free(buf);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,467 @@
+/*
+ * pyin_bench.c – pYIN speed / accuracy benchmark
+ *
+ * Runs a set of labelled corpora through a set of tracker configurations
+ * and reports, for each pair, the gross pitch error (voiced frames more
+ * than 50 cents off), the voicing decision error and the realtime factor
+ * (analysis time / signal duration).  Meant to be run before and after any
+ * change to the analysis (difference function, beta prior, HMM) to check
+ * speed and accuracy together.
+ *
+ * Synthetic corpora, all with known F0:
+ *   speech     synth_speech() from pyin_signals.h
+ *   glide      exponential glide 80 → 800 Hz
+ *   vibrato    220 Hz, 6 Hz / ±100 cents vibrato, broken by a noise burst
+ *   missing    harmonics 2–10 of a 150 → 250 Hz glide, no fundamental
+ *   speech@N   speech plus white noise at N dB SNR (20, 10, 5), relative
+ *              to the RMS of the voiced segments
+ * glide, vibrato and missing start with silence and end with quiet noise,
+ * so voicing decisions are scored in all corpora.
+ *
+ * Usage:
+ *   pyin_bench [--check] [--config NAME] [file.wav f0.csv ...]
+ *
+ *   --check        exit with status 1 if the default configuration exceeds
+ *                  the error limits of a synthetic corpus (regression test)
+ *   --config NAME  only run this configuration
+ *   file.wav f0.csv
+ *                  additional corpora.  The CSV holds one "time,f0" pair
+ *                  per line (seconds, Hz; f0 <= 0 = unvoiced, extra columns
+ *                  and lines not starting with a number are ignored).
+ *
+ * Frames within 30 ms of a voicing change in the ground truth are not
+ * scored.  Realtime tracks are scored at the centre of each analysed frame.
+ *
+ * Compile:
+ *   gcc -O2 -Wall -Wextra -I../src -o pyin_bench pyin_bench.c ../src/pyinlib.c -lm
+ */
+
+#include "pyinlib.h"
+#include "pyin_signals.h"
+
+#include <time.h>
+
+#define GPE_CENTS     50.0
+#define BOUNDARY_SECS 0.03f
+#define MAX_CORPORA   64
+
+/* =========================================================================
+ * Corpora
+ * ========================================================================= */
+
+typedef struct {
+    char   name[64];
+    float *samples;
+    int    n_samples;
+    float  sr;
+    /* Ground truth: f0[i] at time t[i], sorted by time (0 = unvoiced) */
+    float *t;
+    float *f0;
+    int    n_truth;
+    /* --check limits for the default config, in % (< 0: not checked) */
+    double max_gpe;
+    double max_voicing;
+} Corpus;
+
+static void corpus_free(Corpus *c)
+{
+    free(c->samples);
+    free(c->t);
+    free(c->f0);
+    memset(c, 0, sizeof(Corpus));
+}
+
+/* Ground truth at time t: linear between voiced points, nearest otherwise */
+static float truth_at(const Corpus *c, float t)
+{
+    if (c->n_truth == 0 || t < c->t[0] || t > c->t[c->n_truth - 1])
+        return 0.0f;
+    int lo = 0, hi = c->n_truth - 1;
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (c->t[mid] <= t) lo = mid;
+        else                hi = mid;
+    }
+    float f_lo = c->f0[lo], f_hi = c->f0[hi];
+    if (f_lo > 0.0f && f_hi > 0.0f && c->t[hi] > c->t[lo]) {
+        float a = (t - c->t[lo]) / (c->t[hi] - c->t[lo]);
+        return f_lo + a * (f_hi - f_lo);
+    }
+    return t - c->t[lo] < c->t[hi] - t ? f_lo : f_hi;
+}
+
+static bool near_voicing_change(const Corpus *c, float t)
+{
+    return (truth_at(c, t - BOUNDARY_SECS) > 0.0f) != (truth_at(c, t + BOUNDARY_SECS) > 0.0f);
+}
+
+/* Sample the ground truth of a synthetic corpus every millisecond */
+typedef float (*f0_fn)(float t);
+
+static bool corpus_alloc(Corpus *c, const char *name, float secs, float sr, f0_fn f0)
+{
+    memset(c, 0, sizeof(Corpus));
+    snprintf(c->name, sizeof(c->name), "%s", name);
+    c->sr        = sr;
+    c->n_samples = (int)(secs * sr);
+    c->n_truth   = (int)(secs * 1000.0f) + 1;
+    c->samples   = (float *)calloc((size_t)c->n_samples, sizeof(float));
+    c->t         = (float *)malloc((size_t)c->n_truth * sizeof(float));
+    c->f0        = (float *)malloc((size_t)c->n_truth * sizeof(float));
+    c->max_gpe = c->max_voicing = -1.0;
+    if (!c->samples || !c->t || !c->f0) {
+        corpus_free(c);
+        return false;
+    }
+    for (int i = 0; i < c->n_truth; i++) {
+        c->t[i]  = (float)i * 0.001f;
+        c->f0[i] = f0(c->t[i]);
+    }
+    return true;
+}
+
+/* Harmonics first..last of f0 at phase (in cycles), amplitude 1/k */
+static float harmonics(double phase, int first, int last, float f0, float sr)
+{
+    float sum = 0.0f;
+    for (int k = first; k <= last && k * f0 < 0.45f * sr; k++)
+        sum += sinf((float)(2.0 * M_PI * k * phase)) / (float)k;
+    return sum;
+}
+
+/* Layout shared by glide / vibrato / missing: 0.25 s silence, voiced until
+ * TAIL, then quiet noise */
+#define LEAD_SECS   0.25f
+#define TAIL_SECS   2.25f
+#define TOTAL_SECS  2.5f
+
+static float glide_f0(float t)
+{
+    if (t < LEAD_SECS || t >= TAIL_SECS) return 0.0f;
+    return 80.0f * powf(10.0f, (t - LEAD_SECS) / (TAIL_SECS - LEAD_SECS));
+}
+
+/* Noise burst (unvoiced) in the middle */
+#define GAP_START   1.2f
+#define GAP_END     1.4f
+
+static float vibrato_f0(float t)
+{
+    if (t < LEAD_SECS || t >= TAIL_SECS || (t >= GAP_START && t < GAP_END)) return 0.0f;
+    return 220.0f * powf(2.0f, sinf(2.0f * (float)M_PI * 6.0f * t) / 12.0f);
+}
+
+static float missing_f0(float t)
+{
+    if (t < LEAD_SECS || t >= TAIL_SECS) return 0.0f;
+    return 150.0f + 100.0f * (t - LEAD_SECS) / (TAIL_SECS - LEAD_SECS);
+}
+
+static float speech_truth(float t) { return speech_f0_at(t); }
+
+/* Render a tone following the ground truth, noise where it is unvoiced */
+static void render_tone(Corpus *c, f0_fn f0, int first, int last)
+{
+    double phase = 0.0;
+    for (int i = 0; i < c->n_samples; i++) {
+        float t = (float)i / c->sr;
+        float f = f0(t);
+        if (f > 0.0f) {
+            phase += (double)f / c->sr;
+            c->samples[i] = 0.3f * harmonics(phase, first, last, f, c->sr);
+        } else if (t >= LEAD_SECS) {
+            c->samples[i] = 0.02f * randf();
+        }
+    }
+}
+
+/* White noise at snr_db relative to the RMS of the voiced samples */
+static void add_noise(Corpus *c, float snr_db)
+{
+    double sum_sq = 0.0;
+    int    n_voiced = 0;
+    for (int i = 0; i < c->n_samples; i++) {
+        if (truth_at(c, (float)i / c->sr) > 0.0f) {
+            sum_sq += (double)c->samples[i] * c->samples[i];
+            n_voiced++;
+        }
+    }
+    if (n_voiced == 0) return;
+    /* randf() is uniform in [-1, 1): rms = 1/sqrt(3) */
+    float level = (float)(sqrt(3.0 * sum_sq / n_voiced) * pow(10.0, -snr_db / 20.0));
+    for (int i = 0; i < c->n_samples; i++)
+        c->samples[i] += level * randf();
+}
+
+static int make_synthetic(Corpus *corpora, float sr)
+{
+    int n = 0;
+    Corpus *c;
+
+    c = &corpora[n];
+    if (corpus_alloc(c, "speech", 2.0f, sr, speech_truth)) {
+        synth_speech(c->samples, c->n_samples, sr);
+        c->max_gpe = 5.0; c->max_voicing = 10.0;
+        n++;
+    }
+    c = &corpora[n];
+    if (corpus_alloc(c, "glide", TOTAL_SECS, sr, glide_f0)) {
+        render_tone(c, glide_f0, 1, 8);
+        c->max_gpe = 5.0; c->max_voicing = 10.0;
+        n++;
+    }
+    c = &corpora[n];
+    if (corpus_alloc(c, "vibrato", TOTAL_SECS, sr, vibrato_f0)) {
+        render_tone(c, vibrato_f0, 1, 8);
+        c->max_gpe = 5.0; c->max_voicing = 10.0;
+        n++;
+    }
+    c = &corpora[n];
+    if (corpus_alloc(c, "missing", TOTAL_SECS, sr, missing_f0)) {
+        render_tone(c, missing_f0, 2, 10);
+        c->max_gpe = 10.0; c->max_voicing = 10.0;
+        n++;
+    }
+    const float snrs[]     = { 20.0f, 10.0f, 5.0f };
+    const double max_gpe[] = { 10.0, 20.0, -1.0 };
+    for (int i = 0; i < 3; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "speech@%gdB", (double)snrs[i]);
+        c = &corpora[n];
+        if (corpus_alloc(c, name, 2.0f, sr, speech_truth)) {
+            synth_speech(c->samples, c->n_samples, sr);
+            add_noise(c, snrs[i]);
+            c->max_gpe = max_gpe[i];
+            c->max_voicing = max_gpe[i] < 0.0 ? -1.0 : 25.0;
+            n++;
+        }
+    }
+    return n;
+}
+
+/* Read "time,f0" lines; returns false if nothing could be read */
+static bool load_truth_csv(const char *path, Corpus *c)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp) { fprintf(stderr, "Cannot open '%s'\n", path); return false; }
+    int cap = 1024;
+    c->t  = (float *)malloc((size_t)cap * sizeof(float));
+    c->f0 = (float *)malloc((size_t)cap * sizeof(float));
+    c->n_truth = 0;
+    char line[512];
+    while (c->t && c->f0 && fgets(line, sizeof(line), fp)) {
+        char *p = line, *end;
+        while (*p == ' ' || *p == '\t') p++;
+        double t = strtod(p, &end);
+        if (end == p) continue;        /* header / comment */
+        p = end;
+        while (*p == ' ' || *p == '\t' || *p == ',' || *p == ';') p++;
+        double f0 = strtod(p, &end);
+        if (end == p) continue;
+        if (c->n_truth == cap) {
+            cap *= 2;
+            c->t  = (float *)realloc(c->t,  (size_t)cap * sizeof(float));
+            c->f0 = (float *)realloc(c->f0, (size_t)cap * sizeof(float));
+            if (!c->t || !c->f0) break;
+        }
+        c->t[c->n_truth]  = (float)t;
+        c->f0[c->n_truth] = f0 > 0.0 ? (float)f0 : 0.0f;
+        c->n_truth++;
+    }
+    fclose(fp);
+    if (!c->t || !c->f0 || c->n_truth == 0) {
+        fprintf(stderr, "No ground truth read from '%s'\n", path);
+        return false;
+    }
+    return true;
+}
+
+static bool load_wav_corpus(Corpus *c, const char *wav, const char *csv)
+{
+    memset(c, 0, sizeof(Corpus));
+    AudioBuffer audio = { NULL, 0, 0.0f };
+    if (!wav_load(wav, &audio)) return false;
+    c->samples   = audio.samples;
+    c->n_samples = audio.n_samples;
+    c->sr        = audio.sample_rate;
+    c->max_gpe = c->max_voicing = -1.0;
+    const char *base = strrchr(wav, '/');
+    snprintf(c->name, sizeof(c->name), "%s", base ? base + 1 : wav);
+    if (!load_truth_csv(csv, c)) {
+        corpus_free(c);
+        return false;
+    }
+    return true;
+}
+
+/* =========================================================================
+ * Configurations
+ * ========================================================================= */
+
+typedef struct {
+    const char *name;
+    bool        offline;
+    void      (*setup)(PYINConfig *cfg);
+} BenchConfig;
+
+static void setup_default(PYINConfig *cfg) { (void)cfg; }
+static void setup_fft(PYINConfig *cfg)     { cfg->diff_method = PYIN_DIFF_FFT; }
+static void setup_direct(PYINConfig *cfg)  { cfg->diff_method = PYIN_DIFF_DIRECT; }
+static void setup_fine(PYINConfig *cfg)    { cfg->cents_per_semitone = 20; }
+static void setup_large(PYINConfig *cfg)
+{
+    cfg->frame_size = 4096;
+    cfg->hop_size   = 1024;
+    cfg->f0_min     = 30.0f;
+}
+
+static const BenchConfig configs[] = {
+    { "default", false, setup_default },   /* the --check reference */
+    { "direct",  false, setup_direct  },
+    { "fft",     false, setup_fft     },
+    { "bins20",  false, setup_fine    },
+    { "large",   false, setup_large   },
+    { "offline", true,  setup_default },
+};
+#define N_CONFIGS ((int)(sizeof(configs) / sizeof(configs[0])))
+
+/* =========================================================================
+ * Scoring
+ * ========================================================================= */
+
+typedef struct {
+    int    scored, voicing_errors, voiced_both, gross_errors;
+    double seconds;            /* analysis time */
+} Score;
+
+static double now_secs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void score_result(Score *sc, const Corpus *c, const PYINResult *r, float t)
+{
+    if (t < 0.0f || near_voicing_change(c, t))
+        return;
+    float f0 = truth_at(c, t);
+    sc->scored++;
+    if ((f0 > 0.0f) != r->voiced) {
+        sc->voicing_errors++;
+    } else if (r->voiced) {
+        sc->voiced_both++;
+        if (r->pitch_hz <= 0.0f || 1200.0 * fabs(log2((double)r->pitch_hz / f0)) > GPE_CENTS)
+            sc->gross_errors++;
+    }
+}
+
+static double gpe_percent(const Score *sc)
+{
+    return sc->voiced_both ? 100.0 * sc->gross_errors / sc->voiced_both : 0.0;
+}
+
+static double voicing_percent(const Score *sc)
+{
+    return sc->scored ? 100.0 * sc->voicing_errors / sc->scored : 0.0;
+}
+
+static bool run(const BenchConfig *bc, const Corpus *c, Score *sc)
+{
+    PYINConfig cfg = pyin_config_default();
+    cfg.sample_rate = c->sr;
+    cfg.energy_gate_rms = 1e-6f;
+    bc->setup(&cfg);
+    memset(sc, 0, sizeof(Score));
+
+    if (bc->offline) {
+        const int n_frames = c->n_samples / cfg.hop_size + 1;
+        PYINResult *res = (PYINResult *)calloc((size_t)n_frames, sizeof(PYINResult));
+        if (!res) return false;
+        double t0 = now_secs();
+        bool ok = pyin_analyse_signal(cfg, c->samples, c->n_samples, res);
+        sc->seconds = now_secs() - t0;
+        for (int i = 0; ok && i < n_frames; i++)
+            score_result(sc, c, &res[i], (float)i * cfg.hop_size / c->sr);
+        free(res);
+        return ok;
+    }
+
+    PYINContext *ctx = pyin_create(cfg, NULL, NULL, NULL);
+    if (!ctx) return false;
+    const int bsz = cfg.block_size;
+    for (int pos = 0; pos + bsz <= c->n_samples; pos += bsz) {
+        PYINResult r;
+        double t0 = now_secs();
+        bool has = pyin_process_block(ctx, c->samples + pos, &r);
+        sc->seconds += now_secs() - t0;
+        if (has) {
+            /* centre of the frame ending at the end of this block */
+            float t = (float)(pos + bsz - pyin_get_latency(ctx) - cfg.frame_size / 2) / c->sr;
+            score_result(sc, c, &r, t);
+        }
+    }
+    pyin_destroy(ctx);
+    return true;
+}
+
+/* =========================================================================
+ * main
+ * ========================================================================= */
+
+int main(int argc, char *argv[])
+{
+    static Corpus corpora[MAX_CORPORA];
+    bool check = false;
+    const char *only = NULL;
+    int n_corpora = make_synthetic(corpora, 44100.0f);
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--check")) {
+            check = true;
+        } else if (!strcmp(argv[i], "--config") && i + 1 < argc) {
+            only = argv[++i];
+        } else if (i + 1 < argc && n_corpora < MAX_CORPORA) {
+            if (!load_wav_corpus(&corpora[n_corpora], argv[i], argv[i + 1]))
+                return 1;
+            n_corpora++;
+            i++;
+        } else {
+            fprintf(stderr, "Usage: %s [--check] [--config NAME] [file.wav f0.csv ...]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    bool ok = true;
+    printf("%-10s %-16s %7s %9s %9s %9s\n", "config", "corpus", "frames", "GPE%", "voicing%", "rtf");
+    for (int k = 0; k < N_CONFIGS; k++) {
+        const BenchConfig *bc = &configs[k];
+        if (only && strcmp(only, bc->name)) continue;
+        double total_secs = 0.0, total_audio = 0.0;
+        for (int i = 0; i < n_corpora; i++) {
+            const Corpus *c = &corpora[i];
+            Score sc;
+            if (!run(bc, c, &sc)) {
+                printf("%-10s %-16s  setup failed\n", bc->name, c->name);
+                ok = false;
+                continue;
+            }
+            const double audio = c->n_samples / c->sr;
+            const double gpe = gpe_percent(&sc), voicing = voicing_percent(&sc);
+            bool pass = !(check && k == 0 &&
+                          ((c->max_gpe >= 0.0 && gpe > c->max_gpe) ||
+                           (c->max_voicing >= 0.0 && voicing > c->max_voicing)));
+            printf("%-10s %-16s %7d %9.1f %9.1f %9.4f%s\n", bc->name, c->name, sc.scored,
+                   gpe, voicing, sc.seconds / audio, pass ? "" : "  FAIL");
+            ok &= pass;
+            total_secs  += sc.seconds;
+            total_audio += audio;
+        }
+        printf("%-10s %-16s %7s %9s %9s %9.4f\n\n", bc->name, "(all)", "", "", "",
+               total_audio > 0.0 ? total_secs / total_audio : 0.0);
+    }
+
+    for (int i = 0; i < n_corpora; i++)
+        corpus_free(&corpora[i]);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+/*
+ * pyin_diff_test.c – direct vs FFT difference function
+ *
+ * Runs the synthetic speech signal from pyin_signals.h through two pYIN
+ * contexts that differ only in cfg.diff_method and checks, frame by frame,
+ * that both produce the same CMNDF (within tolerance) and the same decoded
+ * pitch track.
+ *
+ * Exits with status 0 on success, 1 on failure.
+ *
+ * Compile:
+ *   gcc -O2 -Wall -Wextra -I../src -o pyin_diff_test pyin_diff_test.c ../src/pyinlib.c -lm
+ */
+
+#include "pyinlib.h"
+#include "pyin_signals.h"
+
+/* Max. absolute CMNDF deviation tolerated between the two paths */
+#define CMNDF_TOLERANCE   1e-3f
+
+/* Max. pitch deviation between the two paths, in cents */
+#define PITCH_TOLERANCE   1.0
+
+static bool compare_paths(const float *samples, int n_samples, float sr,
+                          int frame_size, float f0_min)
+{
+    PYINConfig cfg = pyin_config_default();
+    cfg.sample_rate = sr;
+    cfg.frame_size  = frame_size;
+    cfg.hop_size    = frame_size / 8;
+    cfg.f0_min      = f0_min;
+    cfg.energy_gate_rms = 1e-8f;
+
+    PYINConfig cfg_direct = cfg, cfg_fft = cfg;
+    cfg_direct.diff_method = PYIN_DIFF_DIRECT;
+    cfg_fft.diff_method    = PYIN_DIFF_FFT;
+
+    PYINContext *direct = pyin_create(cfg_direct, NULL, NULL, NULL);
+    PYINContext *fft    = pyin_create(cfg_fft,    NULL, NULL, NULL);
+    if (!direct || !fft) {
+        fprintf(stderr, "pyin_create failed (frame=%d, fmin=%.1f)\n",
+                frame_size, (double)f0_min);
+        pyin_destroy(direct);
+        pyin_destroy(fft);
+        return false;
+    }
+
+    const int bsz = cfg.block_size;
+    int   frames = 0, pitch_mismatches = 0, voicing_mismatches = 0;
+    float max_err = 0.0f;
+    float *block = (float *)calloc((size_t)bsz, sizeof(float));
+
+    for (int pos = 0; pos < n_samples; pos += bsz) {
+        int copy = n_samples - pos;
+        if (copy > bsz) copy = bsz;
+        memset(block, 0, (size_t)bsz * sizeof(float));
+        memcpy(block, samples + pos, (size_t)copy * sizeof(float));
+
+        PYINResult rd, rf;
+        bool hd = pyin_process_block(direct, block, &rd);
+        bool hf = pyin_process_block(fft,    block, &rf);
+        if (hd != hf) {
+            fprintf(stderr, "result availability differs at sample %d\n", pos);
+            max_err = INFINITY;
+            break;
+        }
+        if (!hd)
+            continue;
+
+        int len_d, len_f;
+        const float *cd = pyin_get_cmndf(direct, &len_d);
+        const float *cf = pyin_get_cmndf(fft,    &len_f);
+        for (int tau = 1; tau < len_d && tau < len_f; tau++) {
+            float err = fabsf(cd[tau] - cf[tau]);
+            if (err > max_err) max_err = err;
+        }
+
+        if (rd.voiced != rf.voiced) {
+            voicing_mismatches++;
+        } else if (rd.voiced) {
+            double cents = 1200.0 * fabs(log2((double)rd.pitch_hz / (double)rf.pitch_hz));
+            if (cents > PITCH_TOLERANCE)
+                pitch_mismatches++;
+        }
+        frames++;
+    }
+
+    bool ok = max_err <= CMNDF_TOLERANCE && pitch_mismatches == 0 && voicing_mismatches == 0;
+    printf("%s  frame=%-5d fmin=%-5.1f  frames=%-4d  max|Δcmndf|=%.2e  "
+           "pitch mismatches=%d  voicing mismatches=%d\n",
+           ok ? "PASS" : "FAIL", frame_size, (double)f0_min, frames,
+           (double)max_err, pitch_mismatches, voicing_mismatches);
+
+    free(block);
+    pyin_destroy(direct);
+    pyin_destroy(fft);
+    return ok;
+}
+
+int main(void)
+{
+    const float sr = 44100.0f;
+    const int   n  = (int)(2.0f * sr);
+    float *buf = (float *)malloc((size_t)n * sizeof(float));
+    if (!buf) { fprintf(stderr, "Out of memory\n"); return 1; }
+    synth_speech(buf, n, sr);
+
+    struct { int frame_size; float f0_min; } cases[] = {
+        { 2048, 60.0f },
+        { 3072, 60.0f },   /* non power of two frame */
+        { 4096, 40.0f },
+        { 8192, 20.0f },
+    };
+
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+        ok &= compare_paths(buf, n, sr, cases[i].frame_size, cases[i].f0_min);
+
+    free(buf);
+    return ok ? 0 : 1;
+}
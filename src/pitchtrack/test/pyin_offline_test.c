@@ -0,0 +1,188 @@
+/*
+ * pyin_offline_test.c – offline (full Viterbi) analysis
+ *
+ * Analyses the synthetic speech signal from pyin_signals.h
+ *
+ *   - with pyin_analyse_signal() on the calling thread and with the phased
+ *     API on N_WORKERS threads: both must give identical results
+ *   - with the realtime tracker, for reference
+ *
+ * and reports, for the offline and realtime tracks of the clean and of a
+ * noisy version of the signal, the gross pitch error (voiced frames off by
+ * more than 50 cents) and the voicing decision error against the known F0.
+ * Frames within 30 ms of a segment boundary are not scored.  The offline
+ * track must not be less accurate than the realtime one.
+ *
+ * Exits with status 0 on success, 1 on failure.
+ *
+ * Compile:
+ *   gcc -O2 -Wall -Wextra -I../src -o pyin_offline_test pyin_offline_test.c ../src/pyinlib.c -lm -lpthread
+ */
+
+#include "pyinlib.h"
+#include "pyin_signals.h"
+
+#include <pthread.h>
+
+#define N_WORKERS     4
+#define GPE_CENTS     50.0
+#define BOUNDARY_SECS 0.03f
+
+typedef struct {
+    int scored, voicing_errors, voiced_both, gross_errors;
+} Score;
+
+typedef struct {
+    PYINOffline *off;
+    int          worker;
+    int          phase;
+} WorkerArgs;
+
+static void *worker_main(void *arg)
+{
+    WorkerArgs *a = (WorkerArgs *)arg;
+    if (a->phase == 1) pyin_offline_observe(a->off, a->worker);
+    else               pyin_offline_refine(a->off, a->worker);
+    return NULL;
+}
+
+static void run_phase(PYINOffline *off, int phase)
+{
+    pthread_t  threads[N_WORKERS];
+    WorkerArgs args[N_WORKERS];
+    for (int w = 0; w < N_WORKERS; w++) {
+        args[w] = (WorkerArgs){ off, w, phase };
+        pthread_create(&threads[w], NULL, worker_main, &args[w]);
+    }
+    for (int w = 0; w < N_WORKERS; w++)
+        pthread_join(threads[w], NULL);
+}
+
+static bool near_boundary(float t)
+{
+    return seg_at(t - BOUNDARY_SECS) != seg_at(t + BOUNDARY_SECS);
+}
+
+static void score_result(Score *sc, const PYINResult *r, float t)
+{
+    if (t < 0.0f || near_boundary(t))
+        return;
+    float f0 = speech_f0_at(t);
+    sc->scored++;
+    if ((f0 > 0.0f) != r->voiced) {
+        sc->voicing_errors++;
+    } else if (r->voiced) {
+        sc->voiced_both++;
+        if (1200.0 * fabs(log2((double)r->pitch_hz / f0)) > GPE_CENTS)
+            sc->gross_errors++;
+    }
+}
+
+static void print_score(const char *name, const Score *sc)
+{
+    printf("  %-8s frames=%-4d  voicing error=%5.1f%%  GPE=%5.1f%%\n", name, sc->scored,
+           100.0 * sc->voicing_errors / sc->scored,
+           sc->voiced_both ? 100.0 * sc->gross_errors / sc->voiced_both : 0.0);
+}
+
+/* snr_db: white noise level relative to the RMS of the voiced segments
+ * (< 0: no noise) */
+static bool compare_accuracy(PYINConfig cfg, const float *clean, int n, float snr_db)
+{
+    const float sr = cfg.sample_rate;
+    float *buf = (float *)malloc((size_t)n * sizeof(float));
+    PYINResult *res = (PYINResult *)calloc((size_t)(n / cfg.hop_size + 1), sizeof(PYINResult));
+    double sum_sq = 0.0;
+    int    n_voiced = 0;
+    for (int i = 0; i < n; i++) {
+        if (speech_f0_at((float)i / sr) > 0.0f) {
+            sum_sq += (double)clean[i] * clean[i];
+            n_voiced++;
+        }
+    }
+    /* randf() is uniform in [-1, 1): rms = 1/sqrt(3) */
+    float noise = snr_db < 0.0f ? 0.0f
+                : (float)(sqrt(3.0 * sum_sq / n_voiced) * pow(10.0, -snr_db / 20.0));
+    for (int i = 0; i < n; i++)
+        buf[i] = clean[i] + noise * randf();
+
+    Score so = { 0 }, sr_ = { 0 };
+    pyin_analyse_signal(cfg, buf, n, res);
+    for (int i = 0; i <= n / cfg.hop_size; i++)
+        score_result(&so, &res[i], (float)i * cfg.hop_size / sr);
+
+    PYINContext *rt = pyin_create(cfg, NULL, NULL, NULL);
+    for (int pos = 0; pos + cfg.block_size <= n; pos += cfg.block_size) {
+        PYINResult r;
+        if (pyin_process_block(rt, buf + pos, &r)) {
+            /* centre of the frame ending at the end of this block */
+            float t = (float)(pos + cfg.block_size - cfg.frame_size / 2) / sr;
+            score_result(&sr_, &r, t);
+        }
+    }
+    pyin_destroy(rt);
+
+    /* Compare error rates, the two tracks score slightly different frames */
+    double err_offline  = (double)(so.voicing_errors + so.gross_errors) / so.scored;
+    double err_realtime = (double)(sr_.voicing_errors + sr_.gross_errors) / sr_.scored;
+    bool ok = err_offline <= err_realtime;
+    if (snr_db < 0.0f)
+        printf("%s  clean       offline error <= realtime error\n", ok ? "PASS" : "FAIL");
+    else
+        printf("%s  snr=%4.1f dB  offline error <= realtime error\n", ok ? "PASS" : "FAIL",
+               (double)snr_db);
+    print_score("offline", &so);
+    print_score("realtime", &sr_);
+    free(res);
+    free(buf);
+    return ok;
+}
+
+int main(void)
+{
+    const float sr = 44100.0f;
+    const int   n  = (int)(2.0f * sr);
+    float *buf = (float *)malloc((size_t)n * sizeof(float));
+    if (!buf) { fprintf(stderr, "Out of memory\n"); return 1; }
+    synth_speech(buf, n, sr);
+
+    PYINConfig cfg = pyin_config_default();
+    cfg.sample_rate = sr;
+    cfg.energy_gate_rms = 1e-8f;
+    bool ok = true;
+
+    /* ── Single thread vs. threaded ───────────────────────────────────── */
+    PYINOffline *off = pyin_offline_create(cfg, buf, n, N_WORKERS);
+    if (!off) { fprintf(stderr, "pyin_offline_create failed\n"); return 1; }
+    const int n_frames = pyin_offline_num_frames(off);
+    PYINResult *single = (PYINResult *)calloc((size_t)n_frames, sizeof(PYINResult));
+    if (!pyin_analyse_signal(cfg, buf, n, single)) {
+        fprintf(stderr, "pyin_analyse_signal failed\n");
+        return 1;
+    }
+    run_phase(off, 1);
+    pyin_offline_decode(off);
+    run_phase(off, 3);
+    const PYINResult *threaded = pyin_offline_results(off);
+
+    int mismatches = 0;
+    for (int i = 0; i < n_frames; i++) {
+        if (threaded[i].voiced     != single[i].voiced ||
+            threaded[i].pitch_hz   != single[i].pitch_hz ||
+            threaded[i].confidence != single[i].confidence)
+            mismatches++;
+    }
+    printf("%s  threaded (%d workers) vs single thread: frames=%d  mismatches=%d\n",
+           mismatches == 0 ? "PASS" : "FAIL", N_WORKERS, n_frames, mismatches);
+    ok &= mismatches == 0;
+
+    /* ── Accuracy: offline vs. realtime, clean and with added noise ───── */
+    ok &= compare_accuracy(cfg, buf, n, -1.0f);
+    ok &= compare_accuracy(cfg, buf, n, 20.0f);
+    ok &= compare_accuracy(cfg, buf, n, 10.0f);
+
+    pyin_offline_destroy(off);
+    free(single);
+    free(buf);
+    return ok ? 0 : 1;
+}
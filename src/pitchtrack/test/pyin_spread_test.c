@@ -0,0 +1,145 @@
+/*
+ * pyin_spread_test.c – spread (amortised) analysis vs. single-call analysis
+ *
+ * Runs the synthetic speech signal from pyin_signals.h through two pYIN
+ * contexts that differ only in cfg.spread_analysis and checks that the
+ * spread context produces exactly the same sequence of results, each one
+ * delivered pyin_get_latency() samples later.  Also reports, for both modes,
+ * the most expensive pyin_process_block() call per hop, averaged over all
+ * hops (the single-call mode concentrates all work on one call per hop).
+ *
+ * Exits with status 0 on success, 1 on failure.
+ *
+ * Compile:
+ *   gcc -O2 -Wall -Wextra -I../src -o pyin_spread_test pyin_spread_test.c ../src/pyinlib.c -lm
+ */
+
+#include "pyinlib.h"
+#include "pyin_signals.h"
+
+#include <time.h>
+
+#define MAX_RESULTS 4096
+
+typedef struct {
+    PYINResult res[MAX_RESULTS];
+    int        pos[MAX_RESULTS];   /* sample position at which it was delivered */
+    int        count;
+    double     peak_call_us;   /* mean over hops of the slowest call in the hop */
+} Track;
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec * 1e-3;
+}
+
+static bool run_track(PYINContext *ctx, const float *samples, int n_samples, Track *t)
+{
+    const int bsz = pyin_get_config(ctx)->block_size;
+    const int hop = pyin_get_config(ctx)->hop_size;
+    float *block = (float *)calloc((size_t)bsz, sizeof(float));
+    if (!block) return false;
+    t->count = 0;
+    t->peak_call_us = 0.0;
+    double hop_peak = 0.0;
+    int    n_hops = 0;
+
+    for (int pos = 0; pos < n_samples; pos += bsz) {
+        int copy = n_samples - pos;
+        if (copy > bsz) copy = bsz;
+        memset(block, 0, (size_t)bsz * sizeof(float));
+        memcpy(block, samples + pos, (size_t)copy * sizeof(float));
+
+        PYINResult res;
+        double t0 = now_us();
+        bool has = pyin_process_block(ctx, block, &res);
+        double dt = now_us() - t0;
+        if (dt > hop_peak) hop_peak = dt;
+        if ((pos + bsz) % hop == 0) {
+            t->peak_call_us += hop_peak;
+            hop_peak = 0.0;
+            n_hops++;
+        }
+
+        if (has && t->count < MAX_RESULTS) {
+            t->res[t->count] = res;
+            t->pos[t->count] = pos;
+            t->count++;
+        }
+    }
+    if (n_hops > 0)
+        t->peak_call_us /= n_hops;
+    free(block);
+    return true;
+}
+
+static bool compare_modes(const float *samples, int n_samples, float sr,
+                          int frame_size, int hop_size, int block_size)
+{
+    PYINConfig cfg = pyin_config_default();
+    cfg.sample_rate = sr;
+    cfg.frame_size  = frame_size;
+    cfg.hop_size    = hop_size;
+    cfg.block_size  = block_size;
+    cfg.energy_gate_rms = 1e-8f;
+
+    PYINConfig cfg_spread = cfg;
+    cfg_spread.spread_analysis = true;
+
+    PYINContext *single = pyin_create(cfg,        NULL, NULL, NULL);
+    PYINContext *spread = pyin_create(cfg_spread, NULL, NULL, NULL);
+    static Track ts, tp;
+    bool ok = single && spread
+           && run_track(single, samples, n_samples, &ts)
+           && run_track(spread, samples, n_samples, &tp);
+    if (!ok) {
+        fprintf(stderr, "setup failed (frame=%d, hop=%d, block=%d)\n",
+                frame_size, hop_size, block_size);
+        pyin_destroy(single);
+        pyin_destroy(spread);
+        return false;
+    }
+
+    const int latency = pyin_get_latency(spread);
+    int mismatches = 0;
+    /* The spread track may lose its last result(s) to the end of the signal */
+    if (tp.count > ts.count || tp.count < ts.count - 1)
+        mismatches++;
+    for (int i = 0; i < tp.count && i < ts.count; i++) {
+        if (tp.pos[i] != ts.pos[i] + latency ||
+            tp.res[i].voiced     != ts.res[i].voiced ||
+            tp.res[i].pitch_hz   != ts.res[i].pitch_hz ||
+            tp.res[i].confidence != ts.res[i].confidence)
+            mismatches++;
+    }
+
+    ok = mismatches == 0 && latency == hop_size - block_size;
+    printf("%s  frame=%-5d hop=%-4d block=%-3d  results=%d/%d  latency=%d  "
+           "peak call: single %.1f us, spread %.1f us\n",
+           ok ? "PASS" : "FAIL", frame_size, hop_size, block_size,
+           tp.count, ts.count, latency, ts.peak_call_us, tp.peak_call_us);
+
+    pyin_destroy(single);
+    pyin_destroy(spread);
+    return ok;
+}
+
+int main(void)
+{
+    const float sr = 44100.0f;
+    const int   n  = (int)(2.0f * sr);
+    float *buf = (float *)malloc((size_t)n * sizeof(float));
+    if (!buf) { fprintf(stderr, "Out of memory\n"); return 1; }
+    synth_speech(buf, n, sr);
+
+    bool ok = true;
+    ok &= compare_modes(buf, n, sr, 2048, 512,  32);
+    ok &= compare_modes(buf, n, sr, 2048, 256,  64);
+    ok &= compare_modes(buf, n, sr, 4096, 1024, 64);   /* FFT path */
+    ok &= compare_modes(buf, n, sr, 2048, 64,   64);   /* one slice: no latency */
+
+    free(buf);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+/*
+ * pyin_tables_test.c – multichannel tracking with shared tables
+ *
+ * Tracks N_CHANNELS shifted / scaled copies of the synthetic speech signal
+ * from pyin_signals.h, block by block and channel by channel as the
+ * multichannel pyin opcode does, once with one private context per channel
+ * (pyin_create) and once with contexts sharing one set of tables
+ * (pyin_tables_create + pyin_create_shared).  Both must give exactly the
+ * same results.  Also checks that pyin_create_shared rejects a config the
+ * tables were not built for, and reports the time per block for both.
+ *
+ * Exits with status 0 on success, 1 on failure.
+ *
+ * Compile:
+ *   gcc -O2 -Wall -Wextra -I../src -o pyin_tables_test pyin_tables_test.c ../src/pyinlib.c -lm
+ */
+
+#include "pyinlib.h"
+#include "pyin_signals.h"
+
+#include <time.h>
+
+#define N_CHANNELS  8
+#define BLOCK       64
+#define MAX_RESULTS 4096
+
+typedef struct {
+    PYINResult res[MAX_RESULTS];
+    int        count;
+} Track;
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec * 1e-3;
+}
+
+static PYINConfig test_config(float sr)
+{
+    PYINConfig cfg = pyin_config_default();
+    cfg.sample_rate = sr;
+    cfg.frame_size  = 2048;
+    cfg.hop_size    = 256;
+    cfg.block_size  = BLOCK;
+    cfg.energy_gate_rms = 1e-8f;
+    return cfg;
+}
+
+/* Returns the mean time per block (all channels) in us */
+static double run_channels(PYINContext **ctx, float **chans, int n_samples, Track *t)
+{
+    for (int c = 0; c < N_CHANNELS; c++)
+        t[c].count = 0;
+    double elapsed = 0.0;
+    int n_blocks = 0;
+    for (int pos = 0; pos + BLOCK <= n_samples; pos += BLOCK) {
+        double t0 = now_us();
+        for (int c = 0; c < N_CHANNELS; c++) {
+            PYINResult res;
+            if (pyin_process_block(ctx[c], chans[c] + pos, &res) && t[c].count < MAX_RESULTS)
+                t[c].res[t[c].count++] = res;
+        }
+        elapsed += now_us() - t0;
+        n_blocks++;
+    }
+    return n_blocks > 0 ? elapsed / n_blocks : 0.0;
+}
+
+int main(void)
+{
+    const float sr = 44100.0f;
+    const int   n  = (int)(2.0f * sr);
+    float *speech = (float *)malloc((size_t)n * sizeof(float));
+    float *chans[N_CHANNELS];
+    if (!speech) { fprintf(stderr, "Out of memory\n"); return 1; }
+    synth_speech(speech, n, sr);
+    for (int c = 0; c < N_CHANNELS; c++) {
+        chans[c] = (float *)calloc((size_t)n, sizeof(float));
+        if (!chans[c]) { fprintf(stderr, "Out of memory\n"); return 1; }
+        const int   shift = c * 1500;
+        const float gain  = 1.0f - 0.1f * (float)c;
+        for (int i = shift; i < n; i++)
+            chans[c][i] = gain * speech[i - shift];
+    }
+
+    const PYINConfig cfg = test_config(sr);
+    PYINContext *priv[N_CHANNELS], *shared[N_CHANNELS];
+    PYINTables *tables = pyin_tables_create(cfg, NULL, NULL, NULL);
+    bool ok = tables != NULL;
+    for (int c = 0; c < N_CHANNELS; c++) {
+        priv[c]   = pyin_create(cfg, NULL, NULL, NULL);
+        shared[c] = tables ? pyin_create_shared(cfg, tables, NULL, NULL, NULL) : NULL;
+        ok &= priv[c] != NULL && shared[c] != NULL;
+    }
+
+    /* Fields which shape the tables must match */
+    PYINConfig other = cfg;
+    other.f0_max = 800.0f;
+    PYINContext *bad = tables ? pyin_create_shared(other, tables, NULL, NULL, NULL) : NULL;
+    bool rejected = bad == NULL;
+    pyin_destroy(bad);
+    printf("%s  incompatible config rejected\n", rejected ? "PASS" : "FAIL");
+    ok &= rejected;
+
+    /* The contexts hold their own references */
+    pyin_tables_release(tables);
+    if (!ok) {
+        fprintf(stderr, "setup failed\n");
+        return 1;
+    }
+
+    static Track tp[N_CHANNELS], ts[N_CHANNELS];
+    const double us_priv   = run_channels(priv,   chans, n, tp);
+    const double us_shared = run_channels(shared, chans, n, ts);
+
+    int mismatches = 0, results = 0;
+    for (int c = 0; c < N_CHANNELS; c++) {
+        if (tp[c].count != ts[c].count)
+            mismatches++;
+        for (int i = 0; i < tp[c].count && i < ts[c].count; i++) {
+            if (tp[c].res[i].voiced     != ts[c].res[i].voiced ||
+                tp[c].res[i].pitch_hz   != ts[c].res[i].pitch_hz ||
+                tp[c].res[i].confidence != ts[c].res[i].confidence)
+                mismatches++;
+        }
+        results += ts[c].count;
+        pyin_destroy(priv[c]);
+        pyin_destroy(shared[c]);
+    }
+    bool same = mismatches == 0 && results > 0;
+    printf("%s  channels=%d  results=%d  mismatches=%d  "
+           "per block: private %.1f us, shared %.1f us\n",
+           same ? "PASS" : "FAIL", N_CHANNELS, results, mismatches, us_priv, us_shared);
+    ok &= same;
+
+    for (int c = 0; c < N_CHANNELS; c++)
+        free(chans[c]);
+    free(speech);
+    return ok ? 0 : 1;
+}
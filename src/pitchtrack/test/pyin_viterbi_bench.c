@@ -0,0 +1,164 @@
+/*
+ * pyin_viterbi_bench.c – micro-benchmark of the banded Viterbi step
+ *
+ * Times one trellis column (all voiced destinations + the unvoiced one)
+ * computed by the tiled kernels in pyinlib.c against the plain
+ * scalar loops they replace, for several state resolutions (bins) and
+ * transition widths (drift).  The columns are fed random scores, and the
+ * kernels must reproduce the scalar scores and voiced predecessors exactly
+ * (the unvoiced predecessor may only differ between equal scores).
+ *
+ * pyinlib.c is included directly since the kernels are internal.
+ *
+ * Exits with status 0 on success, 1 on failure.
+ *
+ * Compile:
+ *   gcc -O3 -mavx2 -ffast-math -Wall -I../src -o pyin_viterbi_bench pyin_viterbi_bench.c -lm
+ */
+
+#include "pyinlib.c"
+
+#include <stdio.h>
+#include <time.h>
+
+#define N_COLUMNS 64
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec * 1e-3;
+}
+
+static uint32_t rng = 0x12345678U;
+static float rand_score(void)
+{
+    rng = rng * 1664525U + 1013904223U;
+    return -50.0f * (float)(rng >> 8) / (float)(1U << 24);
+}
+
+/* The scalar column step, with absolute int16 predecessors */
+static void reference_column(const HMM *h, const float *prev, float *cur,
+                             int16_t *back, const float *log_obs)
+{
+    const int np = h->n_pitched, uv = np, bh = h->band_half;
+    for (int s = 0; s < np; s++) {
+        float best = -1e30f;
+        int   best_from = 0;
+        int f_lo = s - bh; if (f_lo < 0)   f_lo = 0;
+        int f_hi = s + bh; if (f_hi >= np) f_hi = np - 1;
+        for (int f = f_lo; f <= f_hi; f++) {
+            float v = prev[f] + h->log_trans_band[(f - s) + bh];
+            if (v > best) { best = v; best_from = f; }
+        }
+        float v = prev[uv] + h->log_p_uv;
+        if (v > best) { best = v; best_from = uv; }
+        cur[s]  = best + log_obs[s];
+        back[s] = (int16_t)best_from;
+    }
+    float best = -1e30f;
+    int   best_from = 0;
+    for (int f = 0; f < np; f++) {
+        float v = prev[f] + h->log_p_vu;
+        if (v > best) { best = v; best_from = f; }
+    }
+    float v = prev[uv] + h->log_p_uu;
+    if (v > best) { best = v; best_from = uv; }
+    cur[uv]  = best + log_obs[uv];
+    back[uv] = (int16_t)best_from;
+}
+
+static bool bench(int bins, float drift)
+{
+    PYINConfig cfg = pyin_config_default();
+    cfg.cents_per_semitone = bins;
+    cfg.pitch_sigma_cents  = drift;
+    PYINTables *t = pyin_tables_create(cfg, NULL, NULL, NULL);
+    HMM h;
+    if (!t || !hmm_alloc_trellis(&h, &t->trans, NULL, NULL)) {
+        fprintf(stderr, "setup failed (bins=%d, drift=%g)\n", bins, (double)drift);
+        return false;
+    }
+    const int np = h.n_pitched, n_total = h.n_total;
+
+    float   *prev    = (float *)malloc(sizeof(float) * (size_t)n_total * N_COLUMNS);
+    float   *log_obs = (float *)malloc(sizeof(float) * (size_t)n_total);
+    float   *cur_ref = (float *)malloc(sizeof(float) * (size_t)n_total);
+    float   *cur     = (float *)malloc(sizeof(float) * (size_t)n_total);
+    int16_t *back_ref = (int16_t *)malloc(sizeof(int16_t) * (size_t)n_total);
+    for (size_t i = 0; i < (size_t)n_total * N_COLUMNS; i++)
+        prev[i] = rand_score();
+    for (int s = 0; s < n_total; s++)
+        log_obs[s] = rand_score();
+    /* Plateaus exercise the tie-breaking */
+    for (int s = np / 3; s < np / 3 + 40 && s < np; s++)
+        prev[s] = -1.0f;
+
+    int mismatches = 0;
+    for (int c = 0; c < N_COLUMNS; c++) {
+        const float *p = prev + (size_t)c * n_total;
+        int16_t back_uv;
+        reference_column(&h, p, cur_ref, back_ref, log_obs);
+        viterbi_voiced(&h, p, cur, h.back, log_obs, 0, np);
+        viterbi_unvoiced(&h, p, cur, &back_uv, log_obs);
+        for (int s = 0; s < np; s++) {
+            if (cur[s] != cur_ref[s] ||
+                back_state(&h, s, back_load(&h, h.back, s)) != back_ref[s])
+                mismatches++;
+        }
+        /* The unvoiced predecessor may differ from the scalar one only
+         * between sources whose scores round to the same sum */
+        if (cur[np] != cur_ref[np] ||
+            (back_uv != back_ref[np] &&
+             (back_uv == np || back_ref[np] == np ||
+              p[back_uv] + h.log_p_vu != p[back_ref[np]] + h.log_p_vu)))
+            mismatches++;
+    }
+
+    /* Spread mode computes the voiced destinations in arbitrary slices */
+    for (int s0 = 0; s0 < np; s0 += 37) {
+        int s1 = s0 + 37 < np ? s0 + 37 : np;
+        viterbi_voiced(&h, prev, cur, h.back, log_obs, s0, s1);
+    }
+    reference_column(&h, prev, cur_ref, back_ref, log_obs);
+    for (int s = 0; s < np; s++)
+        if (cur[s] != cur_ref[s]) mismatches++;
+
+    const int reps = 4;
+    double t0 = now_us();
+    for (int r = 0; r < reps; r++)
+        for (int c = 0; c < N_COLUMNS; c++)
+            reference_column(&h, prev + (size_t)c * n_total, cur_ref, back_ref, log_obs);
+    double us_ref = (now_us() - t0) / (reps * N_COLUMNS);
+
+    t0 = now_us();
+    for (int r = 0; r < reps; r++) {
+        for (int c = 0; c < N_COLUMNS; c++) {
+            int16_t back_uv;
+            viterbi_voiced(&h, prev + (size_t)c * n_total, cur, h.back, log_obs, 0, np);
+            viterbi_unvoiced(&h, prev + (size_t)c * n_total, cur, &back_uv, log_obs);
+        }
+    }
+    double us_vec = (now_us() - t0) / (reps * N_COLUMNS);
+
+    bool ok = mismatches == 0;
+    printf("%s  bins=%-3d drift=%-4g states=%-5d band=±%-3d back=%d byte(s)  "
+           "per column: scalar %7.1f us, tiled %6.1f us  (x%.1f)\n",
+           ok ? "PASS" : "FAIL", bins, (double)drift, n_total, h.band_half, h.back_size,
+           us_ref, us_vec, us_ref / us_vec);
+
+    free(prev); free(log_obs); free(cur_ref); free(cur); free(back_ref);
+    free(h.score); free(h.back); free(h.back_uv);
+    pyin_tables_release(t);
+    return ok;
+}
+
+int main(void)
+{
+    bool ok = true;
+    ok &= bench(10, 100.0f);    /* defaults */
+    ok &= bench(20, 100.0f);
+    ok &= bench(20, 200.0f);
+    ok &= bench(50, 100.0f);    /* band wider than 254 states: 2-byte codes */
+    return ok ? 0 : 1;
+}
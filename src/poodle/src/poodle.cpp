@@ -553,6 +553,7 @@ struct FAUST_API UI : public UIReal<FAUSTFLOAT> {
 #include <cmath>
 #include <cstdint>
 #include <math.h>
+#include <mutex>
 
 #ifndef FAUSTCLASS
 #define FAUSTCLASS mydsp
@@ -569,10 +570,56 @@ struct FAUST_API UI : public UIReal<FAUSTFLOAT> {
 #define RESTRICT __restrict__
 #endif
 
+// The iterations of the loop that follows do not depend on each other
+#if defined(_MSC_VER)
+#define IVDEP __pragma(loop(ivdep))
+#elif defined(__clang__)
+#define IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define IVDEP _Pragma("GCC ivdep")
+#else
+#define IVDEP
+#endif
+
+// The function that follows is built twice, for AVX2 and for the baseline
+// instruction set. The dynamic linker picks one by cpu when the plugin is
+// loaded. POODLE_DISPATCH is set by CMakeLists.txt where this is supported
+// (gcc/clang on x86 linux). Virtual functions can not be dispatched this way,
+// so compute forwards to a computeBlock
+#if defined(POODLE_DISPATCH)
+#define POODLE_MULTIVERSION __attribute__((target_clones("avx2", "default")))
+#else
+#define POODLE_MULTIVERSION
+#endif
+
 static inline double pow2f(double value) {
 	return value * value;
 }
 
+// The last values seen of N controls of a dsp. What compute derives from them
+// (the coefficients of its "slow" section) needs updating only if changed
+template <int N>
+struct faust_controls {
+	FAUSTFLOAT last[N];
+	bool valid;
+
+	faust_controls() : valid(false) {}
+
+	// The next call to changed returns true
+	void invalidate() { valid = false; }
+
+	// True if values differ from the last values seen, which are updated
+	bool changed(const FAUSTFLOAT *values) {
+		bool diff = !valid;
+		for (int i = 0; i < N; i++) {
+			diff |= values[i] != last[i];
+			last[i] = values[i];
+		}
+		valid = true;
+		return diff;
+	}
+};
+
 #if USE_FMATH
   #include "../../common/fmath.hpp"
   #define expf fmath::exp
@@ -593,6 +640,99 @@ static inline double pow2f(double value) {
 #define ZR_DRYWET    9
 #define ZR_LEVEL     10
 
+#define ZITAREV_LINES 18
+#define ZITAREV_CHUNK 32
+// Space left after each delay line, in samples. The lines are powers of two
+// long and without it their write positions would fall in the same cache sets
+#define ZITAREV_LINE_PAD 8
+
+// Per block coefficients of zitarev_dsp::compute
+struct zitarev_slow {
+	double fSlow0, fSlow3, fSlow4, fSlow5, fSlow8, fSlow9, fSlow18, fSlow20;
+	double fSlow21, fSlow23, fSlow24, fSlow32, fSlow33, fSlow34, fSlow41, fSlow42;
+	double fSlow43, fSlow50, fSlow51, fSlow52, fSlow59, fSlow60, fSlow61, fSlow68;
+	double fSlow69, fSlow70, fSlow77, fSlow78, fSlow79, fSlow86, fSlow87, fSlow88;
+	double fSlow89, fSlow90;
+	int iSlow25;
+
+	// d: the increment per sample that takes these coefficients to those of to
+	// in n samples. The delay, an integer, is not ramped
+	void delta(const zitarev_slow &to, int n, zitarev_slow &d) const {
+		const double scale = 1.0 / n;
+		d.fSlow0 = (to.fSlow0 - fSlow0) * scale;
+		d.fSlow3 = (to.fSlow3 - fSlow3) * scale;
+		d.fSlow4 = (to.fSlow4 - fSlow4) * scale;
+		d.fSlow5 = (to.fSlow5 - fSlow5) * scale;
+		d.fSlow8 = (to.fSlow8 - fSlow8) * scale;
+		d.fSlow9 = (to.fSlow9 - fSlow9) * scale;
+		d.fSlow18 = (to.fSlow18 - fSlow18) * scale;
+		d.fSlow20 = (to.fSlow20 - fSlow20) * scale;
+		d.fSlow21 = (to.fSlow21 - fSlow21) * scale;
+		d.fSlow23 = (to.fSlow23 - fSlow23) * scale;
+		d.fSlow24 = (to.fSlow24 - fSlow24) * scale;
+		d.fSlow32 = (to.fSlow32 - fSlow32) * scale;
+		d.fSlow33 = (to.fSlow33 - fSlow33) * scale;
+		d.fSlow34 = (to.fSlow34 - fSlow34) * scale;
+		d.fSlow41 = (to.fSlow41 - fSlow41) * scale;
+		d.fSlow42 = (to.fSlow42 - fSlow42) * scale;
+		d.fSlow43 = (to.fSlow43 - fSlow43) * scale;
+		d.fSlow50 = (to.fSlow50 - fSlow50) * scale;
+		d.fSlow51 = (to.fSlow51 - fSlow51) * scale;
+		d.fSlow52 = (to.fSlow52 - fSlow52) * scale;
+		d.fSlow59 = (to.fSlow59 - fSlow59) * scale;
+		d.fSlow60 = (to.fSlow60 - fSlow60) * scale;
+		d.fSlow61 = (to.fSlow61 - fSlow61) * scale;
+		d.fSlow68 = (to.fSlow68 - fSlow68) * scale;
+		d.fSlow69 = (to.fSlow69 - fSlow69) * scale;
+		d.fSlow70 = (to.fSlow70 - fSlow70) * scale;
+		d.fSlow77 = (to.fSlow77 - fSlow77) * scale;
+		d.fSlow78 = (to.fSlow78 - fSlow78) * scale;
+		d.fSlow79 = (to.fSlow79 - fSlow79) * scale;
+		d.fSlow86 = (to.fSlow86 - fSlow86) * scale;
+		d.fSlow87 = (to.fSlow87 - fSlow87) * scale;
+		d.fSlow88 = (to.fSlow88 - fSlow88) * scale;
+		d.fSlow89 = (to.fSlow89 - fSlow89) * scale;
+		d.fSlow90 = (to.fSlow90 - fSlow90) * scale;
+	}
+
+	void step(const zitarev_slow &d) {
+		fSlow0 += d.fSlow0;
+		fSlow3 += d.fSlow3;
+		fSlow4 += d.fSlow4;
+		fSlow5 += d.fSlow5;
+		fSlow8 += d.fSlow8;
+		fSlow9 += d.fSlow9;
+		fSlow18 += d.fSlow18;
+		fSlow20 += d.fSlow20;
+		fSlow21 += d.fSlow21;
+		fSlow23 += d.fSlow23;
+		fSlow24 += d.fSlow24;
+		fSlow32 += d.fSlow32;
+		fSlow33 += d.fSlow33;
+		fSlow34 += d.fSlow34;
+		fSlow41 += d.fSlow41;
+		fSlow42 += d.fSlow42;
+		fSlow43 += d.fSlow43;
+		fSlow50 += d.fSlow50;
+		fSlow51 += d.fSlow51;
+		fSlow52 += d.fSlow52;
+		fSlow59 += d.fSlow59;
+		fSlow60 += d.fSlow60;
+		fSlow61 += d.fSlow61;
+		fSlow68 += d.fSlow68;
+		fSlow69 += d.fSlow69;
+		fSlow70 += d.fSlow70;
+		fSlow77 += d.fSlow77;
+		fSlow78 += d.fSlow78;
+		fSlow79 += d.fSlow79;
+		fSlow86 += d.fSlow86;
+		fSlow87 += d.fSlow87;
+		fSlow88 += d.fSlow88;
+		fSlow89 += d.fSlow89;
+		fSlow90 += d.fSlow90;
+	}
+};
+
 class zitarev_dsp : public dsp {
 
  public:
@@ -606,59 +746,59 @@ class zitarev_dsp : public dsp {
 	double fRec13[2];
 	double fRec12[2];
 	int IOTA0;
-	double fVec0[16384];
+	double *fVec0;
 	int iConst6;
-	double fVec1[16384];
+	double *fVec1;
 	double fConst7;
-	double fVec2[4096];
+	double *fVec2;
 	int iConst8;
 	double fRec10[2];
 	double fConst10;
 	double fRec17[2];
 	double fRec16[2];
-	double fVec3[16384];
+	double *fVec3;
 	int iConst12;
-	double fVec4[2048];
+	double *fVec4;
 	int iConst13;
 	double fRec14[2];
 	double fConst15;
 	double fRec21[2];
 	double fRec20[2];
-	double fVec5[16384];
+	double *fVec5;
 	int iConst17;
-	double fVec6[4096];
+	double *fVec6;
 	int iConst18;
 	double fRec18[2];
 	double fConst20;
 	double fRec25[2];
 	double fRec24[2];
-	double fVec7[16384];
+	double *fVec7;
 	int iConst22;
-	double fVec8[2048];
+	double *fVec8;
 	int iConst23;
 	double fRec22[2];
 	double fConst25;
 	double fRec29[2];
 	double fRec28[2];
-	double fVec9[32768];
+	double *fVec9;
 	int iConst27;
-	double fVec10[16384];
-	double fVec11[4096];
+	double *fVec10;
+	double *fVec11;
 	int iConst28;
 	double fRec26[2];
 	double fConst30;
 	double fRec33[2];
 	double fRec32[2];
-	double fVec12[16384];
+	double *fVec12;
 	int iConst32;
-	double fVec13[4096];
+	double *fVec13;
 	int iConst33;
 	double fRec30[2];
 	double fConst35;
     double fRec36[2];
 	double fRec37[2];
-	double fVec14[32768];
-    double fVec15[4096];
+	double *fVec14;
+    double *fVec15;
 	int iConst37;
 	int iConst38;
     int iConst42;
@@ -667,8 +807,8 @@ class zitarev_dsp : public dsp {
 	double fConst40;
 	double fRec41[2];
 	double fRec40[2];
-	double fVec16[32768];
-	double fVec17[2048];
+	double *fVec16;
+	double *fVec17;
 	double fRec38[2];
 	double fRec2[3];
 	double fRec3[3];
@@ -687,8 +827,50 @@ class zitarev_dsp : public dsp {
 	double fRec45[3];
 	double fRec44[3];
 
+	// Delay lines. Their storage is not part of the object: it follows the object
+	// in the block given to setDelayMemory (see memorySize) and each line is sized
+	// for the delays it is read at the current sample rate. With iLanes > 1
+	// (zitarev_lanes_dsp) the lines of all lanes are interleaved
+	double *fLines[ZITAREV_LINES];
+	int iLineDelay[ZITAREV_LINES];      // max. read delay of each line, in samples
+	int iLineSize[ZITAREV_LINES];       // power of two > iLineDelay
+	int iLinesLength;                   // total length of all lines, per lane
+	int iLanes;
+	size_t iObjectSize;
+	int iPredelayMax;                   // max. predelay (100 ms, the delayms range)
+	int iMask0, iMask1, iMask2, iMask3, iMask4, iMask5, iMask6, iMask7, iMask8;
+	int iMask9, iMask10, iMask11, iMask12, iMask13, iMask14, iMask15, iMask16, iMask17;
+	double *fMemory;
+	bool bMemoryZeroed;                 // fMemory was just zeroed by its allocator
+	int iClearPos;                      // see clearLines
+	int iClearEnd;
+	faust_controls<ZITAREV_CONTROLS> fControls;
+	zitarev_slow fSlowCur;              // the coefficients reached at the end of the last block
+
  public:
-	zitarev_dsp() {}
+	zitarev_dsp() : iLanes(1), iObjectSize(objectSize()), fMemory(NULL), bMemoryZeroed(false) {}
+
+	// Length of the delay lines of one lane at the given sample rate
+	static int linesLength(int sample_rate) {
+		zitarev_dsp probe;
+		probe.instanceConstants(sample_rate);
+		return probe.iLinesLength;
+	}
+
+	// Size in bytes of the block holding the dsp object and its delay lines
+	static size_t memorySize(int sample_rate) {
+		return objectSize() + linesLength(sample_rate) * sizeof(double);
+	}
+
+	static size_t objectSize() { return (sizeof(zitarev_dsp) + 63) & ~(size_t)63; }
+
+	// mem: a block of memorySize bytes with this object at its start. zeroed:
+	// the block was zeroed by its allocator, the first instanceClear can skip
+	// clearing the lines. Must be called before init
+	void setDelayMemory(void *mem, bool zeroed) {
+		fMemory = (double *)((char *)mem + iObjectSize);
+		bMemoryZeroed = zeroed;
+	}
 
 	virtual int getNumInputs() { return 2; }
 	virtual int getNumOutputs() { return 2; }
@@ -742,6 +924,61 @@ class zitarev_dsp : public dsp {
 		iConst43 = int(std::min<double>(1024.0, std::max<double>(0.0, fConst41 + -1.0)));
 		fConst44 = 44.1 / fConst0;
 		fConst45 = 1.0 - fConst44;
+		iPredelayMax = int(std::min<double>(8192.0, 0.1 * fConst0));
+		const int delays[ZITAREV_LINES] = {
+			iConst6, iPredelayMax, iConst8, iConst12, iConst13, iConst17, iConst18, iConst22, iConst23,
+			iConst27, iPredelayMax, iConst28, iConst32, iConst33, iConst37, iConst38, iConst42, iConst43
+		};
+		iLinesLength = 0;
+		iClearEnd = 0;
+		for (int i = 0; i < ZITAREV_LINES; i++) {
+			int size = 1;
+			while (size <= delays[i])
+				size <<= 1;
+			iLineDelay[i] = delays[i];
+			iLineSize[i] = size;
+			iLinesLength += size + ZITAREV_LINE_PAD;
+			if (!isPredelayLine(i))
+				iClearEnd = std::max(iClearEnd, delays[i]);
+		}
+		if (fMemory != NULL)
+			layoutLines();
+	}
+
+	static bool isPredelayLine(int line) { return line == 1 || line == 10; }
+
+	void layoutLines() {
+		double **vecs[ZITAREV_LINES] = {
+			&fVec0, &fVec1, &fVec2, &fVec3, &fVec4, &fVec5, &fVec6, &fVec7, &fVec8,
+			&fVec9, &fVec10, &fVec11, &fVec12, &fVec13, &fVec14, &fVec15, &fVec16, &fVec17
+		};
+		int *masks[ZITAREV_LINES] = {
+			&iMask0, &iMask1, &iMask2, &iMask3, &iMask4, &iMask5, &iMask6, &iMask7, &iMask8,
+			&iMask9, &iMask10, &iMask11, &iMask12, &iMask13, &iMask14, &iMask15, &iMask16, &iMask17
+		};
+		double *mem = fMemory;
+		for (int i = 0; i < ZITAREV_LINES; i++) {
+			fLines[i] = *vecs[i] = mem;
+			*masks[i] = iLineSize[i] - 1;
+			mem += (iLineSize[i] + ZITAREV_LINE_PAD) * iLanes;
+		}
+	}
+
+	// Until the write position of a line wraps around, only its last iLineDelay
+	// samples can be read before being written, so only those need clearing.
+	// compute clears them as it goes, each block clearing the slots it is about
+	// to read: the samples [iClearPos, iClearPos + count) of each line's tail
+	void clearLines(int count) {
+		const int t0 = iClearPos;
+		const int t1 = iClearPos + count;
+		for (int i = 0; i < ZITAREV_LINES; i++) {
+			const int d = iLineDelay[i];
+			if (isPredelayLine(i) || t0 >= d)
+				continue;
+			double *tail = fLines[i] + (iLineSize[i] - d) * iLanes;
+			memset(tail + t0 * iLanes, 0, (std::min(t1, d) - t0) * iLanes * sizeof(double));
+		}
+		iClearPos = t1;
 	}
 
 	virtual void instanceResetUserInterface() {
@@ -766,15 +1003,6 @@ class zitarev_dsp : public dsp {
 			fRec12[l1] = 0.0;
 		}
 		IOTA0 = 0;
-		for (int l2 = 0; l2 < 16384; l2 = l2 + 1) {
-			fVec0[l2] = 0.0;
-		}
-		for (int l3 = 0; l3 < 16384; l3 = l3 + 1) {
-			fVec1[l3] = 0.0;
-		}
-		for (int l4 = 0; l4 < 4096; l4 = l4 + 1) {
-			fVec2[l4] = 0.0;
-		}
 		for (int l5 = 0; l5 < 2; l5 = l5 + 1) {
 			fRec10[l5] = 0.0;
 		}
@@ -784,12 +1012,6 @@ class zitarev_dsp : public dsp {
 		for (int l7 = 0; l7 < 2; l7 = l7 + 1) {
 			fRec16[l7] = 0.0;
 		}
-		for (int l8 = 0; l8 < 16384; l8 = l8 + 1) {
-			fVec3[l8] = 0.0;
-		}
-		for (int l9 = 0; l9 < 2048; l9 = l9 + 1) {
-			fVec4[l9] = 0.0;
-		}
 		for (int l10 = 0; l10 < 2; l10 = l10 + 1) {
 			fRec14[l10] = 0.0;
 		}
@@ -799,12 +1021,6 @@ class zitarev_dsp : public dsp {
 		for (int l12 = 0; l12 < 2; l12 = l12 + 1) {
 			fRec20[l12] = 0.0;
 		}
-		for (int l13 = 0; l13 < 16384; l13 = l13 + 1) {
-			fVec5[l13] = 0.0;
-		}
-		for (int l14 = 0; l14 < 4096; l14 = l14 + 1) {
-			fVec6[l14] = 0.0;
-		}
 		for (int l15 = 0; l15 < 2; l15 = l15 + 1) {
 			fRec18[l15] = 0.0;
 		}
@@ -814,12 +1030,6 @@ class zitarev_dsp : public dsp {
 		for (int l17 = 0; l17 < 2; l17 = l17 + 1) {
 			fRec24[l17] = 0.0;
 		}
-		for (int l18 = 0; l18 < 16384; l18 = l18 + 1) {
-			fVec7[l18] = 0.0;
-		}
-		for (int l19 = 0; l19 < 2048; l19 = l19 + 1) {
-			fVec8[l19] = 0.0;
-		}
 		for (int l20 = 0; l20 < 2; l20 = l20 + 1) {
 			fRec22[l20] = 0.0;
 		}
@@ -829,15 +1039,6 @@ class zitarev_dsp : public dsp {
 		for (int l22 = 0; l22 < 2; l22 = l22 + 1) {
 			fRec28[l22] = 0.0;
 		}
-		for (int l23 = 0; l23 < 32768; l23 = l23 + 1) {
-			fVec9[l23] = 0.0;
-		}
-		for (int l24 = 0; l24 < 16384; l24 = l24 + 1) {
-			fVec10[l24] = 0.0;
-		}
-		for (int l25 = 0; l25 < 4096; l25 = l25 + 1) {
-			fVec11[l25] = 0.0;
-		}
 		for (int l26 = 0; l26 < 2; l26 = l26 + 1) {
 			fRec26[l26] = 0.0;
 		}
@@ -847,12 +1048,6 @@ class zitarev_dsp : public dsp {
 		for (int l28 = 0; l28 < 2; l28 = l28 + 1) {
 			fRec32[l28] = 0.0;
 		}
-		for (int l29 = 0; l29 < 16384; l29 = l29 + 1) {
-			fVec12[l29] = 0.0;
-		}
-		for (int l30 = 0; l30 < 4096; l30 = l30 + 1) {
-			fVec13[l30] = 0.0;
-		}
 		for (int l31 = 0; l31 < 2; l31 = l31 + 1) {
 			fRec30[l31] = 0.0;
 		}
@@ -862,12 +1057,6 @@ class zitarev_dsp : public dsp {
 		for (int l33 = 0; l33 < 2; l33 = l33 + 1) {
 			fRec36[l33] = 0.0;
 		}
-		for (int l34 = 0; l34 < 32768; l34 = l34 + 1) {
-			fVec14[l34] = 0.0;
-		}
-		for (int l35 = 0; l35 < 4096; l35 = l35 + 1) {
-			fVec15[l35] = 0.0;
-		}
 		for (int l36 = 0; l36 < 2; l36 = l36 + 1) {
 			fRec34[l36] = 0.0;
 		}
@@ -877,12 +1066,6 @@ class zitarev_dsp : public dsp {
 		for (int l38 = 0; l38 < 2; l38 = l38 + 1) {
 			fRec40[l38] = 0.0;
 		}
-		for (int l39 = 0; l39 < 32768; l39 = l39 + 1) {
-			fVec16[l39] = 0.0;
-		}
-		for (int l40 = 0; l40 < 2048; l40 = l40 + 1) {
-			fVec17[l40] = 0.0;
-		}
 		for (int l41 = 0; l41 < 2; l41 = l41 + 1) {
 			fRec38[l41] = 0.0;
 		}
@@ -928,6 +1111,23 @@ class zitarev_dsp : public dsp {
 		for (int l55 = 0; l55 < 3; l55 = l55 + 1) {
 			fRec44[l55] = 0.0;
 		}
+		fControls.invalidate();
+		resetLines();
+	}
+
+	void resetLines() {
+		if (bMemoryZeroed) {
+			bMemoryZeroed = false;
+			iClearPos = iClearEnd;
+		} else {
+			// The predelay is read at a variable delay, clear its tail now
+			for (int i = 0; i < ZITAREV_LINES; i++) {
+				if (isPredelayLine(i))
+					memset(fLines[i] + (iLineSize[i] - iPredelayMax) * iLanes, 0,
+						   iPredelayMax * iLanes * sizeof(double));
+			}
+			iClearPos = 0;
+		}
 	}
 
 	virtual void init(int sample_rate) {
@@ -949,11 +1149,8 @@ class zitarev_dsp : public dsp {
 
     virtual void buildUserInterface(UI* ui_interface) {}
 
-	virtual void compute(int count, FAUSTFLOAT** RESTRICT inputs, FAUSTFLOAT** RESTRICT outputs) {
-		FAUSTFLOAT* input0 = inputs[0];
-		FAUSTFLOAT* input1 = inputs[1];
-		FAUSTFLOAT* output0 = outputs[0];
-		FAUSTFLOAT* output1 = outputs[1];
+	// The coefficients that depend only on the controls, computed once per block
+	void computeSlow(zitarev_slow &k) {
 		double fSlow0 = std::pow(1e+01, 0.05 * double(params[ZR_EQ2LEVEL]));
 		double fSlow1 = double(params[ZR_EQ2FREQ]);
 		double fSlow2 = fConst1 * (fSlow1 / std::sqrt(std::max<double>(0.0, fSlow0)));
@@ -979,7 +1176,7 @@ class zitarev_dsp : public dsp {
 		double fSlow22 = double(params[ZR_DECAYLOW]);
 		double fSlow23 = std::exp(-(fConst3 / fSlow22)) / fSlow11 + -1.0;
 		double fSlow24 = fSlow11 * (fSlow16 + (1.0 - fSlow17));
-		int iSlow25 = int(std::min<double>(8192.0, std::max<double>(0.0, fConst7 * double(params[ZR_DELAYMS]))));
+		int iSlow25 = int(std::min<double>(double(iPredelayMax), std::max<double>(0.0, fConst7 * double(params[ZR_DELAYMS]))));
 		double fSlow26 = std::exp(-(fConst10 / fSlow10));
 		double fSlow27 = pow2f(fSlow26);
 		double fSlow28 = 1.0 - fSlow27;
@@ -1045,72 +1242,171 @@ class zitarev_dsp : public dsp {
 		double fSlow88 = fSlow80 * (fSlow84 + (1.0 - fSlow85));
 		double fSlow89 = fConst44 * double(params[ZR_DRYWET]);
 		double fSlow90 = fConst44 * std::pow(1e+01, 0.05 * double(params[ZR_LEVEL]));
+		k.fSlow0 = fSlow0;
+		k.fSlow3 = fSlow3;
+		k.fSlow4 = fSlow4;
+		k.fSlow5 = fSlow5;
+		k.fSlow8 = fSlow8;
+		k.fSlow9 = fSlow9;
+		k.fSlow18 = fSlow18;
+		k.fSlow20 = fSlow20;
+		k.fSlow21 = fSlow21;
+		k.fSlow23 = fSlow23;
+		k.fSlow24 = fSlow24;
+		k.iSlow25 = iSlow25;
+		k.fSlow32 = fSlow32;
+		k.fSlow33 = fSlow33;
+		k.fSlow34 = fSlow34;
+		k.fSlow41 = fSlow41;
+		k.fSlow42 = fSlow42;
+		k.fSlow43 = fSlow43;
+		k.fSlow50 = fSlow50;
+		k.fSlow51 = fSlow51;
+		k.fSlow52 = fSlow52;
+		k.fSlow59 = fSlow59;
+		k.fSlow60 = fSlow60;
+		k.fSlow61 = fSlow61;
+		k.fSlow68 = fSlow68;
+		k.fSlow69 = fSlow69;
+		k.fSlow70 = fSlow70;
+		k.fSlow77 = fSlow77;
+		k.fSlow78 = fSlow78;
+		k.fSlow79 = fSlow79;
+		k.fSlow86 = fSlow86;
+		k.fSlow87 = fSlow87;
+		k.fSlow88 = fSlow88;
+		k.fSlow89 = fSlow89;
+		k.fSlow90 = fSlow90;
+	}
+
+	// The coefficients are only computed when the controls change. In that case
+	// they ramp from their previous values to the new ones over the block, to
+	// avoid zipper noise, and updateSlow returns true. k: the coefficients for
+	// the first sample. dk: their increment per sample, if ramping
+	bool updateSlow(int count, zitarev_slow &k, zitarev_slow &dk) {
+		const bool first = !fControls.valid;
+		if (!fControls.changed(params)) {
+			k = fSlowCur;
+			return false;
+		}
+		zitarev_slow target;
+		computeSlow(target);
+		if (first || count <= 1) {
+			k = fSlowCur = target;
+			return false;
+		}
+		fSlowCur.delta(target, count, dk);
+		k = fSlowCur;
+		k.step(dk);
+		k.iSlow25 = target.iSlow25;
+		fSlowCur = target;
+		return true;
+	}
+
+	virtual void compute(int count, FAUSTFLOAT** RESTRICT inputs, FAUSTFLOAT** RESTRICT outputs) {
+		if (iClearPos < iClearEnd)
+			clearLines(count);
+		zitarev_slow k, dk;
+		if (updateSlow(count, k, dk))
+			computeBlock<true>(count, inputs, outputs, k, dk);
+		else
+			computeBlock<false>(count, inputs, outputs, k, dk);
+	}
+
+	template <bool RAMP>
+	POODLE_MULTIVERSION
+	void computeBlock(int count, FAUSTFLOAT** RESTRICT inputs, FAUSTFLOAT** RESTRICT outputs,
+					  zitarev_slow k, const zitarev_slow &dk) {
+		FAUSTFLOAT* input0 = inputs[0];
+		FAUSTFLOAT* input1 = inputs[1];
+		FAUSTFLOAT* output0 = outputs[0];
+		FAUSTFLOAT* output1 = outputs[1];
+		// Local copies of the delay lines, which the compiler knows do not
+		// overlap the state kept in the object
+		double* RESTRICT fVec0 = this->fVec0;
+		double* RESTRICT fVec1 = this->fVec1;
+		double* RESTRICT fVec2 = this->fVec2;
+		double* RESTRICT fVec3 = this->fVec3;
+		double* RESTRICT fVec4 = this->fVec4;
+		double* RESTRICT fVec5 = this->fVec5;
+		double* RESTRICT fVec6 = this->fVec6;
+		double* RESTRICT fVec7 = this->fVec7;
+		double* RESTRICT fVec8 = this->fVec8;
+		double* RESTRICT fVec9 = this->fVec9;
+		double* RESTRICT fVec10 = this->fVec10;
+		double* RESTRICT fVec11 = this->fVec11;
+		double* RESTRICT fVec12 = this->fVec12;
+		double* RESTRICT fVec13 = this->fVec13;
+		double* RESTRICT fVec14 = this->fVec14;
+		double* RESTRICT fVec15 = this->fVec15;
+		double* RESTRICT fVec16 = this->fVec16;
+		double* RESTRICT fVec17 = this->fVec17;
 		for (int i0 = 0; i0 < count; i0 = i0 + 1) {
-			double fTemp0 = fSlow4 * fRec0[1];
-			double fTemp1 = fSlow9 * fRec1[1];
-			fRec13[0] = -(fSlow21 * (fSlow20 * fRec13[1] - (fRec6[1] + fRec6[2])));
-			fRec12[0] = fSlow24 * (fRec6[1] + fSlow23 * fRec13[0]) + fSlow18 * fRec12[1];
-			fVec0[IOTA0 & 16383] = 0.35355339059327373 * fRec12[0] + 1e-20;
+			double fTemp0 = k.fSlow4 * fRec0[1];
+			double fTemp1 = k.fSlow9 * fRec1[1];
+			fRec13[0] = -(k.fSlow21 * (k.fSlow20 * fRec13[1] - (fRec6[1] + fRec6[2])));
+			fRec12[0] = k.fSlow24 * (fRec6[1] + k.fSlow23 * fRec13[0]) + k.fSlow18 * fRec12[1];
+			fVec0[IOTA0 & iMask0] = 0.35355339059327373 * fRec12[0] + 1e-20;
 			double fTemp2 = double(input0[i0]);
-			fVec1[IOTA0 & 16383] = fTemp2;
-			double fTemp3 = 0.3 * fVec1[(IOTA0 - iSlow25) & 16383];
-			double fTemp4 = fTemp3 + fVec0[(IOTA0 - iConst6) & 16383] - 0.6 * fRec10[1];
-			fVec2[IOTA0 & 4095] = fTemp4;
-			fRec10[0] = fVec2[(IOTA0 - iConst8) & 4095];
+			fVec1[IOTA0 & iMask1] = fTemp2;
+			double fTemp3 = 0.3 * fVec1[(IOTA0 - k.iSlow25) & iMask1];
+			double fTemp4 = fTemp3 + fVec0[(IOTA0 - iConst6) & iMask0] - 0.6 * fRec10[1];
+			fVec2[IOTA0 & iMask2] = fTemp4;
+			fRec10[0] = fVec2[(IOTA0 - iConst8) & iMask2];
 			double fRec11 = 0.6 * fTemp4;
-			fRec17[0] = -(fSlow21 * (fSlow20 * fRec17[1] - (fRec2[1] + fRec2[2])));
-			fRec16[0] = fSlow34 * (fRec2[1] + fSlow33 * fRec17[0]) + fSlow32 * fRec16[1];
-			fVec3[IOTA0 & 16383] = 0.35355339059327373 * fRec16[0] + 1e-20;
-			double fTemp5 = fVec3[(IOTA0 - iConst12) & 16383] + fTemp3 - 0.6 * fRec14[1];
-			fVec4[IOTA0 & 2047] = fTemp5;
-			fRec14[0] = fVec4[(IOTA0 - iConst13) & 2047];
+			fRec17[0] = -(k.fSlow21 * (k.fSlow20 * fRec17[1] - (fRec2[1] + fRec2[2])));
+			fRec16[0] = k.fSlow34 * (fRec2[1] + k.fSlow33 * fRec17[0]) + k.fSlow32 * fRec16[1];
+			fVec3[IOTA0 & iMask3] = 0.35355339059327373 * fRec16[0] + 1e-20;
+			double fTemp5 = fVec3[(IOTA0 - iConst12) & iMask3] + fTemp3 - 0.6 * fRec14[1];
+			fVec4[IOTA0 & iMask4] = fTemp5;
+			fRec14[0] = fVec4[(IOTA0 - iConst13) & iMask4];
 			double fRec15 = 0.6 * fTemp5;
 			double fTemp6 = fRec15 + fRec11;
-			fRec21[0] = -(fSlow21 * (fSlow20 * fRec21[1] - (fRec4[1] + fRec4[2])));
-			fRec20[0] = fSlow43 * (fRec4[1] + fSlow42 * fRec21[0]) + fSlow41 * fRec20[1];
-			fVec5[IOTA0 & 16383] = 0.35355339059327373 * fRec20[0] + 1e-20;
-			double fTemp7 = fVec5[(IOTA0 - iConst17) & 16383] - (fTemp3 + 0.6 * fRec18[1]);
-			fVec6[IOTA0 & 4095] = fTemp7;
-			fRec18[0] = fVec6[(IOTA0 - iConst18) & 4095];
+			fRec21[0] = -(k.fSlow21 * (k.fSlow20 * fRec21[1] - (fRec4[1] + fRec4[2])));
+			fRec20[0] = k.fSlow43 * (fRec4[1] + k.fSlow42 * fRec21[0]) + k.fSlow41 * fRec20[1];
+			fVec5[IOTA0 & iMask5] = 0.35355339059327373 * fRec20[0] + 1e-20;
+			double fTemp7 = fVec5[(IOTA0 - iConst17) & iMask5] - (fTemp3 + 0.6 * fRec18[1]);
+			fVec6[IOTA0 & iMask6] = fTemp7;
+			fRec18[0] = fVec6[(IOTA0 - iConst18) & iMask6];
 			double fRec19 = 0.6 * fTemp7;
-			fRec25[0] = -(fSlow21 * (fSlow20 * fRec25[1] - (fRec8[1] + fRec8[2])));
-			fRec24[0] = fSlow52 * (fRec8[1] + fSlow51 * fRec25[0]) + fSlow50 * fRec24[1];
-			fVec7[IOTA0 & 16383] = 0.35355339059327373 * fRec24[0] + 1e-20;
-			double fTemp8 = fVec7[(IOTA0 - iConst22) & 16383] - (fTemp3 + 0.6 * fRec22[1]);
-			fVec8[IOTA0 & 2047] = fTemp8;
-			fRec22[0] = fVec8[(IOTA0 - iConst23) & 2047];
+			fRec25[0] = -(k.fSlow21 * (k.fSlow20 * fRec25[1] - (fRec8[1] + fRec8[2])));
+			fRec24[0] = k.fSlow52 * (fRec8[1] + k.fSlow51 * fRec25[0]) + k.fSlow50 * fRec24[1];
+			fVec7[IOTA0 & iMask7] = 0.35355339059327373 * fRec24[0] + 1e-20;
+			double fTemp8 = fVec7[(IOTA0 - iConst22) & iMask7] - (fTemp3 + 0.6 * fRec22[1]);
+			fVec8[IOTA0 & iMask8] = fTemp8;
+			fRec22[0] = fVec8[(IOTA0 - iConst23) & iMask8];
 			double fRec23 = 0.6 * fTemp8;
 			double fTemp9 = fRec23 + fRec19 + fTemp6;
-			fRec29[0] = -(fSlow21 * (fSlow20 * fRec29[1] - (fRec3[1] + fRec3[2])));
-			fRec28[0] = fSlow61 * (fRec3[1] + fSlow60 * fRec29[0]) + fSlow59 * fRec28[1];
-			fVec9[IOTA0 & 32767] = 0.35355339059327373 * fRec28[0] + 1e-20;
+			fRec29[0] = -(k.fSlow21 * (k.fSlow20 * fRec29[1] - (fRec3[1] + fRec3[2])));
+			fRec28[0] = k.fSlow61 * (fRec3[1] + k.fSlow60 * fRec29[0]) + k.fSlow59 * fRec28[1];
+			fVec9[IOTA0 & iMask9] = 0.35355339059327373 * fRec28[0] + 1e-20;
 			double fTemp10 = double(input1[i0]);
-			fVec10[IOTA0 & 16383] = fTemp10;
-			double fTemp11 = 0.3 * fVec10[(IOTA0 - iSlow25) & 16383];
-			double fTemp12 = fTemp11 + 0.6 * fRec26[1] + fVec9[(IOTA0 - iConst27) & 32767];
-			fVec11[IOTA0 & 4095] = fTemp12;
-			fRec26[0] = fVec11[(IOTA0 - iConst28) & 4095];
+			fVec10[IOTA0 & iMask10] = fTemp10;
+			double fTemp11 = 0.3 * fVec10[(IOTA0 - k.iSlow25) & iMask10];
+			double fTemp12 = fTemp11 + 0.6 * fRec26[1] + fVec9[(IOTA0 - iConst27) & iMask9];
+			fVec11[IOTA0 & iMask11] = fTemp12;
+			fRec26[0] = fVec11[(IOTA0 - iConst28) & iMask11];
 			double fRec27 = -(0.6 * fTemp12);
-			fRec33[0] = -(fSlow21 * (fSlow20 * fRec33[1] - (fRec7[1] + fRec7[2])));
-			fRec32[0] = fSlow70 * (fRec7[1] + fSlow69 * fRec33[0]) + fSlow68 * fRec32[1];
-			fVec12[IOTA0 & 16383] = 0.35355339059327373 * fRec32[0] + 1e-20;
-			double fTemp13 = fVec12[(IOTA0 - iConst32) & 16383] + fTemp11 + 0.6 * fRec30[1];
-			fVec13[IOTA0 & 4095] = fTemp13;
-			fRec30[0] = fVec13[(IOTA0 - iConst33) & 4095];
+			fRec33[0] = -(k.fSlow21 * (k.fSlow20 * fRec33[1] - (fRec7[1] + fRec7[2])));
+			fRec32[0] = k.fSlow70 * (fRec7[1] + k.fSlow69 * fRec33[0]) + k.fSlow68 * fRec32[1];
+			fVec12[IOTA0 & iMask12] = 0.35355339059327373 * fRec32[0] + 1e-20;
+			double fTemp13 = fVec12[(IOTA0 - iConst32) & iMask12] + fTemp11 + 0.6 * fRec30[1];
+			fVec13[IOTA0 & iMask13] = fTemp13;
+			fRec30[0] = fVec13[(IOTA0 - iConst33) & iMask13];
 			double fRec31 = -(0.6 * fTemp13);
-			fRec37[0] = -(fSlow21 * (fSlow20 * fRec37[1] - (fRec5[1] + fRec5[2])));
-			fRec36[0] = fSlow79 * (fRec5[1] + fSlow78 * fRec37[0]) + fSlow77 * fRec36[1];
-			fVec14[IOTA0 & 32767] = 0.35355339059327373 * fRec36[0] + 1e-20;
-			double fTemp14 = 0.6 * fRec34[1] + fVec14[(IOTA0 - iConst37) & 32767];
-			fVec15[IOTA0 & 4095] = fTemp14 - fTemp11;
-			fRec34[0] = fVec15[(IOTA0 - iConst38) & 4095];
+			fRec37[0] = -(k.fSlow21 * (k.fSlow20 * fRec37[1] - (fRec5[1] + fRec5[2])));
+			fRec36[0] = k.fSlow79 * (fRec5[1] + k.fSlow78 * fRec37[0]) + k.fSlow77 * fRec36[1];
+			fVec14[IOTA0 & iMask14] = 0.35355339059327373 * fRec36[0] + 1e-20;
+			double fTemp14 = 0.6 * fRec34[1] + fVec14[(IOTA0 - iConst37) & iMask14];
+			fVec15[IOTA0 & iMask15] = fTemp14 - fTemp11;
+			fRec34[0] = fVec15[(IOTA0 - iConst38) & iMask15];
 			double fRec35 = 0.6 * (fTemp11 - fTemp14);
-			fRec41[0] = -(fSlow21 * (fSlow20 * fRec41[1] - (fRec9[1] + fRec9[2])));
-			fRec40[0] = fSlow88 * (fRec9[1] + fSlow87 * fRec41[0]) + fSlow86 * fRec40[1];
-			fVec16[IOTA0 & 32767] = 0.35355339059327373 * fRec40[0] + 1e-20;
-			double fTemp15 = 0.6 * fRec38[1] + fVec16[(IOTA0 - iConst42) & 32767];
-			fVec17[IOTA0 & 2047] = fTemp15 - fTemp11;
-			fRec38[0] = fVec17[(IOTA0 - iConst43) & 2047];
+			fRec41[0] = -(k.fSlow21 * (k.fSlow20 * fRec41[1] - (fRec9[1] + fRec9[2])));
+			fRec40[0] = k.fSlow88 * (fRec9[1] + k.fSlow87 * fRec41[0]) + k.fSlow86 * fRec40[1];
+			fVec16[IOTA0 & iMask16] = 0.35355339059327373 * fRec40[0] + 1e-20;
+			double fTemp15 = 0.6 * fRec38[1] + fVec16[(IOTA0 - iConst42) & iMask16];
+			fVec17[IOTA0 & iMask17] = fTemp15 - fTemp11;
+			fRec38[0] = fVec17[(IOTA0 - iConst43) & iMask17];
 			double fRec39 = 0.6 * (fTemp11 - fTemp15);
 			fRec2[0] = fRec38[1] + fRec34[1] + fRec30[1] + fRec26[1] + fRec22[1] + fRec18[1] + fRec10[1] + fRec14[1] + fRec39 + fRec35 + fRec31 + fRec27 + fTemp9;
 			fRec3[0] = fRec22[1] + fRec18[1] + fRec10[1] + fRec14[1] + fTemp9 - (fRec38[1] + fRec34[1] + fRec30[1] + fRec26[1] + fRec39 + fRec35 + fRec27 + fRec31);
@@ -1127,30 +1423,30 @@ class zitarev_dsp : public dsp {
 			fRec9[0] = fRec34[1] + fRec30[1] + fRec22[1] + fRec14[1] + fRec35 + fRec31 + fTemp20 - (fRec38[1] + fRec26[1] + fRec18[1] + fRec10[1] + fRec39 + fRec27 + fTemp19);
 			double fTemp21 = 0.37 * (fRec3[0] + fRec4[0]);
 			double fTemp22 = fTemp21 + fTemp1;
-			fRec1[0] = fTemp22 - fSlow8 * fRec1[2];
-			double fTemp23 = fSlow8 * fRec1[0];
-			double fTemp24 = fSlow5 * (fRec1[2] + fTemp23 - fTemp22);
+			fRec1[0] = fTemp22 - k.fSlow8 * fRec1[2];
+			double fTemp23 = k.fSlow8 * fRec1[0];
+			double fTemp24 = k.fSlow5 * (fRec1[2] + fTemp23 - fTemp22);
 			double fTemp25 = fTemp23 + fTemp21 + fRec1[2];
-			fRec0[0] = 0.5 * (fTemp25 - fTemp1 + fTemp24) + fTemp0 - fSlow3 * fRec0[2];
+			fRec0[0] = 0.5 * (fTemp25 - fTemp1 + fTemp24) + fTemp0 - k.fSlow3 * fRec0[2];
 			double fTemp26 = 0.5 * (fTemp25 + fTemp24 - fTemp1);
-			double fTemp27 = fRec0[2] + fSlow3 * fRec0[0];
-			fRec42[0] = fSlow89 + fConst45 * fRec42[1];
+			double fTemp27 = fRec0[2] + k.fSlow3 * fRec0[0];
+			fRec42[0] = k.fSlow89 + fConst45 * fRec42[1];
 			double fTemp28 = fRec42[0] + 1.0;
 			double fTemp29 = 1.0 - 0.5 * fTemp28;
-			fRec43[0] = fSlow90 + fConst45 * fRec43[1];
-			output0[i0] = FAUSTFLOAT(0.5 * fRec43[0] * (fTemp2 * fTemp28 + fTemp29 * (fTemp27 + fTemp26 + fSlow0 * (fTemp27 - (fTemp0 + fTemp26)) - fTemp0)));
-			double fTemp30 = fSlow4 * fRec44[1];
-			double fTemp31 = fSlow9 * fRec45[1];
+			fRec43[0] = k.fSlow90 + fConst45 * fRec43[1];
+			output0[i0] = FAUSTFLOAT(0.5 * fRec43[0] * (fTemp2 * fTemp28 + fTemp29 * (fTemp27 + fTemp26 + k.fSlow0 * (fTemp27 - (fTemp0 + fTemp26)) - fTemp0)));
+			double fTemp30 = k.fSlow4 * fRec44[1];
+			double fTemp31 = k.fSlow9 * fRec45[1];
 			double fTemp32 = 0.37 * (fRec3[0] - fRec4[0]);
 			double fTemp33 = fTemp32 + fTemp31;
-			fRec45[0] = fTemp33 - fSlow8 * fRec45[2];
-			double fTemp34 = fSlow8 * fRec45[0];
-			double fTemp35 = fSlow5 * (fRec45[2] + fTemp34 - fTemp33);
+			fRec45[0] = fTemp33 - k.fSlow8 * fRec45[2];
+			double fTemp34 = k.fSlow8 * fRec45[0];
+			double fTemp35 = k.fSlow5 * (fRec45[2] + fTemp34 - fTemp33);
 			double fTemp36 = fTemp34 + fTemp32 + fRec45[2];
-			fRec44[0] = 0.5 * (fTemp36 - fTemp31 + fTemp35) + fTemp30 - fSlow3 * fRec44[2];
+			fRec44[0] = 0.5 * (fTemp36 - fTemp31 + fTemp35) + fTemp30 - k.fSlow3 * fRec44[2];
 			double fTemp37 = 0.5 * (fTemp36 + fTemp35 - fTemp31);
-			double fTemp38 = fRec44[2] + fSlow3 * fRec44[0];
-			output1[i0] = FAUSTFLOAT(0.5 * fRec43[0] * (fTemp10 * fTemp28 + fTemp29 * (fTemp38 + fTemp37 + fSlow0 * (fTemp38 - (fTemp30 + fTemp37)) - fTemp30)));
+			double fTemp38 = fRec44[2] + k.fSlow3 * fRec44[0];
+			output1[i0] = FAUSTFLOAT(0.5 * fRec43[0] * (fTemp10 * fTemp28 + fTemp29 * (fTemp38 + fTemp37 + k.fSlow0 * (fTemp38 - (fTemp30 + fTemp37)) - fTemp30)));
 			fRec13[1] = fRec13[0];
 			fRec12[1] = fRec12[0];
 			IOTA0 = IOTA0 + 1;
@@ -1202,12 +1498,343 @@ class zitarev_dsp : public dsp {
 			fRec45[1] = fRec45[0];
 			fRec44[2] = fRec44[1];
 			fRec44[1] = fRec44[0];
+			if (RAMP)
+				k.step(dk);
 		}
 	}
 
 };
 
 
+// zitarev_dsp processing L instances (lanes) with the same settings at once.
+// The state of the instances is interleaved, each value of zitarev_dsp has one
+// slot per lane, so that every operation of the per sample loop is done on L
+// contiguous values and compiles to vector instructions (L = 4 fills an AVX2
+// register with doubles). The constants, the delay line sizes and the per block
+// coefficients are shared with zitarev_dsp, which holds them
+template <int L>
+class zitarev_lanes_dsp : public zitarev_dsp {
+
+ public:
+
+	// The state of zitarev_dsp, per lane. These hide the scalar members
+	double fRec13[2][L];
+	double fRec12[2][L];
+	double fRec10[2][L];
+	double fRec17[2][L];
+	double fRec16[2][L];
+	double fRec14[2][L];
+	double fRec21[2][L];
+	double fRec20[2][L];
+	double fRec18[2][L];
+	double fRec25[2][L];
+	double fRec24[2][L];
+	double fRec22[2][L];
+	double fRec29[2][L];
+	double fRec28[2][L];
+	double fRec26[2][L];
+	double fRec33[2][L];
+	double fRec32[2][L];
+	double fRec30[2][L];
+	double fRec36[2][L];
+	double fRec37[2][L];
+	double fRec34[2][L];
+	double fRec41[2][L];
+	double fRec40[2][L];
+	double fRec38[2][L];
+	double fRec2[3][L];
+	double fRec3[3][L];
+	double fRec4[3][L];
+	double fRec5[3][L];
+	double fRec6[3][L];
+	double fRec7[3][L];
+	double fRec8[3][L];
+	double fRec9[3][L];
+	double fRec1[3][L];
+	double fRec0[3][L];
+	double fRec42[2][L];
+	double fRec43[2][L];
+	double fRec45[3][L];
+	double fRec44[3][L];
+
+	zitarev_lanes_dsp() {
+		iLanes = L;
+		iObjectSize = objectSize();
+	}
+
+	static size_t objectSize() { return (sizeof(zitarev_lanes_dsp) + 63) & ~(size_t)63; }
+
+	static size_t memorySize(int sample_rate) {
+		return objectSize() + zitarev_dsp::linesLength(sample_rate) * L * sizeof(double);
+	}
+
+	virtual int getNumInputs() { return 2 * L; }
+	virtual int getNumOutputs() { return 2 * L; }
+
+	virtual void instanceClear() {
+		memset(fRec13, 0, sizeof(fRec13));
+		memset(fRec12, 0, sizeof(fRec12));
+		memset(fRec10, 0, sizeof(fRec10));
+		memset(fRec17, 0, sizeof(fRec17));
+		memset(fRec16, 0, sizeof(fRec16));
+		memset(fRec14, 0, sizeof(fRec14));
+		memset(fRec21, 0, sizeof(fRec21));
+		memset(fRec20, 0, sizeof(fRec20));
+		memset(fRec18, 0, sizeof(fRec18));
+		memset(fRec25, 0, sizeof(fRec25));
+		memset(fRec24, 0, sizeof(fRec24));
+		memset(fRec22, 0, sizeof(fRec22));
+		memset(fRec29, 0, sizeof(fRec29));
+		memset(fRec28, 0, sizeof(fRec28));
+		memset(fRec26, 0, sizeof(fRec26));
+		memset(fRec33, 0, sizeof(fRec33));
+		memset(fRec32, 0, sizeof(fRec32));
+		memset(fRec30, 0, sizeof(fRec30));
+		memset(fRec36, 0, sizeof(fRec36));
+		memset(fRec37, 0, sizeof(fRec37));
+		memset(fRec34, 0, sizeof(fRec34));
+		memset(fRec41, 0, sizeof(fRec41));
+		memset(fRec40, 0, sizeof(fRec40));
+		memset(fRec38, 0, sizeof(fRec38));
+		memset(fRec2, 0, sizeof(fRec2));
+		memset(fRec3, 0, sizeof(fRec3));
+		memset(fRec4, 0, sizeof(fRec4));
+		memset(fRec5, 0, sizeof(fRec5));
+		memset(fRec6, 0, sizeof(fRec6));
+		memset(fRec7, 0, sizeof(fRec7));
+		memset(fRec8, 0, sizeof(fRec8));
+		memset(fRec9, 0, sizeof(fRec9));
+		memset(fRec1, 0, sizeof(fRec1));
+		memset(fRec0, 0, sizeof(fRec0));
+		memset(fRec42, 0, sizeof(fRec42));
+		memset(fRec43, 0, sizeof(fRec43));
+		memset(fRec45, 0, sizeof(fRec45));
+		memset(fRec44, 0, sizeof(fRec44));
+		IOTA0 = 0;
+		fControls.invalidate();
+		resetLines();
+	}
+
+	// inputs: the left inputs of the L lanes followed by their right inputs.
+	// outputs: same layout
+	virtual void compute(int count, FAUSTFLOAT** RESTRICT inputs, FAUSTFLOAT** RESTRICT outputs) {
+		if (iClearPos < iClearEnd)
+			clearLines(count);
+		zitarev_slow k, dk;
+		if (updateSlow(count, k, dk))
+			computeBlock<true>(count, inputs, outputs, k, dk);
+		else
+			computeBlock<false>(count, inputs, outputs, k, dk);
+	}
+
+	template <bool RAMP>
+	POODLE_MULTIVERSION
+	void computeBlock(int count, FAUSTFLOAT** RESTRICT inputs, FAUSTFLOAT** RESTRICT outputs,
+					  zitarev_slow k, const zitarev_slow &dk) {
+		// The inputs are interleaved into, and the outputs deinterleaved from,
+		// these buffers, ZITAREV_CHUNK samples at a time
+		double in0[ZITAREV_CHUNK * L], in1[ZITAREV_CHUNK * L];
+		double out0[ZITAREV_CHUNK * L], out1[ZITAREV_CHUNK * L];
+		// See zitarev_dsp::computeBlock
+		double* RESTRICT fVec0 = this->fVec0;
+		double* RESTRICT fVec1 = this->fVec1;
+		double* RESTRICT fVec2 = this->fVec2;
+		double* RESTRICT fVec3 = this->fVec3;
+		double* RESTRICT fVec4 = this->fVec4;
+		double* RESTRICT fVec5 = this->fVec5;
+		double* RESTRICT fVec6 = this->fVec6;
+		double* RESTRICT fVec7 = this->fVec7;
+		double* RESTRICT fVec8 = this->fVec8;
+		double* RESTRICT fVec9 = this->fVec9;
+		double* RESTRICT fVec10 = this->fVec10;
+		double* RESTRICT fVec11 = this->fVec11;
+		double* RESTRICT fVec12 = this->fVec12;
+		double* RESTRICT fVec13 = this->fVec13;
+		double* RESTRICT fVec14 = this->fVec14;
+		double* RESTRICT fVec15 = this->fVec15;
+		double* RESTRICT fVec16 = this->fVec16;
+		double* RESTRICT fVec17 = this->fVec17;
+		for (int c0 = 0; c0 < count; c0 += ZITAREV_CHUNK) {
+			const int n = std::min(ZITAREV_CHUNK, count - c0);
+			for (int l = 0; l < L; l++) {
+				for (int i0 = 0; i0 < n; i0++) {
+					in0[i0 * L + l] = double(inputs[l][c0 + i0]);
+					in1[i0 * L + l] = double(inputs[L + l][c0 + i0]);
+				}
+			}
+			for (int i0 = 0; i0 < n; i0 = i0 + 1) {
+				IVDEP
+				for (int l = 0; l < L; l++) {
+						double fTemp0 = k.fSlow4 * fRec0[1][l];
+						double fTemp1 = k.fSlow9 * fRec1[1][l];
+						fRec13[0][l] = -(k.fSlow21 * (k.fSlow20 * fRec13[1][l] - (fRec6[1][l] + fRec6[2][l])));
+						fRec12[0][l] = k.fSlow24 * (fRec6[1][l] + k.fSlow23 * fRec13[0][l]) + k.fSlow18 * fRec12[1][l];
+						fVec0[(IOTA0 & iMask0) * L + l] = 0.35355339059327373 * fRec12[0][l] + 1e-20;
+						double fTemp2 = double(in0[i0 * L + l]);
+						fVec1[(IOTA0 & iMask1) * L + l] = fTemp2;
+						double fTemp3 = 0.3 * fVec1[((IOTA0 - k.iSlow25) & iMask1) * L + l];
+						double fTemp4 = fTemp3 + fVec0[((IOTA0 - iConst6) & iMask0) * L + l] - 0.6 * fRec10[1][l];
+						fVec2[(IOTA0 & iMask2) * L + l] = fTemp4;
+						fRec10[0][l] = fVec2[((IOTA0 - iConst8) & iMask2) * L + l];
+						double fRec11 = 0.6 * fTemp4;
+						fRec17[0][l] = -(k.fSlow21 * (k.fSlow20 * fRec17[1][l] - (fRec2[1][l] + fRec2[2][l])));
+						fRec16[0][l] = k.fSlow34 * (fRec2[1][l] + k.fSlow33 * fRec17[0][l]) + k.fSlow32 * fRec16[1][l];
+						fVec3[(IOTA0 & iMask3) * L + l] = 0.35355339059327373 * fRec16[0][l] + 1e-20;
+						double fTemp5 = fVec3[((IOTA0 - iConst12) & iMask3) * L + l] + fTemp3 - 0.6 * fRec14[1][l];
+						fVec4[(IOTA0 & iMask4) * L + l] = fTemp5;
+						fRec14[0][l] = fVec4[((IOTA0 - iConst13) & iMask4) * L + l];
+						double fRec15 = 0.6 * fTemp5;
+						double fTemp6 = fRec15 + fRec11;
+						fRec21[0][l] = -(k.fSlow21 * (k.fSlow20 * fRec21[1][l] - (fRec4[1][l] + fRec4[2][l])));
+						fRec20[0][l] = k.fSlow43 * (fRec4[1][l] + k.fSlow42 * fRec21[0][l]) + k.fSlow41 * fRec20[1][l];
+						fVec5[(IOTA0 & iMask5) * L + l] = 0.35355339059327373 * fRec20[0][l] + 1e-20;
+						double fTemp7 = fVec5[((IOTA0 - iConst17) & iMask5) * L + l] - (fTemp3 + 0.6 * fRec18[1][l]);
+						fVec6[(IOTA0 & iMask6) * L + l] = fTemp7;
+						fRec18[0][l] = fVec6[((IOTA0 - iConst18) & iMask6) * L + l];
+						double fRec19 = 0.6 * fTemp7;
+						fRec25[0][l] = -(k.fSlow21 * (k.fSlow20 * fRec25[1][l] - (fRec8[1][l] + fRec8[2][l])));
+						fRec24[0][l] = k.fSlow52 * (fRec8[1][l] + k.fSlow51 * fRec25[0][l]) + k.fSlow50 * fRec24[1][l];
+						fVec7[(IOTA0 & iMask7) * L + l] = 0.35355339059327373 * fRec24[0][l] + 1e-20;
+						double fTemp8 = fVec7[((IOTA0 - iConst22) & iMask7) * L + l] - (fTemp3 + 0.6 * fRec22[1][l]);
+						fVec8[(IOTA0 & iMask8) * L + l] = fTemp8;
+						fRec22[0][l] = fVec8[((IOTA0 - iConst23) & iMask8) * L + l];
+						double fRec23 = 0.6 * fTemp8;
+						double fTemp9 = fRec23 + fRec19 + fTemp6;
+						fRec29[0][l] = -(k.fSlow21 * (k.fSlow20 * fRec29[1][l] - (fRec3[1][l] + fRec3[2][l])));
+						fRec28[0][l] = k.fSlow61 * (fRec3[1][l] + k.fSlow60 * fRec29[0][l]) + k.fSlow59 * fRec28[1][l];
+						fVec9[(IOTA0 & iMask9) * L + l] = 0.35355339059327373 * fRec28[0][l] + 1e-20;
+						double fTemp10 = double(in1[i0 * L + l]);
+						fVec10[(IOTA0 & iMask10) * L + l] = fTemp10;
+						double fTemp11 = 0.3 * fVec10[((IOTA0 - k.iSlow25) & iMask10) * L + l];
+						double fTemp12 = fTemp11 + 0.6 * fRec26[1][l] + fVec9[((IOTA0 - iConst27) & iMask9) * L + l];
+						fVec11[(IOTA0 & iMask11) * L + l] = fTemp12;
+						fRec26[0][l] = fVec11[((IOTA0 - iConst28) & iMask11) * L + l];
+						double fRec27 = -(0.6 * fTemp12);
+						fRec33[0][l] = -(k.fSlow21 * (k.fSlow20 * fRec33[1][l] - (fRec7[1][l] + fRec7[2][l])));
+						fRec32[0][l] = k.fSlow70 * (fRec7[1][l] + k.fSlow69 * fRec33[0][l]) + k.fSlow68 * fRec32[1][l];
+						fVec12[(IOTA0 & iMask12) * L + l] = 0.35355339059327373 * fRec32[0][l] + 1e-20;
+						double fTemp13 = fVec12[((IOTA0 - iConst32) & iMask12) * L + l] + fTemp11 + 0.6 * fRec30[1][l];
+						fVec13[(IOTA0 & iMask13) * L + l] = fTemp13;
+						fRec30[0][l] = fVec13[((IOTA0 - iConst33) & iMask13) * L + l];
+						double fRec31 = -(0.6 * fTemp13);
+						fRec37[0][l] = -(k.fSlow21 * (k.fSlow20 * fRec37[1][l] - (fRec5[1][l] + fRec5[2][l])));
+						fRec36[0][l] = k.fSlow79 * (fRec5[1][l] + k.fSlow78 * fRec37[0][l]) + k.fSlow77 * fRec36[1][l];
+						fVec14[(IOTA0 & iMask14) * L + l] = 0.35355339059327373 * fRec36[0][l] + 1e-20;
+						double fTemp14 = 0.6 * fRec34[1][l] + fVec14[((IOTA0 - iConst37) & iMask14) * L + l];
+						fVec15[(IOTA0 & iMask15) * L + l] = fTemp14 - fTemp11;
+						fRec34[0][l] = fVec15[((IOTA0 - iConst38) & iMask15) * L + l];
+						double fRec35 = 0.6 * (fTemp11 - fTemp14);
+						fRec41[0][l] = -(k.fSlow21 * (k.fSlow20 * fRec41[1][l] - (fRec9[1][l] + fRec9[2][l])));
+						fRec40[0][l] = k.fSlow88 * (fRec9[1][l] + k.fSlow87 * fRec41[0][l]) + k.fSlow86 * fRec40[1][l];
+						fVec16[(IOTA0 & iMask16) * L + l] = 0.35355339059327373 * fRec40[0][l] + 1e-20;
+						double fTemp15 = 0.6 * fRec38[1][l] + fVec16[((IOTA0 - iConst42) & iMask16) * L + l];
+						fVec17[(IOTA0 & iMask17) * L + l] = fTemp15 - fTemp11;
+						fRec38[0][l] = fVec17[((IOTA0 - iConst43) & iMask17) * L + l];
+						double fRec39 = 0.6 * (fTemp11 - fTemp15);
+						fRec2[0][l] = fRec38[1][l] + fRec34[1][l] + fRec30[1][l] + fRec26[1][l] + fRec22[1][l] + fRec18[1][l] + fRec10[1][l] + fRec14[1][l] + fRec39 + fRec35 + fRec31 + fRec27 + fTemp9;
+						fRec3[0][l] = fRec22[1][l] + fRec18[1][l] + fRec10[1][l] + fRec14[1][l] + fTemp9 - (fRec38[1][l] + fRec34[1][l] + fRec30[1][l] + fRec26[1][l] + fRec39 + fRec35 + fRec27 + fRec31);
+						double fTemp16 = fRec19 + fRec23;
+						fRec4[0][l] = fRec30[1][l] + fRec26[1][l] + fRec10[1][l] + fRec14[1][l] + fRec31 + fRec27 + fTemp6 - (fRec38[1][l] + fRec34[1][l] + fRec22[1][l] + fRec18[1][l] + fRec39 + fRec35 + fTemp16);
+						fRec5[0][l] = fRec38[1][l] + fRec34[1][l] + fRec10[1][l] + fRec14[1][l] + fRec39 + fRec35 + fTemp6 - (fRec30[1][l] + fRec26[1][l] + fRec22[1][l] + fRec18[1][l] + fRec31 + fRec27 + fTemp16);
+						double fTemp17 = fRec11 + fRec23;
+						double fTemp18 = fRec15 + fRec19;
+						fRec6[0][l] = fRec34[1][l] + fRec26[1][l] + fRec18[1][l] + fRec14[1][l] + fRec35 + fRec27 + fTemp18 - (fRec38[1][l] + fRec30[1][l] + fRec22[1][l] + fRec10[1][l] + fRec39 + fRec31 + fTemp17);
+						fRec7[0][l] = fRec38[1][l] + fRec30[1][l] + fRec18[1][l] + fRec14[1][l] + fRec39 + fRec31 + fTemp18 - (fRec34[1][l] + fRec26[1][l] + fRec22[1][l] + fRec10[1][l] + fRec35 + fRec27 + fTemp17);
+						double fTemp19 = fRec11 + fRec19;
+						double fTemp20 = fRec15 + fRec23;
+						fRec8[0][l] = fRec38[1][l] + fRec26[1][l] + fRec22[1][l] + fRec14[1][l] + fRec39 + fRec27 + fTemp20 - (fRec34[1][l] + fRec30[1][l] + fRec18[1][l] + fRec10[1][l] + fRec35 + fRec31 + fTemp19);
+						fRec9[0][l] = fRec34[1][l] + fRec30[1][l] + fRec22[1][l] + fRec14[1][l] + fRec35 + fRec31 + fTemp20 - (fRec38[1][l] + fRec26[1][l] + fRec18[1][l] + fRec10[1][l] + fRec39 + fRec27 + fTemp19);
+						double fTemp21 = 0.37 * (fRec3[0][l] + fRec4[0][l]);
+						double fTemp22 = fTemp21 + fTemp1;
+						fRec1[0][l] = fTemp22 - k.fSlow8 * fRec1[2][l];
+						double fTemp23 = k.fSlow8 * fRec1[0][l];
+						double fTemp24 = k.fSlow5 * (fRec1[2][l] + fTemp23 - fTemp22);
+						double fTemp25 = fTemp23 + fTemp21 + fRec1[2][l];
+						fRec0[0][l] = 0.5 * (fTemp25 - fTemp1 + fTemp24) + fTemp0 - k.fSlow3 * fRec0[2][l];
+						double fTemp26 = 0.5 * (fTemp25 + fTemp24 - fTemp1);
+						double fTemp27 = fRec0[2][l] + k.fSlow3 * fRec0[0][l];
+						fRec42[0][l] = k.fSlow89 + fConst45 * fRec42[1][l];
+						double fTemp28 = fRec42[0][l] + 1.0;
+						double fTemp29 = 1.0 - 0.5 * fTemp28;
+						fRec43[0][l] = k.fSlow90 + fConst45 * fRec43[1][l];
+						out0[i0 * L + l] = (0.5 * fRec43[0][l] * (fTemp2 * fTemp28 + fTemp29 * (fTemp27 + fTemp26 + k.fSlow0 * (fTemp27 - (fTemp0 + fTemp26)) - fTemp0)));
+						double fTemp30 = k.fSlow4 * fRec44[1][l];
+						double fTemp31 = k.fSlow9 * fRec45[1][l];
+						double fTemp32 = 0.37 * (fRec3[0][l] - fRec4[0][l]);
+						double fTemp33 = fTemp32 + fTemp31;
+						fRec45[0][l] = fTemp33 - k.fSlow8 * fRec45[2][l];
+						double fTemp34 = k.fSlow8 * fRec45[0][l];
+						double fTemp35 = k.fSlow5 * (fRec45[2][l] + fTemp34 - fTemp33);
+						double fTemp36 = fTemp34 + fTemp32 + fRec45[2][l];
+						fRec44[0][l] = 0.5 * (fTemp36 - fTemp31 + fTemp35) + fTemp30 - k.fSlow3 * fRec44[2][l];
+						double fTemp37 = 0.5 * (fTemp36 + fTemp35 - fTemp31);
+						double fTemp38 = fRec44[2][l] + k.fSlow3 * fRec44[0][l];
+						out1[i0 * L + l] = (0.5 * fRec43[0][l] * (fTemp10 * fTemp28 + fTemp29 * (fTemp38 + fTemp37 + k.fSlow0 * (fTemp38 - (fTemp30 + fTemp37)) - fTemp30)));
+						fRec13[1][l] = fRec13[0][l];
+						fRec12[1][l] = fRec12[0][l];
+						fRec10[1][l] = fRec10[0][l];
+						fRec17[1][l] = fRec17[0][l];
+						fRec16[1][l] = fRec16[0][l];
+						fRec14[1][l] = fRec14[0][l];
+						fRec21[1][l] = fRec21[0][l];
+						fRec20[1][l] = fRec20[0][l];
+						fRec18[1][l] = fRec18[0][l];
+						fRec25[1][l] = fRec25[0][l];
+						fRec24[1][l] = fRec24[0][l];
+						fRec22[1][l] = fRec22[0][l];
+						fRec29[1][l] = fRec29[0][l];
+						fRec28[1][l] = fRec28[0][l];
+						fRec26[1][l] = fRec26[0][l];
+						fRec33[1][l] = fRec33[0][l];
+						fRec32[1][l] = fRec32[0][l];
+						fRec30[1][l] = fRec30[0][l];
+						fRec37[1][l] = fRec37[0][l];
+						fRec36[1][l] = fRec36[0][l];
+						fRec34[1][l] = fRec34[0][l];
+						fRec41[1][l] = fRec41[0][l];
+						fRec40[1][l] = fRec40[0][l];
+						fRec38[1][l] = fRec38[0][l];
+						fRec2[2][l] = fRec2[1][l];
+						fRec2[1][l] = fRec2[0][l];
+						fRec3[2][l] = fRec3[1][l];
+						fRec3[1][l] = fRec3[0][l];
+						fRec4[2][l] = fRec4[1][l];
+						fRec4[1][l] = fRec4[0][l];
+						fRec5[2][l] = fRec5[1][l];
+						fRec5[1][l] = fRec5[0][l];
+						fRec6[2][l] = fRec6[1][l];
+						fRec6[1][l] = fRec6[0][l];
+						fRec7[2][l] = fRec7[1][l];
+						fRec7[1][l] = fRec7[0][l];
+						fRec8[2][l] = fRec8[1][l];
+						fRec8[1][l] = fRec8[0][l];
+						fRec9[2][l] = fRec9[1][l];
+						fRec9[1][l] = fRec9[0][l];
+						fRec1[2][l] = fRec1[1][l];
+						fRec1[1][l] = fRec1[0][l];
+						fRec0[2][l] = fRec0[1][l];
+						fRec0[1][l] = fRec0[0][l];
+						fRec42[1][l] = fRec42[0][l];
+						fRec43[1][l] = fRec43[0][l];
+						fRec45[2][l] = fRec45[1][l];
+						fRec45[1][l] = fRec45[0][l];
+						fRec44[2][l] = fRec44[1][l];
+						fRec44[1][l] = fRec44[0][l];
+				}
+				IOTA0 = IOTA0 + 1;
+				if (RAMP)
+					k.step(dk);
+			}
+			for (int l = 0; l < L; l++) {
+				for (int i0 = 0; i0 < n; i0++) {
+					outputs[l][c0 + i0] = FAUSTFLOAT(out0[i0 * L + l]);
+					outputs[L + l][c0 + i0] = FAUSTFLOAT(out1[i0 * L + l]);
+				}
+			}
+		}
+	}
+};
+
 /***************************END USER SECTION ***************************/
 
 
@@ -1233,7 +1860,7 @@ struct ZITAREV {
     MYFLT* ain[ZITAREV_INPUTS];
     void* ctrls[22];                      // alternate Stringparam, kparamvalue
     zitarev_dsp* DSP;                     //
-    AUXCH     dspmem;                     // aux memory allocated once to store the DSP object
+    AUXCH     dspmem;                     // aux memory for the DSP object and its delay lines
     int ctrlindexes[11];
     int numargs;
 };
@@ -1270,38 +1897,30 @@ static int _key_to_index(char *key, const char **options) {
 }
 
 
-static int zitarev_init(CSOUND *csound, ZITAREV *p) {
-    if (p->dspmem.auxp == NULL)
-        csound->AuxAlloc(csound, sizeof(zitarev_dsp), &p->dspmem);
-
-    p->DSP = new (p->dspmem.auxp) zitarev_dsp;
-    if (p->DSP == 0) return NOTOK;
-    p->DSP->init((int)_GetLocalSr(csound, &(p->h)));
-
-    int numargs = _GetInputArgCnt(csound, p) - 2;
+// Checks the key/value pairs of zitarev (ctrls) and puts the index of the
+// parameter set by each pair in ctrlindexes
+static int zitarev_parse_args(CSOUND *csound, void **ctrls, int numargs, int *ctrlindexes) {
     if(numargs % 2) {
         INITERRF("Expected even number of arguments, got %d\n", numargs);
         return NOTOK;
     }
-    p->numargs = numargs;
-
     STRINGDAT *key;
     CS_TYPE *cstype;
     if(numargs > 0) {
         for(int i=0; i < numargs / 2; i++) {
-            cstype = _GetTypeForArg(csound, p->ctrls[i*2]);
+            cstype = _GetTypeForArg(csound, ctrls[i*2]);
             if(cstype->varTypeName[0] != 'S') {
                 INITERRF("Expected a string for arg %d, got %s\n", i + 2, cstype->varTypeName);
                 return NOTOK;
             }
-            key = (STRINGDAT*)(p->ctrls[i*2]);
+            key = (STRINGDAT*)(ctrls[i*2]);
             int paramindex = _key_to_index(key->data, zitarev_params);
             if(paramindex < 0) {
                 INITERRF("Unknown parmeter %s. Possible parameters: %s", key->data, _params_list(zitarev_params, &_zitarev_params_list));
                 return NOTOK;
             }
-            p->ctrlindexes[i] = paramindex;
-            cstype = _GetTypeForArg(csound, p->ctrls[i*2+1]);
+            ctrlindexes[i] = paramindex;
+            cstype = _GetTypeForArg(csound, ctrls[i*2+1]);
             char typechar = cstype->varTypeName[0];
             if(typechar != 'c' && typechar != 'k' && typechar != 'i') {
                 INITERRF("Value for key '%s' must be a scalar (a constant or an i- or k- var)"
@@ -1314,22 +1933,189 @@ static int zitarev_init(CSOUND *csound, ZITAREV *p) {
 }
 
 
-static int32_t zitarev_perf(CSOUND *csound, ZITAREV *p) {
-    AVOIDDENORMALS;
-    int numpairs = p->numargs / 2;
-    zitarev_dsp *dsp = (zitarev_dsp *)(p->DSP);
+static inline void zitarev_set_params(zitarev_dsp *dsp, void **ctrls, int *ctrlindexes, int numpairs) {
     FAUSTFLOAT *slots = &(dsp->params[0]);
     for(int i = 0; i < numpairs; i++) {
-        MYFLT value = *(MYFLT *)(p->ctrls[i * 2 + 1]);
-        int index = p->ctrlindexes[i];
+        MYFLT value = *(MYFLT *)(ctrls[i * 2 + 1]);
+        int index = ctrlindexes[i];
         slots[index] = value;
     }
-    
+}
+
+
+static int zitarev_init(CSOUND *csound, ZITAREV *p) {
+    // The dsp object and its delay lines share one block, sized for the sample
+    // rate. A new block comes zeroed from AuxAlloc, the lines need no clearing
+    int sr = (int)_GetLocalSr(csound, &(p->h));
+    size_t size = zitarev_dsp::memorySize(sr);
+    bool zeroed = false;
+    if (p->dspmem.auxp == NULL || p->dspmem.size != size) {
+        csound->AuxAlloc(csound, size, &p->dspmem);
+        zeroed = true;
+    }
+
+    p->DSP = new (p->dspmem.auxp) zitarev_dsp;
+    if (p->DSP == 0) return NOTOK;
+    p->DSP->setDelayMemory(p->dspmem.auxp, zeroed);
+    p->DSP->init(sr);
+
+    int numargs = _GetInputArgCnt(csound, p) - 2;
+    if(zitarev_parse_args(csound, p->ctrls, numargs, p->ctrlindexes) == NOTOK)
+        return NOTOK;
+    p->numargs = numargs;
+    return OK;
+}
+
+
+static int32_t zitarev_perf(CSOUND *csound, ZITAREV *p) {
+    AVOIDDENORMALS;
+    zitarev_set_params(p->DSP, p->ctrls, p->ctrlindexes, p->numargs / 2);
     p->DSP->compute(_GetLocalKsmps(csound, &(p->h)), p->ain, p->aout);
     return OK;
 }
 
 
+/*
+ * aOutL[], aOutR[] zitarev aInL[], aInR[], [Sparam, kvalue, ...]
+ *
+ * One reverb per element of the input arrays, all with the same settings. The
+ * instances are run in groups of ZITAREV_LANES, each group processed at once
+ * by a zitarev_lanes_dsp. The instances left over are split into smaller groups,
+ * each a power of two, down to a single zitarev_dsp
+ */
+
+#if defined(__AVX512F__)
+#define ZITAREV_LANES 8
+#else
+#define ZITAREV_LANES 4
+#endif
+
+struct zitarev_group {
+    zitarev_dsp *dsp;
+    int lanes;                            // number of instances in the group
+    int first;                            // index of its first instance
+};
+
+struct ZITAREV_ARR {
+    OPDS h;
+    ARRAYDAT* aout[ZITAREV_OUTPUTS];
+    ARRAYDAT* ain[ZITAREV_INPUTS];
+    void* ctrls[22];
+    AUXCH dspmem;                         // the DSP objects, each followed by its delay lines
+    AUXCH groupsmem;
+    zitarev_group *groups;
+    int numgroups;
+    int ctrlindexes[11];
+    int numargs;
+};
+
+
+// Size of the memory of a group, rounded to keep the next one aligned
+static size_t zitarev_group_size(int lanes, int sr) {
+    size_t size;
+    switch(lanes) {
+    case 2: size = zitarev_lanes_dsp<2>::memorySize(sr); break;
+    case 4: size = zitarev_lanes_dsp<4>::memorySize(sr); break;
+#if ZITAREV_LANES == 8
+    case 8: size = zitarev_lanes_dsp<8>::memorySize(sr); break;
+#endif
+    default: size = zitarev_dsp::memorySize(sr); break;
+    }
+    return (size + 63) & ~(size_t)63;
+}
+
+
+static zitarev_dsp *zitarev_group_new(int lanes, void *mem) {
+    switch(lanes) {
+    case 2: return new (mem) zitarev_lanes_dsp<2>;
+    case 4: return new (mem) zitarev_lanes_dsp<4>;
+#if ZITAREV_LANES == 8
+    case 8: return new (mem) zitarev_lanes_dsp<8>;
+#endif
+    default: return new (mem) zitarev_dsp;
+    }
+}
+
+
+static int zitarev_arr_init(CSOUND *csound, ZITAREV_ARR *p) {
+    CHECKARR1D(p->ain[0]);
+    CHECKARR1D(p->ain[1]);
+    int numinstances = p->ain[0]->sizes[0];
+    if(p->ain[1]->sizes[0] != numinstances)
+        return INITERRF("The input arrays should have the same size, got %d and %d",
+                        numinstances, p->ain[1]->sizes[0]);
+    if(numinstances < 1)
+        return INITERR("The input arrays are empty");
+
+    int numargs = _GetInputArgCnt(csound, p) - 2;
+    if(zitarev_parse_args(csound, p->ctrls, numargs, p->ctrlindexes) == NOTOK)
+        return NOTOK;
+    p->numargs = numargs;
+
+    int numgroups = numinstances / ZITAREV_LANES;
+    for(int lanes = ZITAREV_LANES / 2; lanes >= 1; lanes /= 2) {
+        if(numinstances & lanes)
+            numgroups++;
+    }
+    csound->AuxAlloc(csound, sizeof(zitarev_group) * numgroups, &p->groupsmem);
+    p->groups = (zitarev_group *)p->groupsmem.auxp;
+    p->numgroups = numgroups;
+
+    int sr = (int)_GetLocalSr(csound, &(p->h));
+    size_t size = 0;
+    int first = 0;
+    for(int i = 0; i < numgroups; i++) {
+        int lanes = ZITAREV_LANES;
+        while(lanes > numinstances - first)
+            lanes /= 2;
+        p->groups[i].lanes = lanes;
+        p->groups[i].first = first;
+        first += lanes;
+        size += zitarev_group_size(lanes, sr);
+    }
+
+    // As with zitarev, a new block comes zeroed and the lines need no clearing
+    bool zeroed = false;
+    if (p->dspmem.auxp == NULL || p->dspmem.size != size) {
+        csound->AuxAlloc(csound, size, &p->dspmem);
+        zeroed = true;
+    }
+    char *mem = (char *)p->dspmem.auxp;
+    for(int i = 0; i < numgroups; i++) {
+        zitarev_group *g = &(p->groups[i]);
+        g->dsp = zitarev_group_new(g->lanes, mem);
+        g->dsp->setDelayMemory(mem, zeroed);
+        g->dsp->init(sr);
+        mem += zitarev_group_size(g->lanes, sr);
+    }
+
+    tabinit_compat(csound, p->aout[0], numinstances, &(p->h));
+    tabinit_compat(csound, p->aout[1], numinstances, &(p->h));
+    return OK;
+}
+
+
+static int32_t zitarev_arr_perf(CSOUND *csound, ZITAREV_ARR *p) {
+    AVOIDDENORMALS;
+    const int ksmps = _GetLocalKsmps(csound, &(p->h));
+    MYFLT *ins[ZITAREV_INPUTS * ZITAREV_LANES];
+    MYFLT *outs[ZITAREV_OUTPUTS * ZITAREV_LANES];
+    for(int i = 0; i < p->numgroups; i++) {
+        zitarev_group *g = &(p->groups[i]);
+        for(int l = 0; l < g->lanes; l++) {
+            const int offset = (g->first + l) * ksmps;
+            ins[l] = p->ain[0]->data + offset;
+            ins[g->lanes + l] = p->ain[1]->data + offset;
+            outs[l] = p->aout[0]->data + offset;
+            outs[g->lanes + l] = p->aout[1]->data + offset;
+        }
+        zitarev_set_params(g->dsp, p->ctrls, p->ctrlindexes, p->numargs / 2);
+        g->dsp->compute(ksmps, ins, outs);
+    }
+    return OK;
+}
+
+
 // -------------------------------------------------------------
 
 class fofcycle_dspSIG0 {
@@ -1404,6 +2190,12 @@ class fofcycle_dsp : public dsp {
     FAUSTFLOAT param_gate;
     FAUSTFLOAT param_freq;
 	FAUSTFLOAT param_gain;
+	// The bend and the attack are the only controls needing pow/exp, computed
+	// when they change
+	faust_controls<1> fBendSeen;
+	faust_controls<1> fAttackSeen;
+	float fSlowBend;
+	float fSlowAttack;
 
     FAUSTFLOAT params[8];
 
@@ -1503,11 +2295,17 @@ class fofcycle_dsp : public dsp {
 	virtual int getNumInputs() { return 0; }
 	virtual int getNumOutputs() { return 1; }
 
+	// The sine table is shared by all instances and does not depend on the sample
+	// rate, so it is filled once, by the first instance. call_once makes
+	// concurrent inits (-j) wait for it instead of writing the table at the same time
 	static void classInit(int sample_rate) {
-		fofcycle_dspSIG0* sig0 = new_fofcycle_dspSIG0();
-		sig0->instanceInit_dspSIG0(sample_rate);
-		sig0->fill_dspSIG0(65536, fofcycle_ftbl0dspSIG0);
-		delete_fofcycle_dspSIG0(sig0);
+		static std::once_flag filled;
+		std::call_once(filled, [sample_rate]() {
+			fofcycle_dspSIG0* sig0 = new_fofcycle_dspSIG0();
+			sig0->instanceInit_dspSIG0(sample_rate);
+			sig0->fill_dspSIG0(65536, fofcycle_ftbl0dspSIG0);
+			delete_fofcycle_dspSIG0(sig0);
+		});
 	}
 
 	virtual void instanceConstants(int sample_rate) {
@@ -1535,6 +2333,8 @@ class fofcycle_dsp : public dsp {
 	}
 
 	virtual void instanceClear() {
+		fBendSeen.invalidate();
+		fAttackSeen.invalidate();
 		for (int l2 = 0; l2 < 2; l2 = l2 + 1) {
 			iVec1[l2] = 0;
 		}
@@ -1772,13 +2572,20 @@ class fofcycle_dsp : public dsp {
 	virtual void buildUserInterface(UI* ui_interface) { IGN(ui_interface); }
 
 	virtual void compute(int count, FAUSTFLOAT** RESTRICT inputs, FAUSTFLOAT** RESTRICT outputs) {
+		computeBlock(count, inputs, outputs);
+	}
+
+	POODLE_MULTIVERSION
+	void computeBlock(int count, FAUSTFLOAT** RESTRICT inputs, FAUSTFLOAT** RESTRICT outputs) {
 		IGN(inputs);
 		FAUSTFLOAT* output0 = outputs[0];
 		float fSlow0 = fConst1 * float(params[FOFCYCLE_VIBFREQ]);
 		float fSlow1 = 0.1f * float(params[FOFCYCLE_VIBGAIN]);
 		float fSlow2 = std::min<float>(1.0f, float(params[FOFCYCLE_SUSTAIN]) + float(param_gate));
 		int iSlow3 = fSlow2 == 0.0f;
-		float fSlow4 = std::pow(2.0f, 0.083333336f * float(params[FOFCYCLE_BEND]));
+		if (fBendSeen.changed(&params[FOFCYCLE_BEND]))
+			fSlowBend = std::pow(2.0f, 0.083333336f * float(params[FOFCYCLE_BEND]));
+		float fSlow4 = fSlowBend;
 		float fSlow5 = float(param_freq);
 		float fSlow6 = fConst1 * fSlow5;
 		float fSlow7 = fConst2 * float(params[FOFCYCLE_VOWEL]);
@@ -1796,7 +2603,9 @@ class fofcycle_dsp : public dsp {
 		float fSlow19 = 2.0f * fSlow5;
 		float fSlow20 = 0.001f * float(params[FOFCYCLE_ENVATTACK]);
 		int iSlow21 = std::fabs(fSlow20) < 1.1920929e-07f;
-		float fSlow22 = ((iSlow21) ? 0.0f : std::exp(-(fConst1 / ((iSlow21) ? 1.0f : fSlow20))));
+		if (fAttackSeen.changed(&params[FOFCYCLE_ENVATTACK]))
+			fSlowAttack = ((iSlow21) ? 0.0f : std::exp(-(fConst1 / ((iSlow21) ? 1.0f : fSlow20))));
+		float fSlow22 = fSlowAttack;
 		float fSlow23 = 75.0f * fSlow2 * float(param_gain) * (1.0f - fSlow22);
 		float fSlow24 = float(params[FOFCYCLE_OUTGAIN]);
 		for (int i0 = 0; i0 < count; i0 = i0 + 1) {
@@ -2135,6 +2944,486 @@ class fofcycle_dsp : public dsp {
 };
 
 
+// A bank of fofcycle voices sharing their controls (params), each voice with
+// its own gate, freq and gain. The output is the sum of the voices.
+//
+// The formants (frequency, bandwidth and gain of each of the 5) depend only on
+// the vowel and the voicetype, so the bank has one vowel smoother and computes
+// them once per sample for all voices, FOFCYCLE_BANK_CHUNK samples at a time.
+// Formants 4 and 5 are then adjusted per voice by its pitch, as in fofcycle_dsp.
+//
+// The state of the voices is kept as arrays, one value per voice (see
+// fofcycle_bank_fields), and each step of the per-sample computation is a loop
+// over the voices. The bandwidths of a fof are held from the moment the fof
+// starts, so the coefficients of its filter are computed (two expf) only then.
+// The output of a voice is the same as that of a fofcycle_dsp started at the
+// same time with the same controls
+
+#define FOFCYCLE_BANK_CHUNK 64
+#define FOFCYCLE_BANK_FORMANTS 5
+// Each formant is made of 3 overlapping fofs, started in turn every period
+#define FOFCYCLE_BANK_FOFS 3
+
+enum fofcycle_bank_fields {
+	// per voice
+	FOFBANK_VIBPHASE,		// vibrato phase (fRec3)
+	FOFBANK_LASTGATE,		// gate + sustain of the previous sample (fVec2)
+	FOFBANK_BEND,			// smoothed bend (fRec4)
+	FOFBANK_PHASE,			// phase of the fundamental (fRec2)
+	FOFBANK_COUNT,			// periods counter, selects the fof to start (fRec5)
+	FOFBANK_ENV,			// envelope (fRec66)
+	FOFBANK_START1,			// fof started one sample ago, one per fof (fVec3-5[1])
+	FOFBANK_START2 = FOFBANK_START1 + FOFCYCLE_BANK_FOFS,	// ... two samples ago (fVec3-5[2])
+	// per voice, set for each block
+	FOFBANK_GATE = FOFBANK_START2 + FOFCYCLE_BANK_FOFS,		// gate + sustain (fSlow2)
+	FOFBANK_FREQ,			// fundamental (fSlow5)
+	FOFBANK_ENVTARGET,		// input of the envelope (fSlow23)
+	// per voice, set for each sample
+	FOFBANK_START,			// fof started at this sample, one per fof (fVec3-5[0])
+	FOFBANK_BWSCALE = FOFBANK_START + FOFCYCLE_BANK_FOFS,	// fTemp81
+	FOFBANK_GAIN,			// formant gain factor depending on the pitch (fTemp99/100)
+	FOFBANK_FREQ4,			// frequency of formant 4, adjusted by pitch (fTemp141)
+	FOFBANK_FREQ5,			// frequency of formant 5, adjusted by pitch (fTemp157)
+	FOFBANK_OUT,			// output of the voice, before the envelope
+	// per voice and fof, FOFBANK_FOF_FIELDS fields for each of the
+	// FOFCYCLE_BANK_FORMANTS * FOFCYCLE_BANK_FOFS fofs
+	FOFBANK_FOF,
+	FOFBANK_FIELDS = FOFBANK_FOF + 6 * FOFCYCLE_BANK_FORMANTS * FOFCYCLE_BANK_FOFS
+};
+
+// Fields of a fof, relative to its first field
+enum {
+	FOF_PHASE,		// phase of the sine (fRec1, fRec10, ...)
+	FOF_A1,			// filter coefficients, from the held bandwidths
+	FOF_A2,
+	FOF_AMP,		// amplitude of the sine, from the held bandwidths
+	FOF_Y1,			// filter state (fRec9[1], fRec9[2], ...)
+	FOF_Y2,
+	FOF_FIELDS
+};
+
+
+class fofcycle_bank_dsp {
+ public:
+	FAUSTFLOAT params[8];
+	faust_controls<1> fBendSeen;
+	faust_controls<1> fAttackSeen;
+	float fSlowBend;
+	float fSlowAttack;
+
+	int fSampleRate;
+	float fConst0;
+	float fConst1;
+	float fConst2;
+	float fConst3;
+	float fConst4;
+	int iVec1[2];
+	float fRec6[2];
+
+	// The formants for each sample of a chunk: frequencies (of formant 1 to 3
+	// in cycles per sample, of 4 and 5 in Hz, before their adjustment by pitch),
+	// bandwidths and gains (formant 5 has none)
+	float fFormantFreq[FOFCYCLE_BANK_FORMANTS][FOFCYCLE_BANK_CHUNK];
+	float fFormantBw[FOFCYCLE_BANK_FORMANTS][FOFCYCLE_BANK_CHUNK];
+	float fFormantGain[FOFCYCLE_BANK_FORMANTS - 1][FOFCYCLE_BANK_CHUNK];
+	// The bandwidth scaling (fTemp81) is fBwScale + fBwScaleRange * x, where
+	// x (0-1) depends on the pitch of the voice
+	float fBwScale[FOFCYCLE_BANK_CHUNK];
+	float fBwScaleRange[FOFCYCLE_BANK_CHUNK];
+
+	int iVoices;
+	// Size of each field, voices rounded up to a multiple of 8 (a register of
+	// AVX floats). The voices added are silent
+	int iStride;
+	float *fVoices;
+
+	fofcycle_bank_dsp() : iVoices(0), iStride(0), fVoices(NULL) {}
+
+	static int stride(int voices) {
+		return (voices + 7) & ~7;
+	}
+
+	static size_t objectSize() {
+		return (sizeof(fofcycle_bank_dsp) + 63) & ~(size_t)63;
+	}
+
+	// Size of the object followed by the state of the voices
+	static size_t memorySize(int voices) {
+		return objectSize() + (size_t)FOFBANK_FIELDS * stride(voices) * sizeof(float);
+	}
+
+	// mem: a block of memorySize(voices) bytes starting with this object
+	void setVoices(void *mem, int voices) {
+		iVoices = voices;
+		iStride = stride(voices);
+		fVoices = (float *)((char *)mem + objectSize());
+	}
+
+	float *field(int index) {
+		return fVoices + (size_t)index * iStride;
+	}
+
+	float *fof(int formant, int f) {
+		return field(FOFBANK_FOF + (formant * FOFCYCLE_BANK_FOFS + f) * FOF_FIELDS);
+	}
+
+	void init(int sample_rate) {
+		fofcycle_dsp::classInit(sample_rate);
+		instanceConstants(sample_rate);
+		instanceResetUserInterface();
+		instanceClear();
+	}
+
+	void instanceConstants(int sample_rate) {
+		fSampleRate = sample_rate;
+		fConst0 = std::min<float>(1.92e+05f, std::max<float>(1.0f, float(fSampleRate)));
+		fConst1 = 1.0f / fConst0;
+		fConst2 = 44.1f / fConst0;
+		fConst3 = 1.0f - fConst2;
+		fConst4 = 3.1415927f / fConst0;
+	}
+
+	void instanceResetUserInterface() {
+		params[FOFCYCLE_VIBFREQ] = 6.0f;
+		params[FOFCYCLE_VIBGAIN] = 0.5f;
+		params[FOFCYCLE_SUSTAIN] = 0.f;
+		params[FOFCYCLE_BEND] = 0.f;
+		params[FOFCYCLE_VOWEL] = 0.;
+		params[FOFCYCLE_VOICETYPE] = 0.;
+		params[FOFCYCLE_ENVATTACK] = 10;
+		params[FOFCYCLE_OUTGAIN] = 0.5;
+	}
+
+	void instanceClear() {
+		fBendSeen.invalidate();
+		fAttackSeen.invalidate();
+		iVec1[0] = iVec1[1] = 0;
+		fRec6[0] = fRec6[1] = 0.0f;
+		memset(fVoices, 0, (size_t)FOFBANK_FIELDS * iStride * sizeof(float));
+		// The held bandwidths start at 0, for which both decays (exp(-0)) are 1
+		for (int formant = 0; formant < FOFCYCLE_BANK_FORMANTS; formant++) {
+			for (int f = 0; f < FOFCYCLE_BANK_FOFS; f++) {
+				float *s = fof(formant, f);
+				for (int v = 0; v < iStride; v++) {
+					s[FOF_A1 * iStride + v] = 2.0f;
+					s[FOF_A2 * iStride + v] = 1.0f;
+				}
+			}
+		}
+	}
+
+	// gates, freqs, gains: one value per voice
+	void compute(int count, const FAUSTFLOAT *gates, const FAUSTFLOAT *freqs,
+				 const FAUSTFLOAT *gains, FAUSTFLOAT *output) {
+		if (fBendSeen.changed(&params[FOFCYCLE_BEND]))
+			fSlowBend = std::pow(2.0f, 0.083333336f * float(params[FOFCYCLE_BEND]));
+		float fSlow20 = 0.001f * float(params[FOFCYCLE_ENVATTACK]);
+		int iSlow21 = std::fabs(fSlow20) < 1.1920929e-07f;
+		if (fAttackSeen.changed(&params[FOFCYCLE_ENVATTACK]))
+			fSlowAttack = ((iSlow21) ? 0.0f : std::exp(-(fConst1 / ((iSlow21) ? 1.0f : fSlow20))));
+		float fSlow22 = fSlowAttack;
+		float *gate = field(FOFBANK_GATE);
+		float *freq = field(FOFBANK_FREQ);
+		float *envtarget = field(FOFBANK_ENVTARGET);
+		for (int v = 0; v < iVoices; v++) {
+			gate[v] = std::min<float>(1.0f, float(params[FOFCYCLE_SUSTAIN]) + float(gates[v]));
+			freq[v] = float(freqs[v]);
+			envtarget[v] = 75.0f * gate[v] * float(gains[v]) * (1.0f - fSlow22);
+		}
+		for (int i = 0; i < count; i += FOFCYCLE_BANK_CHUNK) {
+			int n = std::min<int>(FOFCYCLE_BANK_CHUNK, count - i);
+			computeFormants(n);
+			computeChunk(n, output + i);
+		}
+	}
+
+	// Fills the formants for the next count samples (count <= FOFCYCLE_BANK_CHUNK)
+	void computeFormants(int count) {
+		float fSlow7 = fConst2 * float(params[FOFCYCLE_VOWEL]);
+		float fSlow8 = float(params[FOFCYCLE_VOICETYPE]);
+		float fSlow9 = 5.0f * fSlow8;
+		float fSlow10 = 5.0f * (1.0f - fSlow8);
+		int iSlow11 = ((fSlow8 == 0.0f) ? 1 : ((fSlow8 == 3.0f) ? 1 : 0));
+		float fSlow16 = float(5 * iSlow11);
+		for (int i0 = 0; i0 < count; i0 = i0 + 1) {
+			fRec6[0] = fSlow7 + fConst3 * fRec6[1];
+			float fTemp8 = fSlow9 + fRec6[0];
+			int iTemp9 = fTemp8 < 23.0f;
+			int iTemp10 = fTemp8 < 24.0f;
+			float fTemp11 = fSlow9 + fRec6[0] + -23.0f;
+			int iTemp12 = fTemp8 < 22.0f;
+			float fTemp13 = fSlow9 + fRec6[0] + -22.0f;
+			int iTemp14 = fTemp8 < 21.0f;
+			float fTemp15 = fSlow9 + fRec6[0] + -21.0f;
+			int iTemp16 = fTemp8 < 2e+01f;
+			float fTemp17 = fSlow9 + fRec6[0] + -2e+01f;
+			int iTemp18 = fTemp8 < 19.0f;
+			float fTemp19 = fSlow9 + fRec6[0] + -19.0f;
+			int iTemp20 = fTemp8 < 18.0f;
+			int iTemp21 = fTemp8 < 17.0f;
+			int iTemp22 = fTemp8 < 16.0f;
+			int iTemp23 = fTemp8 < 15.0f;
+			int iTemp24 = fTemp8 < 14.0f;
+			float fTemp25 = fSlow9 + fRec6[0] + -14.0f;
+			int iTemp26 = fTemp8 < 13.0f;
+			float fTemp27 = fSlow9 + fRec6[0] + -13.0f;
+			int iTemp28 = fTemp8 < 12.0f;
+			float fTemp29 = fSlow9 + fRec6[0] + -12.0f;
+			int iTemp30 = fTemp8 < 11.0f;
+			float fTemp31 = fSlow9 + fRec6[0] + -11.0f;
+			int iTemp32 = fTemp8 < 1e+01f;
+			float fTemp33 = fSlow9 + fRec6[0] + -1e+01f;
+			float fTemp34 = 5e+01f * fTemp33;
+			int iTemp35 = fTemp8 < 9.0f;
+			float fTemp36 = fSlow9 + fRec6[0] + -9.0f;
+			int iTemp37 = fTemp8 < 8.0f;
+			float fTemp38 = fSlow9 + fRec6[0] + -8.0f;
+			float fTemp39 = 5e+01f * fTemp38;
+			int iTemp40 = fTemp8 < 7.0f;
+			float fTemp41 = fSlow9 + fRec6[0] + -7.0f;
+			int iTemp42 = fTemp8 < 6.0f;
+			float fTemp43 = fSlow9 + fRec6[0] + -6.0f;
+			int iTemp44 = fTemp8 < 5.0f;
+			float fTemp45 = fRec6[0] - fSlow10;
+			float fTemp46 = 3.5e+02f * fTemp45;
+			int iTemp47 = fTemp8 < 4.0f;
+			float fTemp48 = fSlow9 + fRec6[0] + -4.0f;
+			float fTemp49 = fConst1 * ((iTemp9) ? ((iTemp12) ? ((iTemp14) ? ((iTemp16) ? ((iTemp18) ? ((iTemp20) ? ((iTemp21) ? ((iTemp22) ? ((iTemp23) ? ((iTemp24) ? ((iTemp26) ? ((iTemp28) ? ((iTemp30) ? ((iTemp32) ? ((iTemp35) ? ((iTemp37) ? ((iTemp40) ? ((iTemp42) ? ((iTemp44) ? ((iTemp47) ? 4.95e+03f : ((iTemp44) ? 4.95e+03f - 2.2e+03f * fTemp48 : 2.75e+03f)) : ((iTemp42) ? fTemp46 + 2.75e+03f : 3.1e+03f)) : ((iTemp40) ? 2.4e+02f * fTemp43 + 3.1e+03f : 3.34e+03f)) : ((iTemp37) ? 3.34e+03f - 4.4e+02f * fTemp41 : 2.9e+03f)) : ((iTemp35) ? fTemp39 + 2.9e+03f : 2.95e+03f)) : ((iTemp32) ? 4e+02f * fTemp36 + 2.95e+03f : 3.35e+03f)) : ((iTemp30) ? 3.35e+03f - fTemp34 : 3.3e+03f)) : ((iTemp28) ? 2.9e+02f * fTemp31 + 3.3e+03f : 3.59e+03f)) : ((iTemp26) ? 3.59e+03f - 2.9e+02f * fTemp29 : 3.3e+03f)) : ((iTemp24) ? 1e+02f * fTemp27 + 3.3e+03f : 3.4e+03f)) : ((iTemp23) ? 1.55e+03f * fTemp25 + 3.4e+03f : 4.95e+03f)) : 4.95e+03f) : 4.95e+03f) : 4.95e+03f) : 4.95e+03f) : ((iTemp16) ? 4.95e+03f - 1.7e+03f * fTemp19 : 3.25e+03f)) : ((iTemp14) ? 3.3e+02f * fTemp17 + 3.25e+03f : 3.58e+03f)) : ((iTemp12) ? 3.58e+03f - 4e+01f * fTemp15 : 3.54e+03f)) : ((iTemp9) ? 3.54e+03f - 5.4e+02f * fTemp13 : 3e+03f)) : ((iTemp10) ? 3e+02f * fTemp11 + 3e+03f : 3.3e+03f));
+			float fTemp52 = 2e+01f * fTemp17;
+			float fTemp53 = fSlow9 + fRec6[0] + -18.0f;
+			float fTemp54 = fSlow9 + fRec6[0] + -16.0f;
+			float fTemp55 = 8e+01f * fTemp54;
+			float fTemp56 = fSlow9 + fRec6[0] + -15.0f;
+			float fTemp57 = 2e+01f * fTemp25;
+			float fTemp58 = 2e+01f * fTemp33;
+			float fTemp59 = 2e+01f * fTemp36;
+			float fTemp60 = fSlow10 - fRec6[0];
+			float fTemp61 = 1e+01f * fTemp60;
+			int iTemp62 = fTemp8 < 3.0f;
+			float fTemp63 = fSlow9 + fRec6[0] + -3.0f;
+			int iTemp64 = fTemp8 < 2.0f;
+			float fTemp65 = fSlow9 + fRec6[0] + -2.0f;
+			int iTemp66 = fTemp8 < 1.0f;
+			int iTemp67 = fTemp8 < 0.0f;
+			float fTemp68 = ((iTemp9) ? ((iTemp12) ? ((iTemp14) ? ((iTemp16) ? ((iTemp18) ? ((iTemp20) ? ((iTemp21) ? ((iTemp22) ? ((iTemp23) ? ((iTemp24) ? ((iTemp26) ? ((iTemp28) ? ((iTemp30) ? ((iTemp32) ? ((iTemp35) ? ((iTemp37) ? ((iTemp40) ? ((iTemp42) ? ((iTemp44) ? ((iTemp47) ? ((iTemp62) ? ((iTemp64) ? ((iTemp66) ? ((iTemp67) ? 1.4e+02f : ((iTemp66) ? 6e+01f * fTemp8 + 1.4e+02f : 2e+02f)) : 2e+02f) : ((iTemp62) ? 2e+02f - 65.0f * fTemp65 : 135.0f)) : ((iTemp47) ? 65.0f * fTemp63 + 135.0f : 2e+02f)) : ((iTemp44) ? 2e+02f - 7e+01f * fTemp48 : 1.3e+02f)) : ((iTemp42) ? fTemp61 + 1.3e+02f : 1.2e+02f)) : 1.2e+02f) : 1.2e+02f) : 1.2e+02f) : ((iTemp32) ? fTemp59 + 1.2e+02f : 1.4e+02f)) : ((iTemp30) ? 1.4e+02f - fTemp58 : 1.2e+02f)) : 1.2e+02f) : 1.2e+02f) : 1.2e+02f) : ((iTemp23) ? fTemp57 + 1.2e+02f : 1.4e+02f)) : ((iTemp22) ? 6e+01f * fTemp56 + 1.4e+02f : 2e+02f)) : ((iTemp21) ? 2e+02f - fTemp55 : 1.2e+02f)) : 1.2e+02f) : ((iTemp18) ? 8e+01f * fTemp53 + 1.2e+02f : 2e+02f)) : ((iTemp16) ? 2e+02f - 6e+01f * fTemp19 : 1.4e+02f)) : ((iTemp14) ? 1.4e+02f - fTemp52 : 1.2e+02f)) : 1.2e+02f) : ((iTemp9) ? 15.0f * fTemp13 + 1.2e+02f : 135.0f)) : ((iTemp10) ? 135.0f - 15.0f * fTemp11 : 1.2e+02f));
+			float fTemp71 = fRec6[0] + fSlow16;
+			int iTemp72 = fTemp71 >= 5.0f;
+			int iTemp73 = fTemp71 >= 3.0f;
+			int iTemp74 = fTemp71 >= 2.0f;
+			int iTemp75 = fTemp71 >= 1.0f;
+			int iTemp76 = fTemp71 >= 4.0f;
+			int iTemp77 = fTemp71 >= 8.0f;
+			int iTemp78 = fTemp71 >= 7.0f;
+			int iTemp79 = fTemp71 >= 6.0f;
+			float fTemp80 = ((iTemp72) ? ((iTemp77) ? 2.0f : ((iTemp78) ? 3.0f : ((iTemp79) ? 3.0f : 2.0f))) : ((iTemp73) ? ((iTemp76) ? 1.5f : 1.0f) : ((iTemp74) ? 1.25f : ((iTemp75) ? 1.25f : 1.0f))));
+			float fTemp96 = fSlow9 + fRec6[0] + -17.0f;
+			float fTemp97 = ((iTemp28) ? 0.1f - 0.084151f * fTemp31 : 0.015849f);
+			float fTemp98 = ((iTemp9) ? ((iTemp12) ? ((iTemp14) ? ((iTemp16) ? ((iTemp18) ? ((iTemp20) ? ((iTemp21) ? ((iTemp22) ? ((iTemp23) ? ((iTemp24) ? ((iTemp26) ? ((iTemp28) ? ((iTemp30) ? ((iTemp32) ? ((iTemp35) ? ((iTemp37) ? ((iTemp40) ? ((iTemp42) ? ((iTemp44) ? ((iTemp47) ? ((iTemp62) ? ((iTemp64) ? 0.001f : ((iTemp62) ? 0.000778f * fTemp65 + 0.001f : 0.001778f)) : ((iTemp47) ? 0.001778f - 0.001147f * fTemp63 : 0.000631f)) : ((iTemp44) ? 0.099369f * fTemp48 + 0.000631f : 0.1f)) : ((iTemp42) ? 0.025893f * fTemp45 + 0.1f : 0.125893f)) : ((iTemp40) ? 0.125893f - 0.086082f * fTemp43 : 0.039811f)) : ((iTemp37) ? 0.039811f - 0.029811f * fTemp41 : 0.01f)) : ((iTemp35) ? 0.005849f * fTemp38 + 0.01f : 0.015849f)) : ((iTemp32) ? 0.015849f - 0.00326f * fTemp36 : 0.012589f)) : ((iTemp30) ? 0.087411f * fTemp33 + 0.012589f : 0.1f)) : fTemp97) : ((iTemp26) ? 0.004104f * fTemp29 + 0.015849f : 0.019953f)) : 0.019953f) : ((iTemp23) ? 0.019953f - 0.016791f * fTemp25 : 0.003162f)) : ((iTemp22) ? 0.003162f - 0.001577f * fTemp56 : 0.001585f)) : ((iTemp21) ? 0.004725f * fTemp54 + 0.001585f : 0.00631f)) : ((iTemp20) ? 0.00631f - 0.003148f * fTemp96 : 0.003162f)) : ((iTemp18) ? 0.003162f - 0.002162f * fTemp53 : 0.001f)) : ((iTemp16) ? 0.078433f * fTemp19 + 0.001f : 0.079433f)) : ((iTemp14) ? 0.020567f * fTemp17 + 0.079433f : 0.1f)) : ((iTemp12) ? 0.1f - 0.068377f * fTemp15 : 0.031623f)) : ((iTemp9) ? 0.018496f * fTemp13 + 0.031623f : 0.050119f)) : 0.050119f);
+			float fTemp101 = 1e+02f * fTemp11;
+			float fTemp102 = fSlow9 + fRec6[0] + -1.0f;
+			float fTemp103 = fConst1 * ((iTemp9) ? ((iTemp12) ? ((iTemp14) ? ((iTemp16) ? ((iTemp18) ? ((iTemp20) ? ((iTemp21) ? ((iTemp22) ? ((iTemp23) ? ((iTemp24) ? ((iTemp26) ? ((iTemp28) ? ((iTemp30) ? ((iTemp32) ? ((iTemp35) ? ((iTemp37) ? ((iTemp40) ? ((iTemp42) ? ((iTemp44) ? ((iTemp47) ? ((iTemp62) ? ((iTemp64) ? ((iTemp66) ? ((iTemp67) ? 3.5e+03f : ((iTemp66) ? 3.5e+03f - 2e+02f * fTemp8 : 3.3e+03f)) : ((iTemp64) ? 4e+02f * fTemp102 + 3.3e+03f : 3.7e+03f)) : ((iTemp62) ? 3.7e+03f - 2e+02f * fTemp65 : 3.5e+03f)) : 3.5e+03f) : ((iTemp44) ? 3.5e+03f - 1.05e+03f * fTemp48 : 2.45e+03f)) : ((iTemp42) ? fTemp46 + 2.45e+03f : 2.8e+03f)) : ((iTemp40) ? 2.5e+02f * fTemp43 + 2.8e+03f : 3.05e+03f)) : ((iTemp37) ? 3.05e+03f - 4.5e+02f * fTemp41 : 2.6e+03f)) : ((iTemp35) ? 75.0f * fTemp38 + 2.6e+03f : 2675.0f)) : ((iTemp32) ? 325.0f * fTemp36 + 2675.0f : 3e+03f)) : 3e+03f) : ((iTemp28) ? 3.5e+02f * fTemp31 + 3e+03f : 3.35e+03f)) : ((iTemp26) ? 3.35e+03f - 3.5e+02f * fTemp29 : 3e+03f)) : 3e+03f) : ((iTemp23) ? 9e+02f * fTemp25 + 3e+03f : 3.9e+03f)) : ((iTemp22) ? 3.9e+03f - 3e+02f * fTemp56 : 3.6e+03f)) : ((iTemp21) ? 3e+02f * fTemp54 + 3.6e+03f : 3.9e+03f)) : ((iTemp20) ? 3.9e+03f - 1e+02f * fTemp96 : 3.8e+03f)) : 3.8e+03f) : ((iTemp16) ? 3.8e+03f - 9e+02f * fTemp19 : 2.9e+03f)) : ((iTemp14) ? 3e+02f * fTemp17 + 2.9e+03f : 3.2e+03f)) : ((iTemp12) ? 5e+01f * fTemp15 + 3.2e+03f : 3.25e+03f)) : ((iTemp9) ? 3.25e+03f - 4.5e+02f * fTemp13 : 2.8e+03f)) : ((iTemp10) ? fTemp101 + 2.8e+03f : 2.9e+03f));
+			float fTemp105 = 1e+01f * fTemp13;
+			float fTemp106 = 1e+01f * fTemp17;
+			float fTemp107 = 5e+01f * fTemp19;
+			float fTemp108 = 2e+01f * fTemp56;
+			float fTemp109 = 1e+01f * fTemp33;
+			float fTemp110 = 1e+01f * fTemp36;
+			float fTemp111 = 6e+01f * fTemp48;
+			float fTemp112 = 2e+01f * fTemp65;
+			float fTemp113 = 2e+01f * fTemp8;
+			float fTemp114 = ((iTemp9) ? ((iTemp12) ? ((iTemp14) ? ((iTemp16) ? ((iTemp18) ? ((iTemp20) ? ((iTemp21) ? ((iTemp22) ? ((iTemp23) ? ((iTemp24) ? ((iTemp26) ? ((iTemp28) ? ((iTemp30) ? ((iTemp32) ? ((iTemp35) ? ((iTemp37) ? ((iTemp40) ? ((iTemp42) ? ((iTemp44) ? ((iTemp47) ? ((iTemp62) ? ((iTemp64) ? ((iTemp66) ? ((iTemp67) ? 1.3e+02f : ((iTemp66) ? fTemp113 + 1.3e+02f : 1.5e+02f)) : 1.5e+02f) : ((iTemp62) ? 1.5e+02f - fTemp112 : 1.3e+02f)) : ((iTemp47) ? 5e+01f * fTemp63 + 1.3e+02f : 1.8e+02f)) : ((iTemp44) ? 1.8e+02f - fTemp111 : 1.2e+02f)) : 1.2e+02f) : 1.2e+02f) : 1.2e+02f) : 1.2e+02f) : ((iTemp32) ? fTemp110 + 1.2e+02f : 1.3e+02f)) : ((iTemp30) ? 1.3e+02f - fTemp109 : 1.2e+02f)) : 1.2e+02f) : 1.2e+02f) : 1.2e+02f) : ((iTemp23) ? 1e+01f * fTemp25 + 1.2e+02f : 1.3e+02f)) : ((iTemp22) ? fTemp108 + 1.3e+02f : 1.5e+02f)) : ((iTemp21) ? 1.5e+02f - 3e+01f * fTemp54 : 1.2e+02f)) : 1.2e+02f) : ((iTemp18) ? 6e+01f * fTemp53 + 1.2e+02f : 1.8e+02f)) : ((iTemp16) ? 1.8e+02f - fTemp107 : 1.3e+02f)) : ((iTemp14) ? 1.3e+02f - fTemp106 : 1.2e+02f)) : 1.2e+02f) : ((iTemp9) ? fTemp105 + 1.2e+02f : 1.3e+02f)) : ((iTemp10) ? 1.3e+02f - 1e+01f * fTemp11 : 1.2e+02f));
+			float fTemp124 = ((iTemp20) ? 0.029314f * fTemp96 + 0.050119f : 0.079433f);
+			float fTemp125 = ((iTemp9) ? ((iTemp12) ? ((iTemp14) ? ((iTemp16) ? ((iTemp18) ? ((iTemp20) ? ((iTemp21) ? ((iTemp22) ? ((iTemp23) ? ((iTemp24) ? ((iTemp26) ? ((iTemp28) ? ((iTemp30) ? ((iTemp32) ? ((iTemp35) ? ((iTemp37) ? ((iTemp40) ? ((iTemp42) ? ((iTemp44) ? ((iTemp47) ? ((iTemp62) ? ((iTemp64) ? ((iTemp66) ? ((iTemp67) ? 0.015849f : ((iTemp66) ? 0.001934f * fTemp8 + 0.015849f : 0.017783f)) : ((iTemp64) ? 0.017783f - 0.001934f * fTemp102 : 0.015849f)) : ((iTemp62) ? 0.023962f * fTemp65 + 0.015849f : 0.039811f)) : ((iTemp47) ? 0.039811f - 0.029811f * fTemp63 : 0.01f)) : ((iTemp44) ? 0.344813f * fTemp48 + 0.01f : 0.354813f)) : ((iTemp42) ? 0.103624f * fTemp60 + 0.354813f : 0.251189f)) : ((iTemp40) ? 0.251189f - 0.171756f * fTemp43 : 0.079433f)) : ((iTemp37) ? 0.020567f * fTemp41 + 0.079433f : 0.1f)) : ((iTemp35) ? 0.1f - 0.060189f * fTemp38 : 0.039811f)) : ((iTemp32) ? 0.023285f * fTemp36 + 0.039811f : 0.063096f)) : ((iTemp30) ? 0.036904f * fTemp33 + 0.063096f : 0.1f)) : fTemp97) : ((iTemp26) ? 0.063584f * fTemp29 + 0.015849f : 0.079433f)) : ((iTemp24) ? 0.079433f - 0.04781f * fTemp27 : 0.031623f)) : ((iTemp23) ? 0.068377f * fTemp25 + 0.031623f : 0.1f)) : ((iTemp22) ? 0.1f - 0.09f * fTemp56 : 0.01f)) : ((iTemp21) ? 0.040119f * fTemp54 + 0.01f : 0.050119f)) : fTemp124) : ((iTemp18) ? 0.079433f - 0.069433f * fTemp53 : 0.01f)) : ((iTemp16) ? 0.388107f * fTemp19 + 0.01f : 0.398107f)) : ((iTemp14) ? 0.398107f - 0.198581f * fTemp17 : 0.199526f)) : ((iTemp12) ? 0.199526f - 0.099526f * fTemp15 : 0.1f)) : ((iTemp9) ? 0.151189f * fTemp13 + 0.1f : 0.251189f)) : ((iTemp10) ? 0.251189f - 0.051663f * fTemp11 : 0.199526f));
+			float fTemp126 = fConst1 * ((iTemp9) ? ((iTemp12) ? ((iTemp14) ? ((iTemp16) ? ((iTemp18) ? ((iTemp20) ? ((iTemp21) ? ((iTemp22) ? ((iTemp23) ? ((iTemp24) ? ((iTemp26) ? ((iTemp28) ? ((iTemp30) ? ((iTemp32) ? ((iTemp35) ? ((iTemp37) ? ((iTemp40) ? ((iTemp42) ? ((iTemp44) ? ((iTemp47) ? ((iTemp62) ? ((iTemp64) ? ((iTemp66) ? ((iTemp67) ? 2.8e+03f : ((iTemp66) ? 2.8e+03f - 1e+02f * fTemp8 : 2.7e+03f)) : 2.7e+03f) : ((iTemp62) ? 1.3e+02f * fTemp65 + 2.7e+03f : 2.83e+03f)) : ((iTemp47) ? 2.83e+03f - 3e+02f * fTemp63 : 2.53e+03f)) : ((iTemp44) ? 2.53e+03f - 2.8e+02f * fTemp48 : 2.25e+03f)) : ((iTemp42) ? 1.5e+02f * fTemp45 + 2.25e+03f : 2.4e+03f)) : ((iTemp40) ? 2e+02f * fTemp43 + 2.4e+03f : 2.6e+03f)) : ((iTemp37) ? 2.6e+03f - 2e+02f * fTemp41 : 2.4e+03f)) : 2.4e+03f) : ((iTemp32) ? 3.5e+02f * fTemp36 + 2.4e+03f : 2.75e+03f)) : ((iTemp30) ? 2.75e+03f - fTemp34 : 2.7e+03f)) : ((iTemp28) ? 2e+02f * fTemp31 + 2.7e+03f : 2.9e+03f)) : ((iTemp26) ? 2.9e+03f - 2e+02f * fTemp29 : 2.7e+03f)) : ((iTemp24) ? 5e+01f * fTemp27 + 2.7e+03f : 2.75e+03f)) : ((iTemp23) ? 1.5e+02f * fTemp25 + 2.75e+03f : 2.9e+03f)) : ((iTemp22) ? 2.9e+03f - 1e+02f * fTemp56 : 2.8e+03f)) : ((iTemp21) ? 1.5e+02f * fTemp54 + 2.8e+03f : 2.95e+03f)) : ((iTemp20) ? 2.95e+03f - 1.2e+02f * fTemp96 : 2.83e+03f)) : ((iTemp18) ? 2.83e+03f - 1.3e+02f * fTemp53 : 2.7e+03f)) : ((iTemp16) ? 2.7e+03f - fTemp107 : 2.65e+03f)) : ((iTemp14) ? 2.65e+03f - 5e+01f * fTemp17 : 2.6e+03f)) : ((iTemp12) ? 2e+02f * fTemp15 + 2.6e+03f : 2.8e+03f)) : ((iTemp9) ? 2.8e+03f - 2e+02f * fTemp13 : 2.6e+03f)) : ((iTemp10) ? fTemp101 + 2.6e+03f : 2.7e+03f));
+			float fTemp128 = ((iTemp9) ? ((iTemp12) ? ((iTemp14) ? ((iTemp16) ? ((iTemp18) ? ((iTemp20) ? ((iTemp21) ? ((iTemp22) ? ((iTemp23) ? ((iTemp24) ? ((iTemp26) ? ((iTemp28) ? ((iTemp30) ? ((iTemp32) ? ((iTemp35) ? ((iTemp37) ? ((iTemp40) ? ((iTemp42) ? ((iTemp44) ? ((iTemp47) ? ((iTemp62) ? ((iTemp64) ? 1.2e+02f : ((iTemp62) ? 1.2e+02f - fTemp112 : 1e+02f)) : ((iTemp47) ? 7e+01f * fTemp63 + 1e+02f : 1.7e+02f)) : ((iTemp44) ? 1.7e+02f - fTemp111 : 1.1e+02f)) : ((iTemp42) ? fTemp61 + 1.1e+02f : 1e+02f)) : 1e+02f) : 1e+02f) : 1e+02f) : ((iTemp32) ? fTemp59 + 1e+02f : 1.2e+02f)) : ((iTemp30) ? 1.2e+02f - fTemp58 : 1e+02f)) : 1e+02f) : 1e+02f) : 1e+02f) : ((iTemp23) ? fTemp57 + 1e+02f : 1.2e+02f)) : 1.2e+02f) : ((iTemp21) ? 1.2e+02f - 2e+01f * fTemp54 : 1e+02f)) : 1e+02f) : ((iTemp18) ? 7e+01f * fTemp53 + 1e+02f : 1.7e+02f)) : ((iTemp16) ? 1.7e+02f - fTemp107 : 1.2e+02f)) : ((iTemp14) ? 1.2e+02f - fTemp52 : 1e+02f)) : 1e+02f) : 1e+02f) : 1e+02f);
+			float fTemp138 = ((iTemp9) ? ((iTemp12) ? ((iTemp14) ? ((iTemp16) ? ((iTemp18) ? ((iTemp20) ? ((iTemp21) ? ((iTemp22) ? ((iTemp23) ? ((iTemp24) ? ((iTemp26) ? ((iTemp28) ? ((iTemp30) ? ((iTemp32) ? ((iTemp35) ? ((iTemp37) ? ((iTemp40) ? ((iTemp42) ? ((iTemp44) ? ((iTemp47) ? ((iTemp62) ? ((iTemp64) ? ((iTemp66) ? ((iTemp67) ? 0.1f : ((iTemp66) ? 0.1f - 0.068377f * fTemp8 : 0.031623f)) : 0.031623f) : ((iTemp62) ? 0.126866f * fTemp65 + 0.031623f : 0.158489f)) : ((iTemp47) ? 0.158489f - 0.126866f * fTemp63 : 0.031623f)) : ((iTemp44) ? 0.32319f * fTemp48 + 0.031623f : 0.354813f)) : 0.354813f) : ((iTemp40) ? 0.354813f - 0.196324f * fTemp43 : 0.158489f)) : ((iTemp37) ? 0.158489f - 0.069364f * fTemp41 : 0.089125f)) : ((iTemp35) ? 0.089125f - 0.064006f * fTemp38 : 0.025119f)) : ((iTemp32) ? 0.045676f * fTemp36 + 0.025119f : 0.070795f)) : ((iTemp30) ? 0.055098f * fTemp33 + 0.070795f : 0.125893f)) : ((iTemp28) ? 0.125893f - 0.062797f * fTemp31 : 0.063096f)) : ((iTemp26) ? 0.063096f - 0.012977f * fTemp29 : 0.050119f)) : ((iTemp24) ? 0.020676f * fTemp27 + 0.050119f : 0.070795f)) : ((iTemp23) ? 0.070795f - 0.045676f * fTemp25 : 0.025119f)) : ((iTemp22) ? 0.152709f * fTemp56 + 0.025119f : 0.177828f)) : ((iTemp21) ? 0.177828f - 0.127709f * fTemp54 : 0.050119f)) : fTemp124) : ((iTemp18) ? 0.079433f - 0.06165f * fTemp53 : 0.017783f)) : ((iTemp16) ? 0.428901f * fTemp19 + 0.017783f : 0.446684f)) : ((iTemp14) ? 0.446684f - 0.195495f * fTemp17 : 0.251189f)) : ((iTemp12) ? 0.251189f - 0.125296f * fTemp15 : 0.125893f)) : ((iTemp9) ? 0.125296f * fTemp13 + 0.125893f : 0.251189f)) : ((iTemp10) ? 0.251189f - 0.109935f * fTemp11 : 0.141254f));
+			float fTemp139 = ((iTemp9) ? ((iTemp12) ? ((iTemp14) ? ((iTemp16) ? ((iTemp18) ? ((iTemp20) ? ((iTemp21) ? ((iTemp22) ? ((iTemp23) ? ((iTemp24) ? ((iTemp26) ? ((iTemp28) ? ((iTemp30) ? ((iTemp32) ? ((iTemp35) ? ((iTemp37) ? ((iTemp40) ? ((iTemp42) ? ((iTemp44) ? ((iTemp47) ? ((iTemp62) ? ((iTemp64) ? ((iTemp66) ? ((iTemp67) ? 1.15e+03f : ((iTemp66) ? 4.5e+02f * fTemp8 + 1.15e+03f : 1.6e+03f)) : ((iTemp64) ? 1e+02f * fTemp102 + 1.6e+03f : 1.7e+03f)) : ((iTemp62) ? 1.7e+03f - 9e+02f * fTemp65 : 8e+02f)) : ((iTemp47) ? 8e+02f - 1e+02f * fTemp63 : 7e+02f)) : ((iTemp44) ? 3.4e+02f * fTemp48 + 7e+02f : 1.04e+03f)) : ((iTemp42) ? 5.8e+02f * fTemp45 + 1.04e+03f : 1.62e+03f)) : ((iTemp40) ? 1.3e+02f * fTemp43 + 1.62e+03f : 1.75e+03f)) : ((iTemp37) ? 1.75e+03f - 1e+03f * fTemp41 : 7.5e+02f)) : ((iTemp35) ? 7.5e+02f - 1.5e+02f * fTemp38 : 6e+02f)) : ((iTemp32) ? 5.2e+02f * fTemp36 + 6e+02f : 1.12e+03f)) : ((iTemp30) ? 6.8e+02f * fTemp33 + 1.12e+03f : 1.8e+03f)) : ((iTemp28) ? 5e+01f * fTemp31 + 1.8e+03f : 1.85e+03f)) : ((iTemp26) ? 1.85e+03f - 1.03e+03f * fTemp29 : 8.2e+02f)) : ((iTemp24) ? 8.2e+02f - 1.9e+02f * fTemp27 : 6.3e+02f)) : ((iTemp23) ? 5.2e+02f * fTemp25 + 6.3e+02f : 1.15e+03f)) : ((iTemp22) ? 8.5e+02f * fTemp56 + 1.15e+03f : 2e+03f)) : ((iTemp21) ? 1.4e+02f * fTemp54 + 2e+03f : 2.14e+03f)) : ((iTemp20) ? 2.14e+03f - 1.34e+03f * fTemp96 : 8e+02f)) : ((iTemp18) ? 8e+02f - 1e+02f * fTemp53 : 7e+02f)) : ((iTemp16) ? 3.8e+02f * fTemp19 + 7e+02f : 1.08e+03f)) : ((iTemp14) ? 6.2e+02f * fTemp17 + 1.08e+03f : 1.7e+03f)) : ((iTemp12) ? 1.7e+02f * fTemp15 + 1.7e+03f : 1.87e+03f)) : ((iTemp9) ? 1.87e+03f - 1.07e+03f * fTemp13 : 8e+02f)) : ((iTemp10) ? 8e+02f - 2e+02f * fTemp11 : 6e+02f));
+			float fTemp143 = 1e+01f * fTemp48;
+			float fTemp144 = 2e+01f * fTemp63;
+			float fTemp145 = ((iTemp9) ? ((iTemp12) ? ((iTemp14) ? ((iTemp16) ? ((iTemp18) ? ((iTemp20) ? ((iTemp21) ? ((iTemp22) ? ((iTemp23) ? ((iTemp24) ? ((iTemp26) ? ((iTemp28) ? ((iTemp30) ? ((iTemp32) ? ((iTemp35) ? ((iTemp37) ? ((iTemp40) ? ((iTemp42) ? ((iTemp44) ? ((iTemp47) ? ((iTemp62) ? ((iTemp64) ? ((iTemp66) ? ((iTemp67) ? 9e+01f : ((iTemp66) ? 9e+01f - 1e+01f * fTemp8 : 8e+01f)) : ((iTemp64) ? 2e+01f * fTemp102 + 8e+01f : 1e+02f)) : ((iTemp62) ? 1e+02f - fTemp112 : 8e+01f)) : ((iTemp47) ? 8e+01f - fTemp144 : 6e+01f)) : ((iTemp44) ? fTemp143 + 6e+01f : 7e+01f)) : ((iTemp42) ? 1e+01f * fTemp45 + 7e+01f : 8e+01f)) : ((iTemp40) ? 1e+01f * fTemp43 + 8e+01f : 9e+01f)) : ((iTemp37) ? 9e+01f - 1e+01f * fTemp41 : 8e+01f)) : 8e+01f) : ((iTemp32) ? fTemp110 + 8e+01f : 9e+01f)) : ((iTemp30) ? 9e+01f - fTemp109 : 8e+01f)) : ((iTemp28) ? 1e+01f * fTemp31 + 8e+01f : 9e+01f)) : ((iTemp26) ? 9e+01f - 1e+01f * fTemp29 : 8e+01f)) : ((iTemp24) ? 8e+01f - 2e+01f * fTemp27 : 6e+01f)) : ((iTemp23) ? 3e+01f * fTemp25 + 6e+01f : 9e+01f)) : ((iTemp22) ? 1e+01f * fTemp56 + 9e+01f : 1e+02f)) : ((iTemp21) ? 1e+02f - 1e+01f * fTemp54 : 9e+01f)) : ((iTemp20) ? 9e+01f - 1e+01f * fTemp96 : 8e+01f)) : ((iTemp18) ? 8e+01f - 2e+01f * fTemp53 : 6e+01f)) : ((iTemp16) ? 3e+01f * fTemp19 + 6e+01f : 9e+01f)) : ((iTemp14) ? 9e+01f - fTemp106 : 8e+01f)) : ((iTemp12) ? 1e+01f * fTemp15 + 8e+01f : 9e+01f)) : ((iTemp9) ? 9e+01f - fTemp105 : 8e+01f)) : ((iTemp10) ? 8e+01f - 2e+01f * fTemp11 : 6e+01f));
+			float fTemp155 = ((iTemp9) ? ((iTemp12) ? ((iTemp14) ? ((iTemp16) ? ((iTemp18) ? ((iTemp20) ? ((iTemp21) ? ((iTemp22) ? ((iTemp23) ? ((iTemp24) ? ((iTemp26) ? ((iTemp28) ? ((iTemp30) ? ((iTemp32) ? ((iTemp35) ? ((iTemp37) ? ((iTemp40) ? ((iTemp42) ? ((iTemp44) ? ((iTemp47) ? ((iTemp62) ? ((iTemp64) ? ((iTemp66) ? ((iTemp67) ? 0.630957f : ((iTemp66) ? 0.630957f - 0.567861f * fTemp8 : 0.063096f)) : ((iTemp64) ? 0.036904f * fTemp102 + 0.063096f : 0.1f)) : ((iTemp62) ? 0.254813f * fTemp65 + 0.1f : 0.354813f)) : ((iTemp47) ? 0.354813f - 0.103624f * fTemp63 : 0.251189f)) : ((iTemp44) ? 0.195495f * fTemp48 + 0.251189f : 0.446684f)) : ((iTemp42) ? 0.195495f * fTemp60 + 0.446684f : 0.251189f)) : ((iTemp40) ? 0.251189f - 0.219566f * fTemp43 : 0.031623f)) : ((iTemp37) ? 0.250215f * fTemp41 + 0.031623f : 0.281838f)) : ((iTemp35) ? 0.281838f - 0.181838f * fTemp38 : 0.1f)) : ((iTemp32) ? 0.401187f * fTemp36 + 0.1f : 0.501187f)) : ((iTemp30) ? 0.501187f - 0.301661f * fTemp33 : 0.199526f)) : ((iTemp28) ? 0.199526f - 0.13643f * fTemp31 : 0.063096f)) : ((iTemp26) ? 0.253132f * fTemp29 + 0.063096f : 0.316228f)) : ((iTemp24) ? 0.316228f - 0.216228f * fTemp27 : 0.1f)) : ((iTemp23) ? 0.401187f * fTemp25 + 0.1f : 0.501187f)) : ((iTemp22) ? 0.501187f - 0.401187f * fTemp56 : 0.1f)) : ((iTemp21) ? 0.151189f * fTemp54 + 0.1f : 0.251189f)) : ((iTemp20) ? 0.030649f * fTemp96 + 0.251189f : 0.281838f)) : ((iTemp18) ? 0.281838f - 0.123349f * fTemp53 : 0.158489f)) : ((iTemp16) ? 0.342698f * fTemp19 + 0.158489f : 0.501187f)) : ((iTemp14) ? 0.501187f - 0.301661f * fTemp17 : 0.199526f)) : ((iTemp12) ? 0.199526f - 0.021698f * fTemp15 : 0.177828f)) : ((iTemp9) ? 0.1384f * fTemp13 + 0.177828f : 0.316228f)) : ((iTemp10) ? 0.316228f - 0.216228f * fTemp11 : 0.1f));
+			float fTemp156 = ((iTemp9) ? ((iTemp12) ? ((iTemp14) ? ((iTemp16) ? ((iTemp18) ? ((iTemp20) ? ((iTemp21) ? ((iTemp22) ? ((iTemp23) ? ((iTemp24) ? ((iTemp26) ? ((iTemp28) ? ((iTemp30) ? ((iTemp32) ? ((iTemp35) ? ((iTemp37) ? ((iTemp40) ? ((iTemp42) ? ((iTemp44) ? ((iTemp47) ? ((iTemp62) ? ((iTemp64) ? ((iTemp66) ? ((iTemp67) ? 8e+02f : ((iTemp66) ? 8e+02f - 4e+02f * fTemp8 : 4e+02f)) : ((iTemp64) ? 4e+02f - 5e+01f * fTemp102 : 3.5e+02f)) : ((iTemp62) ? 1e+02f * fTemp65 + 3.5e+02f : 4.5e+02f)) : ((iTemp47) ? 4.5e+02f - 125.0f * fTemp63 : 325.0f)) : ((iTemp44) ? 275.0f * fTemp48 + 325.0f : 6e+02f)) : ((iTemp42) ? 2e+02f * fTemp60 + 6e+02f : 4e+02f)) : ((iTemp40) ? 4e+02f - 1.5e+02f * fTemp43 : 2.5e+02f)) : ((iTemp37) ? 1.5e+02f * fTemp41 + 2.5e+02f : 4e+02f)) : ((iTemp35) ? 4e+02f - fTemp39 : 3.5e+02f)) : ((iTemp32) ? 3.1e+02f * fTemp36 + 3.5e+02f : 6.6e+02f)) : ((iTemp30) ? 6.6e+02f - 2.2e+02f * fTemp33 : 4.4e+02f)) : ((iTemp28) ? 4.4e+02f - 1.7e+02f * fTemp31 : 2.7e+02f)) : ((iTemp26) ? 1.6e+02f * fTemp29 + 2.7e+02f : 4.3e+02f)) : ((iTemp24) ? 4.3e+02f - 6e+01f * fTemp27 : 3.7e+02f)) : ((iTemp23) ? 4.3e+02f * fTemp25 + 3.7e+02f : 8e+02f)) : ((iTemp22) ? 8e+02f - 4.5e+02f * fTemp56 : 3.5e+02f)) : ((iTemp21) ? 3.5e+02f - fTemp55 : 2.7e+02f)) : ((iTemp20) ? 1.8e+02f * fTemp96 + 2.7e+02f : 4.5e+02f)) : ((iTemp18) ? 4.5e+02f - 125.0f * fTemp53 : 325.0f)) : ((iTemp16) ? 325.0f * (fTemp19 + 1.0f) : 6.5e+02f)) : ((iTemp14) ? 6.5e+02f - 2.5e+02f * fTemp17 : 4e+02f)) : ((iTemp12) ? 4e+02f - 1.1e+02f * fTemp15 : 2.9e+02f)) : ((iTemp9) ? 1.1e+02f * fTemp13 + 2.9e+02f : 4e+02f)) : ((iTemp10) ? 4e+02f - 5e+01f * fTemp11 : 3.5e+02f));
+			float fTemp159 = ((iTemp9) ? ((iTemp12) ? ((iTemp14) ? ((iTemp16) ? ((iTemp18) ? ((iTemp20) ? ((iTemp21) ? ((iTemp22) ? ((iTemp23) ? ((iTemp24) ? ((iTemp26) ? ((iTemp28) ? ((iTemp30) ? ((iTemp32) ? ((iTemp35) ? ((iTemp37) ? ((iTemp40) ? ((iTemp42) ? ((iTemp44) ? ((iTemp47) ? ((iTemp62) ? ((iTemp64) ? ((iTemp66) ? ((iTemp67) ? 8e+01f : ((iTemp66) ? 8e+01f - fTemp113 : 6e+01f)) : ((iTemp64) ? 6e+01f - 1e+01f * fTemp102 : 5e+01f)) : ((iTemp62) ? fTemp112 + 5e+01f : 7e+01f)) : ((iTemp47) ? 7e+01f - fTemp144 : 5e+01f)) : ((iTemp44) ? fTemp143 + 5e+01f : 6e+01f)) : ((iTemp42) ? 2e+01f * fTemp60 + 6e+01f : 4e+01f)) : ((iTemp40) ? 2e+01f * fTemp43 + 4e+01f : 6e+01f)) : ((iTemp37) ? 6e+01f - 2e+01f * fTemp41 : 4e+01f)) : 4e+01f) : ((iTemp32) ? 4e+01f * (fTemp36 + 1.0f) : 8e+01f)) : ((iTemp30) ? 8e+01f - fTemp109 : 7e+01f)) : ((iTemp28) ? 7e+01f - 3e+01f * fTemp31 : 4e+01f)) : 4e+01f) : 4e+01f) : ((iTemp23) ? 4e+01f * (fTemp25 + 1.0f) : 8e+01f)) : ((iTemp22) ? 8e+01f - fTemp108 : 6e+01f)) : 6e+01f) : ((iTemp20) ? 6e+01f - 2e+01f * fTemp96 : 4e+01f)) : ((iTemp18) ? 1e+01f * fTemp53 + 4e+01f : 5e+01f)) : 5e+01f) : ((iTemp14) ? fTemp52 + 5e+01f : 7e+01f)) : ((iTemp12) ? 7e+01f - 3e+01f * fTemp15 : 4e+01f)) : ((iTemp9) ? 3e+01f * fTemp13 + 4e+01f : 7e+01f)) : ((iTemp10) ? 7e+01f - 3e+01f * fTemp11 : 4e+01f));
+			fFormantFreq[0][i0] = fTemp49;
+			fFormantFreq[1][i0] = fTemp103;
+			fFormantFreq[2][i0] = fTemp126;
+			fFormantFreq[3][i0] = fTemp139;
+			fFormantFreq[4][i0] = fTemp156;
+			fFormantBw[0][i0] = fTemp68;
+			fFormantBw[1][i0] = fTemp114;
+			fFormantBw[2][i0] = fTemp128;
+			fFormantBw[3][i0] = fTemp145;
+			fFormantBw[4][i0] = fTemp159;
+			fFormantGain[0][i0] = fTemp98;
+			fFormantGain[1][i0] = fTemp125;
+			fFormantGain[2][i0] = fTemp138;
+			fFormantGain[3][i0] = fTemp155;
+			fBwScale[i0] = fTemp80;
+			fBwScaleRange[i0] = ((iTemp72) ? ((iTemp77) ? 12.0f : ((iTemp78) ? 12.0f : ((iTemp79) ? 12.0f : 15.0f))) : ((iTemp73) ? ((iTemp76) ? 4.0f : 1e+01f) : ((iTemp74) ? 2.5f : ((iTemp75) ? 2.5f : 1e+01f)))) - fTemp80;
+			fRec6[1] = fRec6[0];
+		}
+	}
+
+	POODLE_MULTIVERSION
+	void computeChunk(int count, FAUSTFLOAT* RESTRICT output0) {
+		const int nv = iStride;
+		float fSlow0 = fConst1 * float(params[FOFCYCLE_VIBFREQ]);
+		float fSlow1 = 0.1f * float(params[FOFCYCLE_VIBGAIN]);
+		float fSlow4 = fSlowBend;
+		float fSlow8 = float(params[FOFCYCLE_VOICETYPE]);
+		int iSlow11 = ((fSlow8 == 0.0f) ? 1 : ((fSlow8 == 3.0f) ? 1 : 0));
+		int iSlow12 = iSlow11 >= 1;
+		float fSlow13 = ((iSlow12) ? 174.61f : 82.41f);
+		float fSlow14 = ((iSlow12) ? 1046.5f : 523.25f);
+		float fSlow15 = fSlow14 - fSlow13;
+		int iSlow17 = iSlow11 == 0;
+		int iSlow18 = fSlow8 != 2.0f;
+		float fSlow22 = fSlowAttack;
+		float fSlow24 = float(params[FOFCYCLE_OUTGAIN]);
+		float* RESTRICT vibphase = field(FOFBANK_VIBPHASE);
+		float* RESTRICT lastgate = field(FOFBANK_LASTGATE);
+		float* RESTRICT bend = field(FOFBANK_BEND);
+		float* RESTRICT phase = field(FOFBANK_PHASE);
+		float* RESTRICT counter = field(FOFBANK_COUNT);
+		float* RESTRICT env = field(FOFBANK_ENV);
+		float* RESTRICT gate = field(FOFBANK_GATE);
+		float* RESTRICT freq = field(FOFBANK_FREQ);
+		float* RESTRICT envtarget = field(FOFBANK_ENVTARGET);
+		float* RESTRICT bwscale = field(FOFBANK_BWSCALE);
+		float* RESTRICT gain = field(FOFBANK_GAIN);
+		float* RESTRICT freq4 = field(FOFBANK_FREQ4);
+		float* RESTRICT freq5 = field(FOFBANK_FREQ5);
+		float* RESTRICT out = field(FOFBANK_OUT);
+		float* RESTRICT start[FOFCYCLE_BANK_FOFS];
+		float* RESTRICT start1[FOFCYCLE_BANK_FOFS];
+		float* RESTRICT start2[FOFCYCLE_BANK_FOFS];
+		for (int f = 0; f < FOFCYCLE_BANK_FOFS; f++) {
+			start[f] = field(FOFBANK_START + f);
+			start1[f] = field(FOFBANK_START1 + f);
+			start2[f] = field(FOFBANK_START2 + f);
+		}
+		const float *sine = fofcycle_ftbl0dspSIG0;
+		for (int i0 = 0; i0 < count; i0 = i0 + 1) {
+			iVec1[0] = 1;
+			int iTemp0 = 1 - iVec1[1];
+			float fBwScale0 = fBwScale[i0];
+			float fBwScaleRange0 = fBwScaleRange[i0];
+			float fTemp139 = fFormantFreq[3][i0];
+			float fTemp156 = fFormantFreq[4][i0];
+			// The fundamental and the fofs it starts
+			IVDEP
+			for (int v = 0; v < nv; v++) {
+				float fTemp1 = ((iTemp0) ? 0.0f : fSlow0 + vibphase[v]);
+				vibphase[v] = fTemp1 - std::floor(fTemp1);
+				float fSlow2 = gate[v];
+				float fTemp2 = float((fSlow2 == lastgate[v]) | (fSlow2 == 0.0f));
+				lastgate[v] = fSlow2;
+				bend[v] = fSlow4 * (1.0f - 0.999f * fTemp2) + 0.999f * fTemp2 * bend[v];
+				float fTemp3 = bend[v] * (fSlow1 * sine[std::max<int>(0, std::min<int>(int(65536.0f * vibphase[v]), 65535))] + 1.0f);
+				float fTemp4 = ((iTemp0) ? 0.0f : phase[v] + (fConst1 * freq[v]) * fTemp3);
+				float fRec2 = fTemp4 - std::floor(fTemp4);
+				float fTemp5 = float((fRec2 - phase[v]) < 0.0f);
+				phase[v] = fRec2;
+				float fRec5 = fTemp5 + counter[v] * float(counter[v] <= 2.0f);
+				counter[v] = fRec5;
+				start[0][v] = float(fRec5 == 3.0f) * fTemp5;
+				start[1][v] = float(fRec5 == 2.0f) * fTemp5;
+				start[2][v] = float(fRec5 == 1.0f) * fTemp5;
+				float fTemp70 = freq[v] * fTemp3;
+				bwscale[v] = fBwScale0 + fBwScaleRange0 * ((fTemp70 <= fSlow13) ? 0.0f : ((fTemp70 >= fSlow14) ? 1.0f : (fTemp70 - fSlow13) / fSlow15));
+				gain[v] = ((iSlow17) ? 0.0036666666f * (4e+02f - fTemp70) + 3.0f : 0.00084f * (1e+03f - fTemp70) + 0.8f);
+				float fTemp140 = (2.0f * freq[v]) * fTemp3 + 3e+01f;
+				freq4[v] = fConst1 * ((iSlow18) ? (((fTemp139 >= 1.3e+03f) & (fTemp70 >= 2e+02f)) ? fTemp139 - 0.00095238094f * (fTemp70 + -2e+02f) * (fTemp139 + -1.3e+03f) : ((fTemp139 <= fTemp140) ? fTemp140 : fTemp139)) : fTemp139);
+				freq5[v] = fConst1 * ((fTemp156 <= fTemp70) ? fTemp70 : fTemp156);
+			}
+			// A fof starting holds the bandwidths of this sample until it starts again
+			for (int v = 0; v < iVoices; v++) {
+				for (int f = 0; f < FOFCYCLE_BANK_FOFS; f++) {
+					if (start[f][v] == 0.0f)
+						continue;
+					for (int formant = 0; formant < FOFCYCLE_BANK_FORMANTS; formant++) {
+						float bw = fFormantBw[formant][i0];
+						float fTemp69 = expf(-(fConst4 * bw));
+						float fTemp83 = expf(-(fConst4 * (bwscale[v] * bw)));
+						float *s = fof(formant, f);
+						s[FOF_A1 * nv + v] = fTemp83 + fTemp69;
+						s[FOF_A2 * nv + v] = fTemp83 * fTemp69;
+						s[FOF_AMP * nv + v] = 1.0f - (fTemp69 + fTemp83 * (1.0f - fTemp69));
+					}
+				}
+			}
+			// The formants, summed from the last one as in fofcycle_dsp
+			computeFormant<true, true>(4, i0, iTemp0, freq5);
+			computeFormant<true, false>(3, i0, iTemp0, freq4);
+			computeFormant<false, false>(2, i0, iTemp0, NULL);
+			computeFormant<false, false>(1, i0, iTemp0, NULL);
+			computeFormant<false, false>(0, i0, iTemp0, NULL);
+			FAUSTFLOAT sum = 0;
+			for (int v = 0; v < iVoices; v++) {
+				env[v] = envtarget[v] + fSlow22 * env[v];
+				sum += FAUSTFLOAT(fSlow24 * env[v] * out[v]);
+			}
+			output0[i0] = sum;
+			for (int f = 0; f < FOFCYCLE_BANK_FOFS; f++) {
+				IVDEP
+				for (int v = 0; v < nv; v++) {
+					start2[f][v] = start1[f][v];
+					start1[f][v] = start[f][v];
+				}
+			}
+			iVec1[1] = iVec1[0];
+		}
+	}
+
+ private:
+	// Advances one fof of voice v by one sample and returns its output.
+	// s: the fields of the fof, stride: their size. reset: the fof started
+	// in the previous sample. in: the input of its filter
+	static inline float fofStep(float* RESTRICT s, int stride, int v, int reset,
+								float freq, float in, const float *sine) {
+		float fTemp50 = ((reset) ? 0.0f : freq + s[FOF_PHASE * stride + v]);
+		float ph = fTemp50 - std::floor(fTemp50);
+		s[FOF_PHASE * stride + v] = ph;
+		float y1 = s[FOF_Y1 * stride + v];
+		float y = in + y1 * s[FOF_A1 * stride + v] - s[FOF_A2 * stride + v] * s[FOF_Y2 * stride + v];
+		s[FOF_Y2 * stride + v] = y1;
+		s[FOF_Y1 * stride + v] = y;
+		return y * s[FOF_AMP * stride + v] * sine[std::max<int>(0, std::min<int>(int(65536.0f * ph), 65535))];
+	}
+
+	// Adds the output of a formant (its 3 fofs) at sample i0 to FOFBANK_OUT, or
+	// sets it if FIRST. PERVOICE: the frequency of the formant is given per voice
+	// (freqs) instead of by fFormantFreq
+	template <bool PERVOICE, bool FIRST>
+	inline void computeFormant(int formant, int i0, int iTemp0, const float* RESTRICT freqs) {
+		const int nv = iStride;
+		const float *sine = fofcycle_ftbl0dspSIG0;
+		float fFreq = fFormantFreq[formant][i0];
+		float fGain = FIRST ? 1.0f : fFormantGain[formant][i0];
+		const float* RESTRICT gain = field(FOFBANK_GAIN);
+		float* RESTRICT out = field(FOFBANK_OUT);
+		const float* RESTRICT start1_0 = field(FOFBANK_START1);
+		const float* RESTRICT start1_1 = field(FOFBANK_START1 + 1);
+		const float* RESTRICT start1_2 = field(FOFBANK_START1 + 2);
+		const float* RESTRICT start2_0 = field(FOFBANK_START2);
+		const float* RESTRICT start2_1 = field(FOFBANK_START2 + 1);
+		const float* RESTRICT start2_2 = field(FOFBANK_START2 + 2);
+		float* RESTRICT s0 = fof(formant, 0);
+		float* RESTRICT s1 = fof(formant, 1);
+		float* RESTRICT s2 = fof(formant, 2);
+		IVDEP
+		for (int v = 0; v < nv; v++) {
+			float freq = PERVOICE ? freqs[v] : fFreq;
+			float y0 = fofStep(s0, nv, v, iTemp0 | int(start1_0[v]), freq, start2_0[v], sine);
+			float y1 = fofStep(s1, nv, v, iTemp0 | int(start1_1[v]), freq, start2_1[v], sine);
+			float y2 = fofStep(s2, nv, v, iTemp0 | int(start1_2[v]), freq, start2_2[v], sine);
+			float y = (FIRST ? gain[v] : gain[v] * fGain) * (y2 + y1 + y0);
+			out[v] = FIRST ? y : out[v] + y;
+		}
+	}
+};
+
+
 // aout fofcycle kgate, kfreq, kgain [, Sparam_n, kvalue_n, ...]
 
 struct FOFCYCLE {
@@ -2168,61 +3457,73 @@ struct FOFCYCLE {
  */
 
 
-static int32_t fofcycle_init(CSOUND *csound, FOFCYCLE *p) {
-    if(p->dspmem.auxp == NULL)
-        csound->AuxAlloc(csound, sizeof(fofcycle_dsp), &p->dspmem);
-    p->DSP = new (p->dspmem.auxp) fofcycle_dsp;
-    if(p->DSP == 0) {
-        INITERR("Memory allocation error");
-        return NOTOK;
-    }
-    p->DSP->init((int)_GetLocalSr(csound, &(p->h)));
-    int numargs = _GetInputArgCnt(csound, p) - 3;
+// Checks the key/value pairs of fofcyclevoc / fofcyclebank (ctrls) and puts the
+// index of the parameter set by each pair in ctrlindexes
+static int fofcycle_parse_args(CSOUND *csound, void **ctrls, int numargs, int *ctrlindexes) {
     if(numargs % 2) {
         INITERRF("Expected even number of arguments, got %d\n", numargs);
         return NOTOK;
     }
-    p->numargs = numargs;
     STRINGDAT *key;
     CS_TYPE *cstype;
     if(numargs > 0) {
         for(int i=0; i < numargs / 2; i++) {
-            cstype = _GetTypeForArg(csound, p->ctrls[i*2]);
+            cstype = _GetTypeForArg(csound, ctrls[i*2]);
             if(cstype->varTypeName[0] != 'S') {
                 INITERRF("Expected a string for arg %d, got %s\n", i + 2, cstype->varTypeName);
                 return NOTOK;
             }
-            key = (STRINGDAT*)(p->ctrls[i*2]);
+            key = (STRINGDAT*)(ctrls[i*2]);
             int paramindex = _key_to_index(key->data, fofcycle_params);
             if(paramindex < 0) {
 
                 INITERRF("Unknown parmeter %s. Possible parameters: %s", key->data, _params_list(fofcycle_params, &_fofcycle_params_list));
                 return NOTOK;
             }
-            cstype = _GetTypeForArg(csound, p->ctrls[i*2+1]);
+            cstype = _GetTypeForArg(csound, ctrls[i*2+1]);
             char typechar = cstype->varTypeName[0];
             if(typechar != 'c' && typechar != 'k' && typechar != 'i') {
                 INITERRF("Value for key '%s' must be a scalar (a constant or an i- or k- var)"
                          ", got '%s'", key->data, cstype->varTypeName);
                 return NOTOK;
             }
-            p->ctrlindexes[i] = paramindex;
+            ctrlindexes[i] = paramindex;
         }
     }
     return OK;
+}
+
+
+static inline void fofcycle_set_params(FAUSTFLOAT *slots, void **ctrls, int *ctrlindexes, int numpairs) {
+    for(int i = 0; i < numpairs; i++) {
+        MYFLT value = *(MYFLT *)(ctrls[i * 2 + 1]);
+        int index = ctrlindexes[i];
+        slots[index] = value;
+    }
+}
+
+
+static int32_t fofcycle_init(CSOUND *csound, FOFCYCLE *p) {
+    if(p->dspmem.auxp == NULL)
+        csound->AuxAlloc(csound, sizeof(fofcycle_dsp), &p->dspmem);
+    p->DSP = new (p->dspmem.auxp) fofcycle_dsp;
+    if(p->DSP == 0) {
+        INITERR("Memory allocation error");
+        return NOTOK;
+    }
+    p->DSP->init((int)_GetLocalSr(csound, &(p->h)));
+    int numargs = _GetInputArgCnt(csound, p) - 3;
+    if(fofcycle_parse_args(csound, p->ctrls, numargs, p->ctrlindexes) == NOTOK)
+        return NOTOK;
+    p->numargs = numargs;
+    return OK;
 
 }
 
 static int32_t fofcycle_perf(CSOUND *csound, FOFCYCLE *p) {
     IGN(csound);
-    int numpairs = p->numargs / 2;
     fofcycle_dsp *dsp = p->DSP;
-    FAUSTFLOAT *slots = &(dsp->params[0]);
-    for(int i = 0; i < numpairs; i++) {
-        MYFLT value = *(MYFLT *)(p->ctrls[i * 2 + 1]);
-        int index = p->ctrlindexes[i];
-        slots[index] = value;
-    }
+    fofcycle_set_params(&(dsp->params[0]), p->ctrls, p->ctrlindexes, p->numargs / 2);
     dsp->param_freq = *p->freq;
     dsp->param_gain = *p->gain;
     dsp->param_gate = *p->gate;
@@ -2232,6 +3533,67 @@ static int32_t fofcycle_perf(CSOUND *csound, FOFCYCLE *p) {
 }
 
 
+/*
+ * aout fofcyclebank kFreqs[], kGains[], kGates[] [, Sparam_n, kvalue_n, ...]
+ *
+ * One fofcycle voice per element of kFreqs, all with the same settings, summed.
+ * The number of voices is the size of kFreqs at init. See fofcycle_bank_dsp
+ */
+
+struct FOFCYCLEBANK {
+    OPDS h;
+    MYFLT *aout;
+    ARRAYDAT *freqs;
+    ARRAYDAT *gains;
+    ARRAYDAT *gates;
+    void *ctrls[20];
+    fofcycle_bank_dsp *DSP;
+    AUXCH dspmem;
+    int ctrlindexes[10];
+    int numargs;
+    int numvoices;
+};
+
+
+static int32_t fofcyclebank_init(CSOUND *csound, FOFCYCLEBANK *p) {
+    CHECKARR1D(p->freqs);
+    CHECKARR1D(p->gains);
+    CHECKARR1D(p->gates);
+    int numvoices = p->freqs->sizes[0];
+    if(numvoices < 1)
+        return INITERR("The array of frequencies is empty");
+    if(p->gains->sizes[0] < numvoices || p->gates->sizes[0] < numvoices)
+        return INITERRF("Expected %d gains and gates (one per frequency), got %d and %d",
+                        numvoices, p->gains->sizes[0], p->gates->sizes[0]);
+    int numargs = _GetInputArgCnt(csound, p) - 3;
+    if(fofcycle_parse_args(csound, p->ctrls, numargs, p->ctrlindexes) == NOTOK)
+        return NOTOK;
+    p->numargs = numargs;
+    p->numvoices = numvoices;
+
+    size_t size = fofcycle_bank_dsp::memorySize(numvoices);
+    if(p->dspmem.auxp == NULL || p->dspmem.size != size)
+        csound->AuxAlloc(csound, size, &p->dspmem);
+    p->DSP = new (p->dspmem.auxp) fofcycle_bank_dsp;
+    p->DSP->setVoices(p->dspmem.auxp, numvoices);
+    p->DSP->init((int)_GetLocalSr(csound, &(p->h)));
+    return OK;
+}
+
+
+static int32_t fofcyclebank_perf(CSOUND *csound, FOFCYCLEBANK *p) {
+    int numvoices = p->numvoices;
+    if(p->freqs->sizes[0] < numvoices || p->gains->sizes[0] < numvoices ||
+       p->gates->sizes[0] < numvoices)
+        return PERFERRF("The arrays should have at least %d elements (the number of voices)",
+                        numvoices);
+    fofcycle_bank_dsp *dsp = p->DSP;
+    fofcycle_set_params(&(dsp->params[0]), p->ctrls, p->ctrlindexes, p->numargs / 2);
+    dsp->compute(_GetLocalKsmps(csound, &(p->h)), p->gates->data, p->freqs->data,
+                 p->gains->data, p->aout);
+    return OK;
+}
+
 // -------------------------------------------------------------
 
 
@@ -2239,7 +3601,9 @@ static int32_t fofcycle_perf(CSOUND *csound, FOFCYCLE *p) {
 extern "C" {
     static OENTRY localops[] = {
         {(char*)"zitarev", sizeof(ZITAREV), 0, 3, (char*)"aa", (char*)"aa*", (SUBR)zitarev_init, (SUBR)zitarev_perf, NULL, NULL},
-        {(char*)"fofcyclevoc", sizeof(FOFCYCLE), 0, 3, (char*)"a", (char*)"kkk*", (SUBR)fofcycle_init, (SUBR)fofcycle_perf, NULL, NULL}
+        {(char*)"zitarev.arr", sizeof(ZITAREV_ARR), 0, 3, (char*)"a[]a[]", (char*)"a[]a[]*", (SUBR)zitarev_arr_init, (SUBR)zitarev_arr_perf, NULL, NULL},
+        {(char*)"fofcyclevoc", sizeof(FOFCYCLE), 0, 3, (char*)"a", (char*)"kkk*", (SUBR)fofcycle_init, (SUBR)fofcycle_perf, NULL, NULL},
+        {(char*)"fofcyclebank", sizeof(FOFCYCLEBANK), 0, 3, (char*)"a", (char*)"k[]k[]k[]*", (SUBR)fofcyclebank_init, (SUBR)fofcyclebank_perf, NULL, NULL}
 
     };
     LINKAGE
@@ -2249,7 +3613,9 @@ extern "C" {
 extern "C" {
     static OENTRY localops[] = {
         {(char*)"zitarev", sizeof(ZITAREV), 0, (char*)"aa", (char*)"aa*", (SUBR)zitarev_init, (SUBR)zitarev_perf, NULL, NULL },
-        {(char*)"fofcyclevoc", sizeof(FOFCYCLE), 0, (char*)"a", (char*)"kkk*", (SUBR)fofcycle_init, (SUBR)fofcycle_perf, NULL, NULL}
+        {(char*)"zitarev.arr", sizeof(ZITAREV_ARR), 0, (char*)"a[]a[]", (char*)"a[]a[]*", (SUBR)zitarev_arr_init, (SUBR)zitarev_arr_perf, NULL, NULL },
+        {(char*)"fofcyclevoc", sizeof(FOFCYCLE), 0, (char*)"a", (char*)"kkk*", (SUBR)fofcycle_init, (SUBR)fofcycle_perf, NULL, NULL},
+        {(char*)"fofcyclebank", sizeof(FOFCYCLEBANK), 0, (char*)"a", (char*)"k[]k[]k[]*", (SUBR)fofcyclebank_init, (SUBR)fofcyclebank_perf, NULL, NULL}
 
     };
     LINKAGE